@@ -0,0 +1,216 @@
+#!/usr/bin/env python3
+"""Store benchmark baselines and gate new runs against them.
+
+Usage:
+  compare.py save <modbuscpp_bench> <baseline.json> [options] [-- bench args]
+  compare.py compare <baseline.json> <contender.json> [options]
+  compare.py check <modbuscpp_bench> <baseline.json> [options] [-- bench args]
+
+`save` runs the benchmark binary with repetitions and stores its JSON output.
+`compare` matches benchmarks by name and runs a two-sided Mann-Whitney U test
+on the per-repetition times. A benchmark regresses when the test is
+significant and the median slowed down by more than the threshold. `check`
+runs the binary and compares the result with a stored baseline.
+
+Exit status is 1 when any benchmark regressed, so it can gate a release.
+
+Suites (select with --suite, default all):
+  codec       BM_request_*, BM_response_*, BM_error_*, BM_pack_bits*,
+              BM_unpack_bits*
+  data-table  BM_sequential_*, BM_table_*
+  loopback    BM_loopback*
+  allocations BM_handle_allocations*, BM_handle_concurrent*,
+              BM_server_allocations*
+
+Only the Python standard library is used.
+"""
+
+import argparse
+import json
+import math
+import os
+import subprocess
+import sys
+import tempfile
+
+SUITES = {
+    "codec": "^BM_((request|response|error)_|(pack|unpack)_bits)",
+    "data-table": "^BM_(sequential|table)_",
+    "loopback": "^BM_loopback",
+    "allocations": "^BM_(handle_(allocations|concurrent)|server_allocations)",
+}
+
+
+def suite_filter(suites):
+    if not suites or "all" in suites:
+        return ".*"
+
+    return "|".join(f"({SUITES[suite]})" for suite in suites)
+
+
+def run(binary, output, repetitions, suites, extra):
+    command = [
+        binary,
+        f"--benchmark_filter={suite_filter(suites)}",
+        f"--benchmark_repetitions={repetitions}",
+        "--benchmark_enable_random_interleaving=true",
+        "--benchmark_out_format=json",
+        f"--benchmark_out={output}",
+    ] + extra
+    print("running", " ".join(command), file=sys.stderr)
+    subprocess.run(command, check=True, stdout=sys.stderr)
+
+
+def load(path, metric):
+    """Return {benchmark name: [per-repetition time in ns]}."""
+    scale = {"ns": 1.0, "us": 1e3, "ms": 1e6, "s": 1e9}
+
+    with open(path) as file:
+        report = json.load(file)
+
+    samples = {}
+
+    for bench in report.get("benchmarks", []):
+        if bench.get("run_type", "iteration") != "iteration":
+            continue
+
+        if bench.get("error_occurred"):
+            continue
+
+        name = bench.get("run_name", bench["name"])
+        value = bench[metric] * scale[bench.get("time_unit", "ns")]
+        samples.setdefault(name, []).append(value)
+
+    return samples
+
+
+def median(values):
+    ordered = sorted(values)
+    middle = len(ordered) // 2
+
+    if len(ordered) % 2:
+        return ordered[middle]
+
+    return (ordered[middle - 1] + ordered[middle]) / 2
+
+
+def mann_whitney(lhs, rhs):
+    """Two-sided Mann-Whitney U test, normal approximation with tie and
+    continuity correction. Returns the p-value."""
+    n1, n2 = len(lhs), len(rhs)
+    pooled = sorted([(value, 0) for value in lhs] + [(value, 1) for value in rhs])
+    ranks = [0.0] * len(pooled)
+    ties = 0.0
+    idx = 0
+
+    while idx < len(pooled):
+        end = idx
+
+        while end + 1 < len(pooled) and pooled[end + 1][0] == pooled[idx][0]:
+            end += 1
+
+        rank = (idx + end) / 2 + 1
+
+        for pos in range(idx, end + 1):
+            ranks[pos] = rank
+
+        count = end - idx + 1
+        ties += count**3 - count
+        idx = end + 1
+
+    rank_sum = sum(rank for rank, (_, group) in zip(ranks, pooled) if group == 0)
+    u = rank_sum - n1 * (n1 + 1) / 2
+    n = n1 + n2
+    mean = n1 * n2 / 2
+    variance = n1 * n2 / 12 * ((n + 1) - ties / (n * (n - 1)))
+
+    if variance <= 0:
+        return 1.0
+
+    z = (abs(u - mean) - 0.5) / math.sqrt(variance)
+    return math.erfc(max(z, 0) / math.sqrt(2))
+
+
+def compare(baseline_path, contender_path, args):
+    baseline = load(baseline_path, args.metric)
+    contender = load(contender_path, args.metric)
+    regressions = []
+
+    print(f"{'benchmark':<72} {'baseline':>12} {'contender':>12} "
+          f"{'change':>8} {'p':>7}")
+
+    for name in sorted(set(baseline) & set(contender)):
+        old, new = baseline[name], contender[name]
+
+        if min(len(old), len(new)) < 5:
+            print(f"{name:<72} skipped, needs at least 5 repetitions")
+            continue
+
+        old_median, new_median = median(old), median(new)
+        change = (new_median - old_median) / old_median if old_median else 0
+        p = mann_whitney(old, new)
+        regressed = p < args.alpha and change > args.threshold
+        mark = "  REGRESSION" if regressed else ""
+
+        print(f"{name:<72} {old_median:>10.1f}ns {new_median:>10.1f}ns "
+              f"{change:>+7.1%} {p:>7.4f}{mark}")
+
+        if regressed:
+            regressions.append(name)
+
+    for name in sorted(set(baseline) - set(contender)):
+        print(f"{name:<72} missing from contender")
+
+    if regressions:
+        print(f"\n{len(regressions)} regression(s) beyond "
+              f"{args.threshold:.0%} at alpha {args.alpha}")
+        return 1
+
+    print("\nno regressions")
+    return 0
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("command", choices=["save", "compare", "check"])
+    parser.add_argument("first", help="benchmark binary or baseline JSON")
+    parser.add_argument("second", help="baseline or contender JSON")
+    parser.add_argument("--repetitions", type=int, default=10)
+    parser.add_argument("--suite", action="append",
+                        choices=["all"] + list(SUITES))
+    parser.add_argument("--metric", choices=["real_time", "cpu_time"],
+                        default="real_time")
+    parser.add_argument("--threshold", type=float, default=0.05,
+                        help="relative median slowdown to flag (default 0.05)")
+    parser.add_argument("--alpha", type=float, default=0.05,
+                        help="significance level (default 0.05)")
+    argv = sys.argv[1:]
+    extra = []
+
+    # everything after "--" goes to the benchmark binary
+    if "--" in argv:
+        extra = argv[argv.index("--") + 1:]
+        argv = argv[:argv.index("--")]
+
+    args = parser.parse_args(argv)
+
+    if args.command == "save":
+        run(args.first, args.second, args.repetitions, args.suite, extra)
+        return 0
+
+    if args.command == "compare":
+        return compare(args.first, args.second, args)
+
+    fd, contender = tempfile.mkstemp(suffix=".json")
+    os.close(fd)
+
+    try:
+        run(args.first, contender, args.repetitions, args.suite, extra)
+        return compare(args.second, contender, args)
+    finally:
+        os.remove(contender)
+
+
+if __name__ == "__main__":
+    sys.exit(main())
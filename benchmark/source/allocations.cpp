@@ -0,0 +1,259 @@
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <new>
+
+#include <boost/asio.hpp>
+
+#include <modbuscpp/modbus.hpp>
+
+// Heap allocations per request. Replaces the global allocation functions for
+// the benchmark binary; counting is off outside these benchmarks and costs a
+// relaxed load per allocation.
+//
+// BM_handle_allocations counts request_handler::handle on the calling thread
+// path, BM_server_allocations counts every thread during loopback round
+// trips, which adds server::on_receive and the asio2 send path.
+// BM_handle_concurrent runs multiple-write requests on several threads at
+// once.
+
+namespace {
+std::atomic<bool>          counting{false};
+std::atomic<std::uint64_t> allocations{0};
+
+/**
+ * Count allocations of every thread while alive
+ */
+class allocation_scope {
+public:
+  allocation_scope() {
+    allocations.store(0, std::memory_order_relaxed);
+    counting.store(true, std::memory_order_relaxed);
+  }
+
+  ~allocation_scope() { counting.store(false, std::memory_order_relaxed); }
+
+  /**
+   * Get number of allocations
+   *
+   * @return allocations since construction
+   */
+  std::uint64_t count() const {
+    return allocations.load(std::memory_order_relaxed);
+  }
+};
+
+/**
+ * Encode request of function code
+ *
+ * @param function function code
+ *
+ * @return encoded request
+ */
+modbus::packet_t allocation_request(std::int64_t function) {
+  using modbus::address_t;
+  using modbus::constants::function_code;
+
+  auto encode = [](auto&& request) {
+    request.initialize({0x0001, 0x01});
+    return request.encode();
+  };
+
+  switch (static_cast<function_code>(function)) {
+    case function_code::read_coils:
+      return encode(
+          modbus::request::read_coils(address_t{0x00},
+                                      modbus::read_num_bits_t{0x7D0}));
+    case function_code::read_discrete_inputs:
+      return encode(modbus::request::read_discrete_inputs(
+          address_t{0x00}, modbus::read_num_bits_t{0x7D0}));
+    case function_code::read_input_registers:
+      return encode(modbus::request::read_input_registers(
+          address_t{0x00}, modbus::read_num_regs_t{0x7D}));
+    case function_code::write_single_coil:
+      return encode(modbus::request::write_single_coil(
+          address_t{0x00}, modbus::value::bits::on));
+    case function_code::write_single_register:
+      return encode(modbus::request::write_single_register(
+          address_t{0x00}, modbus::reg_value_t{0x1234}));
+    case function_code::write_multiple_coils:
+      return encode(modbus::request::write_multiple_coils(
+          address_t{0x00}, modbus::write_num_bits_t{0x7B0},
+          modbus::block::bits::container_type(0x7B0, true)));
+    case function_code::write_multiple_registers:
+      return encode(modbus::request::write_multiple_registers(
+          address_t{0x00}, modbus::write_num_regs_t{0x7B},
+          modbus::block::registers::container_type(0x7B, 0x1234)));
+    case function_code::mask_write_register:
+      return encode(modbus::request::mask_write_register(
+          address_t{0x00}, modbus::mask_t{0xF2}, modbus::mask_t{0x25}));
+    case function_code::read_write_multiple_registers:
+      return encode(modbus::request::read_write_multiple_registers(
+          address_t{0x00}, modbus::read_num_regs_t{10}, address_t{0x00},
+          modbus::write_num_regs_t{4}, {1, 2, 3, 4}));
+    default:
+      return encode(modbus::request::read_holding_registers(
+          address_t{0x00}, modbus::read_num_regs_t{0x7D}));
+  }
+}
+
+/**
+ * Register function code arguments
+ *
+ * @param bench benchmark
+ */
+void function_codes(benchmark::internal::Benchmark* bench) {
+  bench->ArgName("function");
+
+  for (auto function : {0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x0F, 0x10, 0x16,
+                        0x17}) {
+    bench->Arg(function);
+  }
+}
+}  // namespace
+
+void* operator new(std::size_t size) {
+  if (counting.load(std::memory_order_relaxed)) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  if (void* ptr = std::malloc(size == 0 ? 1 : size)) {
+    return ptr;
+  }
+
+  throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+  std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+  std::free(ptr);
+}
+
+static void BM_handle_allocations(benchmark::State& state) {
+  auto data_table = modbus::table::create();
+  auto packet = allocation_request(state.range(0));
+
+  modbus::request_handler::handle(data_table.get(), packet);
+
+  allocation_scope scope;
+
+  for (auto _ : state) {
+    auto response = modbus::request_handler::handle(data_table.get(), packet);
+    benchmark::DoNotOptimize(response.data());
+  }
+
+  state.counters["allocs_per_request"] = benchmark::Counter(
+      static_cast<double>(scope.count()),
+      benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_handle_allocations)->Apply(function_codes);
+
+static void BM_handle_concurrent(benchmark::State& state) {
+  // one table per thread keeps block locks out of the measurement, what
+  // remains scales with the allocator
+  auto data_table = modbus::table::create();
+  auto packet = allocation_request(state.range(0));
+
+  for (auto _ : state) {
+    auto response = modbus::request_handler::handle(data_table.get(), packet);
+    benchmark::DoNotOptimize(response.data());
+  }
+}
+BENCHMARK(BM_handle_concurrent)
+    ->ArgName("function")
+    ->Arg(0x0F)
+    ->Arg(0x10)
+    ->ThreadRange(1, 8)
+    ->UseRealTime();
+
+namespace {
+/**
+ * Loopback port
+ */
+constexpr unsigned short allocation_port = 15021;
+
+/**
+ * Loopback server
+ */
+std::unique_ptr<modbus::server> allocation_server;
+
+/**
+ * Start loopback server
+ */
+void start_allocation_server(const benchmark::State&) {
+  allocation_server = modbus::server::create(modbus::table::create(), 1);
+  allocation_server->run("127.0.0.1", std::to_string(allocation_port));
+}
+
+/**
+ * Stop loopback server
+ */
+void stop_allocation_server(const benchmark::State&) {
+  allocation_server->stop();
+  allocation_server.reset();
+}
+}  // namespace
+
+static void BM_server_allocations(benchmark::State& state) {
+  boost::asio::io_context      io;
+  boost::asio::ip::tcp::socket socket(io);
+  boost::system::error_code    ec;
+
+  socket.connect({boost::asio::ip::address_v4::loopback(), allocation_port},
+                 ec);
+
+  if (ec) {
+    state.SkipWithError("cannot connect to loopback server");
+    return;
+  }
+
+  socket.set_option(boost::asio::ip::tcp::no_delay(true));
+
+  auto             request = allocation_request(state.range(0));
+  modbus::packet_t response(modbus::constants::max_adu_length);
+
+  auto round_trip = [&] {
+    boost::asio::write(
+        socket, boost::asio::buffer(request.data(), request.size()), ec);
+    boost::asio::read(socket, boost::asio::buffer(response.data(), 6), ec);
+    std::size_t length = (static_cast<std::uint8_t>(response[4]) << 8)
+                         | static_cast<std::uint8_t>(response[5]);
+
+    if (!ec && length <= response.size() - 6) {
+      boost::asio::read(socket,
+                        boost::asio::buffer(response.data() + 6, length), ec);
+    }
+
+    return !ec && length <= response.size() - 6;
+  };
+
+  // first round trip registers the session and per-thread state
+  if (!round_trip()) {
+    state.SkipWithError("loopback round trip failed");
+    return;
+  }
+
+  allocation_scope scope;
+
+  for (auto _ : state) {
+    if (!round_trip()) {
+      state.SkipWithError("loopback round trip failed");
+      break;
+    }
+  }
+
+  state.counters["allocs_per_request"] = benchmark::Counter(
+      static_cast<double>(scope.count()),
+      benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_server_allocations)
+    ->Apply(function_codes)
+    ->UseRealTime()
+    ->Setup(start_allocation_server)
+    ->Teardown(stop_allocation_server);
@@ -0,0 +1,350 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <memory>
+
+#include <modbuscpp/modbus.hpp>
+
+// Encode / decode cost per ADU for every function code, at the minimal and
+// maximal quantity the specification allows. Run with
+// --benchmark_format=json (or --benchmark_out=<file>) to track results
+// across releases; adu_bytes is reported as a counter.
+
+namespace {
+/**
+ * Request factory by request type
+ *
+ * @tparam request_t request type
+ */
+template <typename request_t> struct fixture;
+
+template <modbus::constants::function_code function_code>
+struct fixture<modbus::request::base_read_bits<function_code>> {
+  static constexpr std::uint16_t max = modbus::constants::max_num_bits_read;
+
+  static auto create(std::uint16_t quantity) {
+    return std::make_unique<modbus::request::base_read_bits<function_code>>(
+        modbus::address_t{0x00}, modbus::read_num_bits_t{quantity});
+  }
+};
+
+template <modbus::constants::function_code function_code>
+struct fixture<modbus::request::base_read_registers<function_code>> {
+  static constexpr std::uint16_t max = modbus::constants::max_num_regs_read;
+
+  static auto create(std::uint16_t quantity) {
+    return std::make_unique<
+        modbus::request::base_read_registers<function_code>>(
+        modbus::address_t{0x00}, modbus::read_num_regs_t{quantity});
+  }
+};
+
+template <> struct fixture<modbus::request::write_single_coil> {
+  static constexpr std::uint16_t max = 1;
+
+  static auto create(std::uint16_t) {
+    // the response echoes the coil value read before the write, keep it
+    // equal to the table default so the response decodes
+    return std::make_unique<modbus::request::write_single_coil>(
+        modbus::address_t{0x00}, modbus::value::bits::off);
+  }
+};
+
+template <> struct fixture<modbus::request::write_multiple_coils> {
+  static constexpr std::uint16_t max = modbus::constants::max_num_bits_write;
+
+  static auto create(std::uint16_t quantity) {
+    return std::make_unique<modbus::request::write_multiple_coils>(
+        modbus::address_t{0x00}, modbus::write_num_bits_t{quantity},
+        modbus::block::bits::container_type(quantity, true));
+  }
+};
+
+template <> struct fixture<modbus::request::write_single_register> {
+  static constexpr std::uint16_t max = 1;
+
+  static auto create(std::uint16_t) {
+    return std::make_unique<modbus::request::write_single_register>(
+        modbus::address_t{0x00}, modbus::reg_value_t{0x1234});
+  }
+};
+
+template <> struct fixture<modbus::request::write_multiple_registers> {
+  static constexpr std::uint16_t max = modbus::constants::max_num_regs_write;
+
+  static auto create(std::uint16_t quantity) {
+    return std::make_unique<modbus::request::write_multiple_registers>(
+        modbus::address_t{0x00}, modbus::write_num_regs_t{quantity},
+        modbus::block::registers::container_type(quantity, 0x1234));
+  }
+};
+
+template <> struct fixture<modbus::request::mask_write_register> {
+  static constexpr std::uint16_t max = 1;
+
+  static auto create(std::uint16_t) {
+    return std::make_unique<modbus::request::mask_write_register>(
+        modbus::address_t{0x00}, modbus::mask_t{0xF2}, modbus::mask_t{0x25});
+  }
+};
+
+template <> struct fixture<modbus::request::read_write_multiple_registers> {
+  /**
+   * Max write quantity of read / write multiple registers (spec 6.17)
+   */
+  static constexpr std::uint16_t max = 0x79;
+
+  static auto create(std::uint16_t quantity) {
+    // values are only settable through an initializer list, build the ADU
+    // by hand and decode it instead
+    std::uint16_t    length = 1 + 1 + 9 + quantity * 2;
+    modbus::packet_t packet{0x00,
+                            0x01,
+                            0x00,
+                            0x00,
+                            static_cast<char>(length >> 8),
+                            static_cast<char>(length & 0xFF),
+                            0x01,
+                            0x17,
+                            0x00,
+                            0x00,
+                            static_cast<char>(quantity >> 8),
+                            static_cast<char>(quantity & 0xFF),
+                            0x00,
+                            0x00,
+                            static_cast<char>(quantity >> 8),
+                            static_cast<char>(quantity & 0xFF),
+                            static_cast<char>(quantity * 2)};
+
+    for (std::uint16_t idx = 0; idx < quantity; ++idx) {
+      packet.push_back(0x12);
+      packet.push_back(0x34);
+    }
+
+    auto request
+        = std::make_unique<modbus::request::read_write_multiple_registers>();
+    request->decode(packet);
+    return request;
+  }
+};
+
+/**
+ * Create initialized request
+ *
+ * @tparam request_t request type
+ *
+ * @param state benchmark state, range(0) is the quantity
+ *
+ * @return request
+ */
+template <typename request_t> auto create_request(benchmark::State& state) {
+  auto request
+      = fixture<request_t>::create(static_cast<std::uint16_t>(state.range(0)));
+  request->initialize({0x0001, 0x01});
+  return request;
+}
+
+/**
+ * Register min / max quantity arguments
+ *
+ * @tparam request_t request type
+ *
+ * @param bench benchmark
+ */
+template <typename request_t>
+void quantities(benchmark::internal::Benchmark* bench) {
+  bench->ArgName("quantity")->Arg(1);
+
+  if (fixture<request_t>::max > 1) {
+    bench->Arg(fixture<request_t>::max);
+  }
+}
+
+/**
+ * Report ADU size
+ *
+ * @param state  benchmark state
+ * @param packet packet
+ */
+void report(benchmark::State& state, const modbus::packet_t& packet) {
+  state.counters["adu_bytes"] = static_cast<double>(packet.size());
+  state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations())
+                          * static_cast<std::int64_t>(packet.size()));
+}
+
+/**
+ * Create exception for exception responses
+ *
+ * @return illegal data address exception
+ */
+modbus::ex::illegal_data_address illegal_data_address() {
+  return modbus::ex::illegal_data_address(
+      modbus::constants::function_code::read_holding_registers,
+      modbus::header_t{0x0001, 0x0006, 0x01});
+}
+}  // namespace
+
+template <typename request_t>
+static void BM_request_encode(benchmark::State& state) {
+  auto request = create_request<request_t>(state);
+
+  for (auto _ : state) {
+    auto packet = request->encode();
+    benchmark::DoNotOptimize(packet.data());
+  }
+
+  report(state, request->encode());
+}
+
+template <typename request_t>
+static void BM_request_decode(benchmark::State& state) {
+  auto      packet = create_request<request_t>(state)->encode();
+  request_t request;
+
+  for (auto _ : state) {
+    request.decode(packet);
+    benchmark::ClobberMemory();
+  }
+
+  report(state, packet);
+}
+
+template <typename request_t>
+static void BM_response_encode(benchmark::State& state) {
+  auto data_table = modbus::table::create();
+  auto request = create_request<request_t>(state);
+  auto response = request->execute(data_table.get());
+
+  for (auto _ : state) {
+    auto packet = response->encode();
+    benchmark::DoNotOptimize(packet.data());
+  }
+
+  report(state, response->encode());
+}
+
+template <typename request_t, typename response_t>
+static void BM_response_decode(benchmark::State& state) {
+  auto       data_table = modbus::table::create();
+  auto       request = create_request<request_t>(state);
+  auto       packet = request->execute(data_table.get())->encode();
+  response_t response(request.get());
+
+  for (auto _ : state) {
+    response.decode(packet);
+    benchmark::ClobberMemory();
+  }
+
+  report(state, packet);
+}
+
+#define MODBUSCPP_CODEC_BENCHMARK(name)                                    \
+  BENCHMARK_TEMPLATE(BM_request_encode, modbus::request::name)             \
+      ->Apply(quantities<modbus::request::name>);                          \
+  BENCHMARK_TEMPLATE(BM_request_decode, modbus::request::name)             \
+      ->Apply(quantities<modbus::request::name>);                          \
+  BENCHMARK_TEMPLATE(BM_response_encode, modbus::request::name)            \
+      ->Apply(quantities<modbus::request::name>);                          \
+  BENCHMARK_TEMPLATE(BM_response_decode, modbus::request::name,            \
+                     modbus::response::name)                               \
+      ->Apply(quantities<modbus::request::name>)
+
+MODBUSCPP_CODEC_BENCHMARK(read_coils);
+MODBUSCPP_CODEC_BENCHMARK(read_discrete_inputs);
+MODBUSCPP_CODEC_BENCHMARK(read_holding_registers);
+MODBUSCPP_CODEC_BENCHMARK(read_input_registers);
+MODBUSCPP_CODEC_BENCHMARK(write_single_coil);
+MODBUSCPP_CODEC_BENCHMARK(write_multiple_coils);
+MODBUSCPP_CODEC_BENCHMARK(write_single_register);
+MODBUSCPP_CODEC_BENCHMARK(write_multiple_registers);
+MODBUSCPP_CODEC_BENCHMARK(mask_write_register);
+MODBUSCPP_CODEC_BENCHMARK(read_write_multiple_registers);
+
+static void BM_error_encode(benchmark::State& state) {
+  modbus::response::error error(illegal_data_address());
+
+  for (auto _ : state) {
+    auto packet = error.encode();
+    benchmark::DoNotOptimize(packet.data());
+  }
+
+  report(state, error.encode());
+}
+BENCHMARK(BM_error_encode);
+
+static void BM_error_decode(benchmark::State& state) {
+  auto packet = modbus::response::error(illegal_data_address()).encode();
+  modbus::response::error error;
+
+  for (auto _ : state) {
+    error.decode(packet);
+    benchmark::ClobberMemory();
+  }
+
+  report(state, packet);
+}
+BENCHMARK(BM_error_decode);
+
+// Coil packing kernels against the bit by bit reference, for the payload of
+// a 2000-coil read response and of a 1968-coil write request. A non-zero
+// offset starts the bits mid storage word, as reading from a coil address
+// that is not a multiple of the word size does.
+
+template <bool scalar> static void BM_pack_bits(benchmark::State& state) {
+  auto count = static_cast<std::size_t>(state.range(0));
+  auto offset = static_cast<std::size_t>(state.range(1));
+  modbus::block::bits::container_type bits(offset + count);
+
+  for (std::size_t idx = 0; idx < bits.size(); ++idx) {
+    bits[idx] = idx % 3 == 0;
+  }
+
+  auto begin = bits.begin() + offset;
+
+  for (auto _ : state) {
+    modbus::packet_t packet;
+
+    if constexpr (scalar) {
+      modbus::op::scalar::pack_bits(packet, begin, begin + count);
+    } else {
+      modbus::op::pack_bits(packet, begin, begin + count);
+    }
+
+    benchmark::DoNotOptimize(packet.data());
+  }
+
+  state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations())
+                          * static_cast<std::int64_t>((count + 7) / 8));
+}
+BENCHMARK_TEMPLATE(BM_pack_bits, true)
+    ->ArgNames({"bits", "offset"})
+    ->Args({modbus::constants::max_num_bits_read, 0})
+    ->Args({modbus::constants::max_num_bits_read, 3});
+BENCHMARK_TEMPLATE(BM_pack_bits, false)
+    ->ArgNames({"bits", "offset"})
+    ->Args({modbus::constants::max_num_bits_read, 0})
+    ->Args({modbus::constants::max_num_bits_read, 3});
+
+template <bool scalar> static void BM_unpack_bits(benchmark::State& state) {
+  modbus::packet_t packet((state.range(0) + 7) / 8);
+
+  for (std::size_t idx = 0; idx < packet.size(); ++idx) {
+    packet[idx] = static_cast<char>(idx * 37);
+  }
+
+  for (auto _ : state) {
+    auto bits = scalar ? modbus::op::scalar::unpack_bits(packet.begin(),
+                                                         packet.end())
+                       : modbus::op::unpack_bits(packet.begin(), packet.end());
+    benchmark::DoNotOptimize(&bits);
+  }
+
+  state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations())
+                          * static_cast<std::int64_t>(packet.size()));
+}
+BENCHMARK_TEMPLATE(BM_unpack_bits, true)
+    ->ArgName("bits")
+    ->Arg(modbus::constants::max_num_bits_write);
+BENCHMARK_TEMPLATE(BM_unpack_bits, false)
+    ->ArgName("bits")
+    ->Arg(modbus::constants::max_num_bits_write);
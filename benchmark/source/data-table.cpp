@@ -0,0 +1,393 @@
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <vector>
+
+#include <modbuscpp/modbus.hpp>
+
+// Data table contention under concurrent readers and writers.
+//
+// Arguments:
+// - writers:  percentage of threads that write, the rest read (at least one
+//             writer when non-zero)
+// - slice:    number of registers per operation
+// - hotspot:  0 picks addresses uniformly over the block, 1 sends 90% of
+//             operations to the first 1/64 of the block
+//
+// Throughput is reported as items_per_second plus reads / writes per second,
+// latency percentiles (ns) are taken over the merged samples of all reader
+// and all writer threads respectively. Select thread counts with
+// --benchmark_filter=threads:16.
+
+namespace {
+/**
+ * Number of registers in the benchmarked block
+ */
+constexpr std::size_t block_size = modbus::block::registers::max_capacity;
+
+/**
+ * Sample latency of one in every sample_rate operations
+ */
+constexpr std::size_t sample_rate = 8;
+
+/**
+ * Shared data table
+ */
+std::unique_ptr<modbus::table> shared_table;
+
+/**
+ * Latency samples of every thread of a run
+ */
+struct merged_samples_t {
+  /**
+   * Mutex guarding samples
+   */
+  std::mutex mutex;
+  /**
+   * Signaled once every thread merged its samples
+   */
+  std::condition_variable merged;
+  /**
+   * Number of threads that merged their samples
+   */
+  int threads = 0;
+  /**
+   * Read latencies (ns)
+   */
+  std::vector<std::uint64_t> reads;
+  /**
+   * Write latencies (ns)
+   */
+  std::vector<std::uint64_t> writes;
+};
+
+/**
+ * Samples of the current run
+ */
+std::unique_ptr<merged_samples_t> shared_samples;
+
+/**
+ * Address generator
+ */
+class address_generator {
+public:
+  /**
+   * Address generator constructor
+   *
+   * @param slice   registers per operation
+   * @param hotspot true to send 90% of addresses to the hot range
+   * @param seed    random seed
+   */
+  address_generator(std::size_t slice, bool hotspot, unsigned int seed)
+      : hotspot_{hotspot},
+        engine_{seed},
+        all_{0, static_cast<std::uint32_t>(block_size - slice)},
+        hot_{0, static_cast<std::uint32_t>(
+                    std::max(block_size / 64, slice) - slice)},
+        coin_{0, 9} {}
+
+  /**
+   * Get next address
+   *
+   * @return address
+   */
+  inline modbus::address_t next() {
+    auto value = hotspot_ && coin_(engine_) != 0 ? hot_(engine_)
+                                                 : all_(engine_);
+    return modbus::address_t{static_cast<std::uint16_t>(value)};
+  }
+
+private:
+  /**
+   * Hot spot distribution
+   */
+  bool hotspot_;
+  /**
+   * Random engine
+   */
+  std::minstd_rand engine_;
+  /**
+   * Whole block
+   */
+  std::uniform_int_distribution<std::uint32_t> all_;
+  /**
+   * Hot range
+   */
+  std::uniform_int_distribution<std::uint32_t> hot_;
+  /**
+   * Hot range selector
+   */
+  std::uniform_int_distribution<int> coin_;
+};
+
+/**
+ * Thread role and sampled latencies
+ */
+class worker {
+public:
+  /**
+   * Worker constructor
+   *
+   * @param state benchmark state
+   */
+  explicit worker(benchmark::State& state)
+      : writers_{writer_count(state)},
+        writer_{state.thread_index() < writers_},
+        addresses_{static_cast<std::size_t>(state.range(1)),
+                   state.range(2) != 0,
+                   static_cast<unsigned int>(state.thread_index() + 1)} {
+    samples_.reserve(1 << 16);
+  }
+
+  /**
+   * Check if thread writes
+   *
+   * @return true if writer
+   */
+  inline bool writer() const { return writer_; }
+
+  /**
+   * Get next address
+   *
+   * @return address
+   */
+  inline modbus::address_t address() { return addresses_.next(); }
+
+  /**
+   * Run operation, sampling its latency
+   *
+   * @param operation operation
+   */
+  template <typename operation_t> inline void run(operation_t&& operation) {
+    if (++count_ % sample_rate != 0) {
+      operation();
+      return;
+    }
+
+    auto begin = std::chrono::steady_clock::now();
+    operation();
+    auto end = std::chrono::steady_clock::now();
+    samples_.push_back(static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin)
+            .count()));
+  }
+
+  /**
+   * Report counters
+   *
+   * Counters are summed over threads, so percentiles of the merged samples
+   * of a role are only reported by the first thread of that role
+   *
+   * @param state benchmark state
+   */
+  void report(benchmark::State& state) {
+    auto        threads = state.threads();
+    const char* prefix = writer_ ? "write" : "read";
+    auto&       merged = *shared_samples;
+
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()));
+    state.counters["reads"] = benchmark::Counter(
+        writer_ ? 0 : static_cast<double>(state.iterations()),
+        benchmark::Counter::kIsRate);
+    state.counters["writes"] = benchmark::Counter(
+        writer_ ? static_cast<double>(state.iterations()) : 0,
+        benchmark::Counter::kIsRate);
+
+    std::unique_lock<std::mutex> lock(merged.mutex);
+    auto& samples = writer_ ? merged.writes : merged.reads;
+    samples.insert(samples.end(), samples_.begin(), samples_.end());
+
+    if (++merged.threads == threads) {
+      std::sort(merged.reads.begin(), merged.reads.end());
+      std::sort(merged.writes.begin(), merged.writes.end());
+      merged.merged.notify_all();
+    } else {
+      merged.merged.wait(lock, [&] { return merged.threads == threads; });
+    }
+
+    if (state.thread_index() != (writer_ ? 0 : writers_)) {
+      return;
+    }
+
+    for (auto [name, percentile] : {std::pair{"_p50_ns", 0.5},
+                                    std::pair{"_p99_ns", 0.99},
+                                    std::pair{"_p999_ns", 0.999}}) {
+      double value = 0;
+
+      if (!samples.empty()) {
+        auto rank = static_cast<std::size_t>(
+            percentile * static_cast<double>(samples.size() - 1));
+        value = static_cast<double>(samples[rank]);
+      }
+
+      state.counters[std::string(prefix) + name] = value;
+    }
+  }
+
+private:
+  /**
+   * Get number of writer threads
+   *
+   * @param state benchmark state
+   *
+   * @return writer threads
+   */
+  static int writer_count(benchmark::State& state) {
+    auto percent = state.range(0);
+
+    if (percent == 0) {
+      return 0;
+    }
+
+    return std::max<int>(1, static_cast<int>(state.threads() * percent / 100));
+  }
+
+private:
+  /**
+   * Number of writer threads
+   */
+  int writers_;
+  /**
+   * Thread role
+   */
+  bool writer_;
+  /**
+   * Address generator
+   */
+  address_generator addresses_;
+  /**
+   * Operation count
+   */
+  std::size_t count_ = 0;
+  /**
+   * Sampled latencies (ns)
+   */
+  std::vector<std::uint64_t> samples_;
+};
+
+/**
+ * Create shared table and samples, runs once before the threads start
+ */
+void create_table(const benchmark::State&) {
+  shared_table = modbus::table::create();
+  shared_samples = std::make_unique<merged_samples_t>();
+}
+
+/**
+ * Destroy shared table and samples
+ */
+void destroy_table(const benchmark::State&) {
+  shared_table.reset();
+  shared_samples.reset();
+}
+
+/**
+ * Register contention arguments
+ *
+ * @param bench benchmark
+ */
+void contention(benchmark::internal::Benchmark* bench) {
+  bench->ArgNames({"writers", "slice", "hotspot"})
+      ->ArgsProduct({{0, 10, 50}, {1, 125}, {0, 1}})
+      ->Threads(1)
+      ->Threads(4)
+      ->Threads(16)
+      ->Threads(64)
+      ->UseRealTime()
+      ->Setup(create_table)
+      ->Teardown(destroy_table);
+}
+}  // namespace
+
+static void BM_sequential_get_set(benchmark::State& state) {
+  auto&                   block = shared_table->holding_registers();
+  worker                  worker(state);
+  modbus::read_num_regs_t count(static_cast<std::uint16_t>(state.range(1)));
+  modbus::block::registers::container_type buffer(count(), 0x1234);
+
+  for (auto _ : state) {
+    auto address = worker.address();
+
+    if (worker.writer()) {
+      worker.run([&] { block.set(address, buffer); });
+    } else {
+      worker.run([&] {
+        auto slice = block.get(address, count);
+        std::copy(slice.first, slice.second, buffer.begin());
+        benchmark::DoNotOptimize(buffer.data());
+      });
+    }
+  }
+
+  worker.report(state);
+}
+BENCHMARK(BM_sequential_get_set)->Apply(contention);
+
+static void BM_sequential_ref(benchmark::State& state) {
+  auto&  block = shared_table->holding_registers();
+  worker worker(state);
+  auto   slice = static_cast<std::size_t>(state.range(1));
+
+  // ref() takes no lock, this is the floor the locked paths compare to
+  for (auto _ : state) {
+    auto address = worker.address();
+
+    worker.run([&] {
+      auto range = block.ref(address, slice);
+
+      if (worker.writer()) {
+        std::fill(range.first, range.second, 0x1234);
+      }
+
+      benchmark::DoNotOptimize(*range.first);
+    });
+  }
+
+  worker.report(state);
+}
+BENCHMARK(BM_sequential_ref)->Apply(contention);
+
+static void BM_table_handle(benchmark::State& state) {
+  worker worker(state);
+  auto   slice = static_cast<std::uint16_t>(std::min<std::int64_t>(
+      state.range(1), modbus::constants::max_num_regs_write));
+
+  // encode ahead so the loop only measures request handling
+  std::vector<modbus::packet_t> packets(1024);
+
+  for (auto& packet : packets) {
+    if (worker.writer()) {
+      modbus::request::write_multiple_registers request(
+          worker.address(), modbus::write_num_regs_t{slice},
+          modbus::block::registers::container_type(slice, 0x1234));
+      request.initialize({0x0001, 0x01});
+      packet = request.encode();
+    } else {
+      modbus::request::read_holding_registers request(
+          worker.address(), modbus::read_num_regs_t{slice});
+      request.initialize({0x0001, 0x01});
+      packet = request.encode();
+    }
+  }
+
+  std::size_t next = 0;
+
+  for (auto _ : state) {
+    const auto& packet = packets[next++ % packets.size()];
+
+    worker.run([&] {
+      auto response
+          = modbus::request_handler::handle(shared_table.get(), packet);
+      benchmark::DoNotOptimize(response.data());
+    });
+  }
+
+  worker.report(state);
+}
+BENCHMARK(BM_table_handle)->Apply(contention);
@@ -0,0 +1,123 @@
+#include <benchmark/benchmark.h>
+
+#include <chrono>
+#include <string>
+
+#include <modbuscpp/modbus.hpp>
+
+namespace {
+/**
+ * Logger that drops every message, so only formatting cost is measured
+ */
+class null_logger : public modbus::logger {
+public:
+  explicit null_logger(bool debug = false) : modbus::logger(debug) {}
+
+  virtual ~null_logger() override {}
+
+protected:
+  inline virtual void error_impl(
+      const std::string& message) const noexcept override {
+    benchmark::DoNotOptimize(message.data());
+  }
+
+  inline virtual void debug_impl(
+      const std::string& message) const noexcept override {
+    benchmark::DoNotOptimize(message.data());
+  }
+
+  inline virtual void info_impl(
+      const std::string& message) const noexcept override {
+    benchmark::DoNotOptimize(message.data());
+  }
+};
+
+modbus::packet_t read_holding_registers_packet() {
+  modbus::request::read_holding_registers req(modbus::address_t{0x00},
+                                              modbus::read_num_regs_t{10});
+  req.initialize({0x0001, 0x01});
+  return req.encode();
+}
+
+void set_debug(bool debug) {
+  modbus::logger::create<null_logger>();
+  modbus::logger::get()->set_debug(debug);
+}
+}  // namespace
+
+static void BM_logger_debug(benchmark::State& state) {
+  set_debug(state.range(0));
+  auto function = modbus::constants::function_code::read_holding_registers;
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(function);
+    modbus::logger::debug(FMT_STRING("Get {} request"),
+                          modbus::function_code_str(function));
+  }
+
+  set_debug(false);
+}
+BENCHMARK(BM_logger_debug)->ArgName("debug")->Arg(0)->Arg(1);
+
+static void BM_handle_read_holding_registers(benchmark::State& state) {
+  set_debug(state.range(0));
+  auto data_table = modbus::table::create();
+  auto packet = read_holding_registers_packet();
+
+  for (auto _ : state) {
+    auto response = modbus::request_handler::handle(data_table.get(), packet);
+    benchmark::DoNotOptimize(response.data());
+  }
+
+  set_debug(false);
+}
+BENCHMARK(BM_handle_read_holding_registers)
+    ->ArgName("debug")
+    ->Arg(0)
+    ->Arg(1);
+
+namespace {
+/**
+ * Async logger that drops formatted messages
+ */
+class null_async_logger : public modbus::async_logger {
+public:
+  explicit null_async_logger(const initializer_t& initializer)
+      : modbus::async_logger(initializer) {}
+
+  virtual ~null_async_logger() override { stop(); }
+
+protected:
+  virtual void write(level, const std::string& message) const
+      noexcept override {
+    benchmark::DoNotOptimize(message.data());
+  }
+};
+}  // namespace
+
+static void BM_logger_error(benchmark::State& state) {
+  auto* previous = modbus::logger::get();
+
+  modbus::async_logger::initializer_t initializer;
+  initializer.max_rate = 0;
+  initializer.interval = std::chrono::milliseconds(1);
+  null_async_logger async(initializer);
+  null_logger       sync;
+
+  if (state.range(0)) {
+    modbus::logger::set(&async);
+  } else {
+    modbus::logger::set(&sync);
+  }
+
+  auto function = modbus::constants::function_code::read_holding_registers;
+
+  for (auto _ : state) {
+    modbus::logger::error(FMT_STRING("Illegal data address {} for {}"), 0x1234,
+                          modbus::function_code_str(function));
+  }
+
+  modbus::logger::set(previous);
+  state.counters["dropped"] = async.dropped();
+}
+BENCHMARK(BM_logger_error)->ArgName("async")->Arg(0)->Arg(1);
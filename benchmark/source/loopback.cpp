@@ -0,0 +1,127 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <memory>
+
+#include <boost/asio.hpp>
+
+#include <modbuscpp/modbus.hpp>
+
+// Request round trips to a modbus::server over loopback, one connection per
+// benchmark thread. Includes the kernel TCP path, so compare results from
+// the same machine only.
+
+namespace {
+/**
+ * Loopback port
+ */
+constexpr unsigned short loopback_port = 15020;
+
+/**
+ * Loopback server
+ */
+std::unique_ptr<modbus::server> loopback_server;
+
+/**
+ * Start loopback server, runs once before the threads start
+ */
+void start_server(const benchmark::State&) {
+  loopback_server = modbus::server::create(modbus::table::create(), 2);
+  loopback_server->run("127.0.0.1", std::to_string(loopback_port));
+}
+
+/**
+ * Stop loopback server
+ */
+void stop_server(const benchmark::State&) {
+  loopback_server->stop();
+  loopback_server.reset();
+}
+
+/**
+ * Encode request of function code
+ *
+ * @param function function code
+ *
+ * @return encoded request
+ */
+modbus::packet_t loopback_request(std::int64_t function) {
+  modbus::packet_t packet;
+
+  switch (static_cast<modbus::constants::function_code>(function)) {
+    case modbus::constants::function_code::read_coils: {
+      modbus::request::read_coils request(modbus::address_t{0x00},
+                                          modbus::read_num_bits_t{16});
+      request.initialize({0x0001, 0x01});
+      packet = request.encode();
+      break;
+    }
+    case modbus::constants::function_code::write_multiple_registers: {
+      modbus::request::write_multiple_registers request(
+          modbus::address_t{0x00}, modbus::write_num_regs_t{10},
+          modbus::block::registers::container_type(10, 0x1234));
+      request.initialize({0x0001, 0x01});
+      packet = request.encode();
+      break;
+    }
+    default: {
+      modbus::request::read_holding_registers request(
+          modbus::address_t{0x00}, modbus::read_num_regs_t{10});
+      request.initialize({0x0001, 0x01});
+      packet = request.encode();
+      break;
+    }
+  }
+
+  return packet;
+}
+}  // namespace
+
+static void BM_loopback(benchmark::State& state) {
+  boost::asio::io_context      io;
+  boost::asio::ip::tcp::socket socket(io);
+  boost::system::error_code    ec;
+
+  socket.connect({boost::asio::ip::address_v4::loopback(), loopback_port}, ec);
+
+  if (ec) {
+    state.SkipWithError("cannot connect to loopback server");
+    return;
+  }
+
+  socket.set_option(boost::asio::ip::tcp::no_delay(true));
+
+  auto             request = loopback_request(state.range(0));
+  modbus::packet_t response(modbus::constants::max_adu_length);
+
+  for (auto _ : state) {
+    boost::asio::write(
+        socket, boost::asio::buffer(request.data(), request.size()), ec);
+    // MBAP length counts the unit id and the PDU
+    boost::asio::read(socket, boost::asio::buffer(response.data(), 6), ec);
+    std::size_t length = (static_cast<std::uint8_t>(response[4]) << 8)
+                         | static_cast<std::uint8_t>(response[5]);
+
+    if (!ec && length <= response.size() - 6) {
+      boost::asio::read(socket,
+                        boost::asio::buffer(response.data() + 6, length), ec);
+    }
+
+    if (ec || length > response.size() - 6) {
+      state.SkipWithError("loopback round trip failed");
+      break;
+    }
+  }
+
+  state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()));
+}
+BENCHMARK(BM_loopback)
+    ->ArgName("function")
+    ->Arg(0x01)
+    ->Arg(0x03)
+    ->Arg(0x10)
+    ->Threads(1)
+    ->Threads(4)
+    ->UseRealTime()
+    ->Setup(start_server)
+    ->Teardown(stop_server);
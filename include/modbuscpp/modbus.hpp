@@ -23,7 +23,12 @@
 #include "modbuscpp/utilities.hpp"
 
 #include "modbuscpp/logger.hpp"
+#include "modbuscpp/trace.hpp"
+#include "modbuscpp/async-logger.hpp"
 
+#include "modbuscpp/access-heatmap.hpp"
+#include "modbuscpp/instrumented-mutex.hpp"
+#include "modbuscpp/memory-pool.hpp"
 #include "modbuscpp/data-table.hpp"
 #include "modbuscpp/data-table.inline.hpp"
 
@@ -44,8 +49,23 @@
 
 #include "modbuscpp/register-write.hpp"
 
+#include "modbuscpp/stats.hpp"
+#include "modbuscpp/session-stats.hpp"
+#include "modbuscpp/traffic-capture.hpp"
+
 #include "modbuscpp/request-handler.hpp"
 
 #include "modbuscpp/server.hpp"
+#include "modbuscpp/metrics-server.hpp"
+#include "modbuscpp/simulator.hpp"
+
+// Client helpers
+#include "modbuscpp/rtt-estimator.hpp"
+#include "modbuscpp/write-coalescer.hpp"
+
+#include "modbuscpp/read-cache.hpp"
+#include "modbuscpp/read-cache.inline.hpp"
+
+#include "modbuscpp/prepared-request.hpp"
 
 #endif  // LIB_MODBUS_MODBUS_HPP_
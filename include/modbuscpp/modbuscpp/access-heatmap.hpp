@@ -0,0 +1,177 @@
+#ifndef LIB_MODBUS_MODBUS_ACCESS_HEATMAP_HPP_
+#define LIB_MODBUS_MODBUS_ACCESS_HEATMAP_HPP_
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <boost/core/noncopyable.hpp>
+
+#include "types.hpp"
+
+namespace modbus {
+/**
+ * @brief address range access counters
+ *
+ * @author  Ray Andrew
+ * @ingroup Modbus
+ *
+ * Counts requests touching every 64-address bucket of a block, split by
+ * reads and writes. A request spanning several buckets counts once in
+ * each of them.
+ *
+ * Off by default; when disabled, recording costs one relaxed load.
+ */
+class access_heatmap : private boost::noncopyable {
+public:
+  /**
+   * Bucket bits
+   */
+  static constexpr unsigned int bucket_bits = 6;
+  /**
+   * Addresses per bucket
+   */
+  static constexpr std::size_t bucket_size = 1 << bucket_bits;
+
+  /**
+   * Address range stats
+   */
+  struct range_t {
+    /**
+     * Get number of accesses
+     *
+     * @return reads + writes
+     */
+    inline std::uint64_t accesses() const { return reads + writes; }
+
+    /**
+     * First address
+     */
+    std::uint16_t first = 0;
+    /**
+     * Last address (inclusive)
+     */
+    std::uint16_t last = 0;
+    /**
+     * Read requests
+     */
+    std::uint64_t reads = 0;
+    /**
+     * Write requests
+     */
+    std::uint64_t writes = 0;
+  };
+
+  /**
+   * Heatmap constructor
+   *
+   * @param starting_address starting address of block
+   * @param capacity         capacity of block
+   */
+  access_heatmap(const address_t& starting_address, std::size_t capacity);
+
+  /**
+   * Record read
+   *
+   * @param address first address
+   * @param count   number of addresses
+   */
+  inline void read(const address_t& address, std::size_t count) noexcept {
+    if (enabled_.load(std::memory_order_relaxed)) {
+      record(reads_.get(), address, count);
+    }
+  }
+
+  /**
+   * Record write
+   *
+   * @param address first address
+   * @param count   number of addresses
+   */
+  inline void write(const address_t& address, std::size_t count) noexcept {
+    if (enabled_.load(std::memory_order_relaxed)) {
+      record(writes_.get(), address, count);
+    }
+  }
+
+  /**
+   * Enable or disable recording
+   *
+   * @param enabled recording status
+   */
+  inline void enable(bool enabled) noexcept {
+    enabled_.store(enabled, std::memory_order_relaxed);
+  }
+
+  /**
+   * Get recording status
+   *
+   * @return true if recording
+   */
+  inline bool enabled() const noexcept {
+    return enabled_.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * Get accessed ranges
+   *
+   * @return ranges with at least one access, by address
+   */
+  std::vector<range_t> ranges() const;
+
+  /**
+   * Get hottest ranges
+   *
+   * @param limit max number of ranges
+   *
+   * @return ranges with at least one access, most accessed first
+   */
+  std::vector<range_t> hottest(std::size_t limit = 10) const;
+
+  /**
+   * Reset counters
+   */
+  void reset() noexcept;
+
+private:
+  /**
+   * Increment buckets touched by range
+   *
+   * @param counters counters
+   * @param address  first address
+   * @param count    number of addresses
+   */
+  void record(std::atomic<std::uint64_t>* counters,
+              const address_t&            address,
+              std::size_t                 count) noexcept;
+
+private:
+  /**
+   * Starting address of block
+   */
+  const std::uint16_t starting_address_;
+  /**
+   * Capacity of block
+   */
+  const std::size_t capacity_;
+  /**
+   * Number of buckets
+   */
+  const std::size_t bucket_count_;
+  /**
+   * Recording status
+   */
+  std::atomic<bool> enabled_;
+  /**
+   * Read requests by bucket
+   */
+  std::unique_ptr<std::atomic<std::uint64_t>[]> reads_;
+  /**
+   * Write requests by bucket
+   */
+  std::unique_ptr<std::atomic<std::uint64_t>[]> writes_;
+};
+}  // namespace modbus
+
+#endif  // LIB_MODBUS_MODBUS_ACCESS_HEATMAP_HPP_
@@ -0,0 +1,444 @@
+#ifndef LIB_MODBUS_MODBUS_ADU_BUFFER_HPP_
+#define LIB_MODBUS_MODBUS_ADU_BUFFER_HPP_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <initializer_list>
+#include <iterator>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+
+#include "constants.hpp"
+
+namespace modbus {
+/**
+ * @brief fixed-capacity ADU buffer
+ *
+ * @author  Ray Andrew
+ * @ingroup Modbus
+ *
+ * Contiguous byte buffer with inline storage of constants::max_adu_length
+ * bytes. An ADU never exceeds that length, so packets live on the stack or
+ * inside their owner and never touch the heap.
+ *
+ * Provides the subset of the std::vector<char> interface used by the
+ * encoders and decoders. Growing past the capacity throws
+ * std::length_error, like a vector growing past max_size().
+ */
+class adu_buffer {
+public:
+  typedef char                                  value_type;
+  typedef std::size_t                           size_type;
+  typedef std::ptrdiff_t                        difference_type;
+  typedef value_type&                           reference;
+  typedef const value_type&                     const_reference;
+  typedef value_type*                           pointer;
+  typedef const value_type*                     const_pointer;
+  typedef value_type*                           iterator;
+  typedef const value_type*                     const_iterator;
+  typedef std::reverse_iterator<iterator>       reverse_iterator;
+  typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+
+  /**
+   * Buffer capacity
+   */
+  static constexpr size_type max_capacity = constants::max_adu_length;
+
+  /**
+   * Empty buffer constructor
+   */
+  adu_buffer() noexcept : size_{0} {}
+
+  /**
+   * Zero-filled buffer constructor
+   *
+   * @param count number of bytes
+   */
+  explicit adu_buffer(size_type count) : adu_buffer(count, 0) {}
+
+  /**
+   * Filled buffer constructor
+   *
+   * @param count number of bytes
+   * @param value byte value
+   */
+  adu_buffer(size_type count, value_type value) : size_{0} {
+    assign(count, value);
+  }
+
+  /**
+   * Range constructor
+   *
+   * @param first begin of range
+   * @param last  end of range
+   */
+  template <typename iterator_t,
+            typename = std::enable_if_t<!std::is_integral_v<iterator_t>>>
+  adu_buffer(iterator_t first, iterator_t last) : size_{0} {
+    assign(first, last);
+  }
+
+  /**
+   * Initializer list constructor
+   *
+   * @param bytes bytes
+   */
+  adu_buffer(std::initializer_list<value_type> bytes) : size_{0} {
+    assign(bytes.begin(), bytes.end());
+  }
+
+  /**
+   * Copy constructor, copies only the used bytes
+   *
+   * @param other other buffer
+   */
+  adu_buffer(const adu_buffer& other) noexcept : size_{other.size_} {
+    std::memcpy(data_, other.data_, size_);
+  }
+
+  /**
+   * Copy assignment, copies only the used bytes
+   *
+   * @param other other buffer
+   *
+   * @return this buffer
+   */
+  adu_buffer& operator=(const adu_buffer& other) noexcept {
+    if (this != &other) {
+      size_ = other.size_;
+      std::memcpy(data_, other.data_, size_);
+    }
+
+    return *this;
+  }
+
+  /**
+   * Replace content with range
+   *
+   * @param first begin of range
+   * @param last  end of range
+   */
+  template <typename iterator_t,
+            typename = std::enable_if_t<!std::is_integral_v<iterator_t>>>
+  void assign(iterator_t first, iterator_t last) {
+    auto count = static_cast<size_type>(std::distance(first, last));
+    check(count);
+    std::copy(first, last, data_);
+    size_ = count;
+  }
+
+  /**
+   * Replace content with count copies of value
+   *
+   * @param count number of bytes
+   * @param value byte value
+   */
+  void assign(size_type count, value_type value) {
+    check(count);
+    std::memset(data_, value, count);
+    size_ = count;
+  }
+
+  /**
+   * Get pointer to the first byte
+   *
+   * @return pointer to the first byte
+   */
+  inline pointer data() noexcept { return data_; }
+
+  /**
+   * Get pointer to the first byte (const)
+   *
+   * @return pointer to the first byte
+   */
+  inline const_pointer data() const noexcept { return data_; }
+
+  /**
+   * Get view of used bytes
+   *
+   * @return view of used bytes
+   */
+  inline std::string_view view() const noexcept { return {data_, size_}; }
+
+  /**
+   * Get number of bytes
+   *
+   * @return number of bytes
+   */
+  inline size_type size() const noexcept { return size_; }
+
+  /**
+   * Check if buffer is empty
+   *
+   * @return true if empty
+   */
+  inline bool empty() const noexcept { return size_ == 0; }
+
+  /**
+   * Get capacity
+   *
+   * @return capacity
+   */
+  inline static constexpr size_type capacity() noexcept {
+    return max_capacity;
+  }
+
+  /**
+   * Get max size
+   *
+   * @return max size
+   */
+  inline static constexpr size_type max_size() noexcept {
+    return max_capacity;
+  }
+
+  /**
+   * Check requested capacity, storage is inline
+   *
+   * @param count requested capacity
+   */
+  inline void reserve(size_type count) const { check(count); }
+
+  inline iterator       begin() noexcept { return data_; }
+  inline const_iterator begin() const noexcept { return data_; }
+  inline const_iterator cbegin() const noexcept { return data_; }
+  inline iterator       end() noexcept { return data_ + size_; }
+  inline const_iterator end() const noexcept { return data_ + size_; }
+  inline const_iterator cend() const noexcept { return end(); }
+
+  inline reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+  inline reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+
+  inline const_reverse_iterator rbegin() const noexcept {
+    return const_reverse_iterator(end());
+  }
+
+  inline const_reverse_iterator rend() const noexcept {
+    return const_reverse_iterator(begin());
+  }
+
+  /**
+   * Get byte
+   *
+   * @param index index
+   *
+   * @return byte
+   */
+  inline reference operator[](size_type index) noexcept {
+    return data_[index];
+  }
+
+  /**
+   * Get byte (const)
+   *
+   * @param index index
+   *
+   * @return byte
+   */
+  inline const_reference operator[](size_type index) const noexcept {
+    return data_[index];
+  }
+
+  /**
+   * Get byte with bounds checking
+   *
+   * @param index index
+   *
+   * @return byte
+   */
+  inline reference at(size_type index) {
+    if (index >= size_) {
+      throw std::out_of_range("adu_buffer index out of range");
+    }
+
+    return data_[index];
+  }
+
+  /**
+   * Get byte with bounds checking (const)
+   *
+   * @param index index
+   *
+   * @return byte
+   */
+  inline const_reference at(size_type index) const {
+    if (index >= size_) {
+      throw std::out_of_range("adu_buffer index out of range");
+    }
+
+    return data_[index];
+  }
+
+  inline reference       front() noexcept { return data_[0]; }
+  inline const_reference front() const noexcept { return data_[0]; }
+  inline reference       back() noexcept { return data_[size_ - 1]; }
+  inline const_reference back() const noexcept { return data_[size_ - 1]; }
+
+  /**
+   * Append byte
+   *
+   * @param value byte
+   */
+  inline void push_back(value_type value) {
+    check(size_ + 1);
+    data_[size_++] = value;
+  }
+
+  /**
+   * Remove last byte
+   */
+  inline void pop_back() noexcept { --size_; }
+
+  /**
+   * Insert range
+   *
+   * @param pos   insert position
+   * @param first begin of range, must not point into this buffer
+   * @param last  end of range
+   *
+   * @return iterator to the first inserted byte
+   */
+  template <typename iterator_t,
+            typename = std::enable_if_t<!std::is_integral_v<iterator_t>>>
+  iterator insert(const_iterator pos, iterator_t first, iterator_t last) {
+    auto count = static_cast<size_type>(std::distance(first, last));
+    auto at = open(pos, count);
+    std::copy(first, last, at);
+    return at;
+  }
+
+  /**
+   * Insert count copies of value
+   *
+   * @param pos   insert position
+   * @param count number of bytes
+   * @param value byte value
+   *
+   * @return iterator to the first inserted byte
+   */
+  iterator insert(const_iterator pos, size_type count, value_type value) {
+    auto at = open(pos, count);
+    std::memset(at, value, count);
+    return at;
+  }
+
+  /**
+   * Insert byte
+   *
+   * @param pos   insert position
+   * @param value byte value
+   *
+   * @return iterator to the inserted byte
+   */
+  iterator insert(const_iterator pos, value_type value) {
+    return insert(pos, 1, value);
+  }
+
+  /**
+   * Erase range
+   *
+   * @param first begin of range
+   * @param last  end of range
+   *
+   * @return iterator following the last erased byte
+   */
+  iterator erase(const_iterator first, const_iterator last) noexcept {
+    auto at = data_ + (first - data_);
+    std::memmove(at, last, static_cast<size_type>(end() - last));
+    size_ -= static_cast<size_type>(last - first);
+    return at;
+  }
+
+  /**
+   * Resize, new bytes are zero
+   *
+   * @param count new size
+   */
+  inline void resize(size_type count) { resize(count, 0); }
+
+  /**
+   * Resize
+   *
+   * @param count new size
+   * @param value value of new bytes
+   */
+  void resize(size_type count, value_type value) {
+    check(count);
+
+    if (count > size_) {
+      std::memset(data_ + size_, value, count - size_);
+    }
+
+    size_ = count;
+  }
+
+  /**
+   * Remove every byte
+   */
+  inline void clear() noexcept { size_ = 0; }
+
+  /**
+   * Equal-to operator
+   *
+   * @param other other buffer
+   *
+   * @return true if same bytes
+   */
+  inline bool operator==(const adu_buffer& other) const noexcept {
+    return size_ == other.size_ && std::memcmp(data_, other.data_, size_) == 0;
+  }
+
+  /**
+   * Not-equal-to operator
+   *
+   * @param other other buffer
+   *
+   * @return true if different bytes
+   */
+  inline bool operator!=(const adu_buffer& other) const noexcept {
+    return !(*this == other);
+  }
+
+private:
+  /**
+   * Throw if size exceeds capacity
+   *
+   * @param count requested size
+   */
+  inline static void check(size_type count) {
+    if (count > max_capacity) {
+      throw std::length_error("ADU exceeds max ADU length");
+    }
+  }
+
+  /**
+   * Open gap of count bytes at position
+   *
+   * @param pos   gap position
+   * @param count gap size
+   *
+   * @return pointer to the gap
+   */
+  pointer open(const_iterator pos, size_type count) {
+    check(size_ + count);
+    auto at = data_ + (pos - data_);
+    std::memmove(at + count, at, static_cast<size_type>(end() - pos));
+    size_ += count;
+    return at;
+  }
+
+private:
+  /**
+   * Number of used bytes
+   */
+  size_type size_;
+  /**
+   * Storage
+   */
+  value_type data_[max_capacity];
+};
+}  // namespace modbus
+
+#endif  // LIB_MODBUS_MODBUS_ADU_BUFFER_HPP_
@@ -289,6 +289,13 @@ protected:
    */
   void decode_header(const packet_t& packet);
 
+  /**
+   * Decode packet header in place
+   *
+   * @param packet packet to be decoded
+   */
+  void decode_header(std::string_view packet);
+
   /**
    * Get header packet
    *
@@ -310,6 +317,19 @@ protected:
   }
 
 public:
+  /**
+   * Get size of the first ADU in a stream of received bytes
+   *
+   * TCP does not keep request boundaries, so one read may hold several
+   * requests or part of one. The size comes from the MBAP length field.
+   *
+   * @param stream received bytes
+   *
+   * @return size of first ADU, 0 if more bytes are needed, the whole stream
+   *         if the length field is invalid
+   */
+  static std::size_t frame_size(std::string_view stream) noexcept;
+
   /**
    * Header length
    */
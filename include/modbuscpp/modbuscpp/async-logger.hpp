@@ -0,0 +1,330 @@
+#ifndef LIB_MODBUS_MODBUS_ASYNC_LOGGER_HPP_
+#define LIB_MODBUS_MODBUS_ASYNC_LOGGER_HPP_
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "log-record.hpp"
+#include "logger.hpp"
+
+namespace modbus {
+/**
+ * @brief asynchronous logger
+ *
+ * @author  Ray Andrew
+ * @ingroup Modbus
+ *
+ * Logging threads capture the format string and arguments into a
+ * per-thread single-producer / single-consumer ring and return
+ * immediately. A background thread formats and writes the records with a
+ * token bucket rate limit. Only FMT_STRING formats are deferred, other
+ * formats are formatted on the calling thread before being queued.
+ *
+ * Logging never blocks: a message is dropped (and counted) when the ring
+ * of the calling thread is full or the rate limit is exceeded. The number
+ * of dropped messages is reported periodically.
+ *
+ * Usage:
+ * modbus::logger::create<modbus::async_logger>();
+ */
+class async_logger : public logger {
+public:
+  /**
+   * Initializer
+   */
+  struct initializer_t {
+    /**
+     * Debug status
+     */
+    bool debug = false;
+    /**
+     * Records per thread ring (rounded up to power of two)
+     */
+    std::size_t ring_size = 1024;
+    /**
+     * Max messages written per second, 0 to disable rate limiting
+     */
+    std::uint32_t max_rate = 1000;
+    /**
+     * Max messages written in a burst
+     */
+    std::uint32_t burst = 100;
+    /**
+     * Background thread polling interval
+     */
+    std::chrono::milliseconds interval = std::chrono::milliseconds(10);
+  };
+
+  /**
+   * Async logger constructor
+   */
+  explicit async_logger();
+
+  /**
+   * Async logger constructor
+   *
+   * @param initializer initializer
+   */
+  explicit async_logger(const initializer_t& initializer);
+
+  /**
+   * Async logger destructor, calls stop()
+   */
+  virtual ~async_logger() override;
+
+  /**
+   * Write every pending record now
+   */
+  void flush();
+
+  /**
+   * Stop background thread and write pending records
+   *
+   * Classes overriding write() must call this in their destructor, the
+   * base destructor can no longer reach the override
+   */
+  void stop();
+
+  /**
+   * Get number of dropped messages
+   *
+   * @return number of dropped messages
+   */
+  inline std::uint64_t dropped() const noexcept { return dropped_.load(); }
+
+  /**
+   * Get number of written messages
+   *
+   * @return number of written messages
+   */
+  inline std::uint64_t written() const noexcept { return written_.load(); }
+
+protected:
+  /**
+   * Write formatted message, called from the background thread
+   *
+   * @param lvl     level
+   * @param message message to write
+   */
+  virtual void write(level lvl, const std::string& message) const noexcept;
+
+  /**
+   * Queue info message
+   *
+   * @param message message to log
+   */
+  virtual void info_impl(const std::string& message) const noexcept override;
+
+  /**
+   * Queue error message
+   *
+   * @param message message to log
+   */
+  virtual void error_impl(const std::string& message) const noexcept override;
+
+  /**
+   * Queue debug message
+   *
+   * @param message message to log
+   */
+  virtual void debug_impl(const std::string& message) const noexcept override;
+
+  /**
+   * Get free record in ring of calling thread
+   *
+   * @return record, nullptr if ring is full
+   */
+  virtual internal::log_record* acquire() const noexcept override;
+
+  /**
+   * Publish record to background thread
+   *
+   * @param record record returned by acquire()
+   */
+  virtual void commit(internal::log_record* record) const noexcept override;
+
+private:
+  /**
+   * Single-producer / single-consumer ring of records
+   */
+  class ring {
+  public:
+    /**
+     * Ring constructor
+     *
+     * @param size capacity, power of two
+     */
+    explicit ring(std::size_t size);
+
+    /**
+     * Get free slot (producer)
+     *
+     * @return slot, nullptr if ring is full
+     */
+    internal::log_record* acquire() noexcept;
+
+    /**
+     * Publish slot returned by acquire() (producer)
+     */
+    void commit() noexcept;
+
+    /**
+     * Get oldest record (consumer)
+     *
+     * @return record, nullptr if ring is empty
+     */
+    const internal::log_record* front() const noexcept;
+
+    /**
+     * Release oldest record (consumer)
+     */
+    void pop() noexcept;
+
+    /**
+     * Mark ring as retired, called when the producer thread exits
+     */
+    void retire() noexcept;
+
+    /**
+     * Check if producer thread exited
+     *
+     * @return true if retired
+     */
+    bool retired() const noexcept;
+
+  private:
+    /**
+     * Slots
+     */
+    std::vector<internal::log_record> slots_;
+    /**
+     * Index mask
+     */
+    const std::size_t mask_;
+    /**
+     * Consumer position
+     */
+    alignas(64) std::atomic<std::size_t> head_;
+    /**
+     * Producer position
+     */
+    alignas(64) std::atomic<std::size_t> tail_;
+    /**
+     * Producer thread exited
+     */
+    std::atomic<bool> retired_;
+  };
+
+  /**
+   * Get ring of calling thread, registering it on first use
+   *
+   * Each thread keeps its rings per instance id and retires them on exit,
+   * drain() releases retired rings once they are empty
+   *
+   * @return ring, nullptr if it cannot be allocated
+   */
+  ring* local_ring() const noexcept;
+
+  /**
+   * Queue formatted message
+   *
+   * @param lvl     level
+   * @param message message
+   */
+  void push(level lvl, const std::string& message) const noexcept;
+
+  /**
+   * Background thread
+   */
+  void run();
+
+  /**
+   * Format and write pending records
+   */
+  void drain();
+
+  /**
+   * Take token from rate limiter
+   *
+   * @param now current time
+   *
+   * @return true if message may be written
+   */
+  bool take_token(std::chrono::steady_clock::time_point now);
+
+private:
+  /**
+   * Initializer
+   */
+  initializer_t initializer_;
+  /**
+   * Instance id, distinguishes thread-local rings of different instances
+   */
+  const std::uint64_t id_;
+  /**
+   * Mutex guarding rings_
+   */
+  mutable std::mutex mutex_;
+  /**
+   * Mutex guarding drain()
+   */
+  std::mutex drain_mutex_;
+  /**
+   * Registered rings, shared with the producer threads
+   */
+  mutable std::vector<std::shared_ptr<ring>> rings_;
+  /**
+   * Rings being drained
+   */
+  std::vector<ring*> snapshot_;
+  /**
+   * Dropped messages
+   */
+  mutable std::atomic<std::uint64_t> dropped_;
+  /**
+   * Dropped messages already reported
+   */
+  std::uint64_t reported_;
+  /**
+   * Written messages
+   */
+  std::atomic<std::uint64_t> written_;
+  /**
+   * Rate limiter tokens
+   */
+  double tokens_;
+  /**
+   * Last rate limiter refill
+   */
+  std::chrono::steady_clock::time_point refilled_at_;
+  /**
+   * Format buffer
+   */
+  std::string buffer_;
+  /**
+   * Running
+   */
+  std::atomic<bool> running_;
+  /**
+   * Mutex for wake_
+   */
+  std::mutex wake_mutex_;
+  /**
+   * Wakes background thread on shutdown
+   */
+  std::condition_variable wake_;
+  /**
+   * Background thread
+   */
+  std::thread thread_;
+};
+}  // namespace modbus
+
+#endif  // LIB_MODBUS_MODBUS_ASYNC_LOGGER_HPP_
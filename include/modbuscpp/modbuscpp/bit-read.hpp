@@ -181,6 +181,38 @@ public:
    */
   virtual void decode_passed(const packet_t& packet) override;
 
+  /**
+   * Decode packet straight into caller-provided buffer
+   *
+   * Header is validated in place and packed bits (LSB of first byte is
+   * the first requested bit) are copied to output without going through
+   * bits()
+   *
+   * @param packet packet to decode
+   * @param output buffer to write packed bits to
+   * @param size   capacity of output (in bytes)
+   *
+   * @return number of bytes written
+   */
+  std::size_t decode_into(std::string_view packet,
+                          std::uint8_t*    output,
+                          std::size_t      size);
+
+  /**
+   * Decode packet straight into caller-provided buffer
+   *
+   * @param packet packet to decode
+   * @param output buffer to write packed bits to
+   * @param size   capacity of output (in bytes)
+   *
+   * @return number of bytes written
+   */
+  inline std::size_t decode_into(const packet_t& packet,
+                                 std::uint8_t*   output,
+                                 std::size_t     size) {
+    return decode_into({packet.data(), packet.size()}, output, size);
+  }
+
   /**
    * Dump to string
    *
@@ -200,7 +232,17 @@ public:
   /**
    * Get bits
    */
-  inline const block::bits::container_type& bits() const { return bits_; }
+  inline const block::bits::buffer_type& bits() const { return bits_; }
+
+private:
+  /**
+   * Validate byte count of stage passed packet
+   *
+   * @param packet packet to validate
+   *
+   * @return pointer to first packed byte in packet
+   */
+  const char* check_passed(std::string_view packet);
 
 private:
   /**
@@ -214,7 +256,7 @@ private:
   /**
    * Slice of data from block of bits from data table
    */
-  block::bits::container_type bits_;
+  block::bits::buffer_type bits_;
   /**
    * Struct format
    */
@@ -3,12 +3,14 @@
 
 #include "bit-read.hpp"
 
+#include <cstring>
 #include <exception>
 
 #include <struc.hpp>
 
 #include "exception.hpp"
 #include "logger.hpp"
+#include "memory-pool.hpp"
 #include "operation.hpp"
 #include "utilities.hpp"
 
@@ -45,8 +47,7 @@ packet_t base_read_bits<function_code>::encode() {
   calc_length(data_length);
   packet_t packet = header_packet();
   packet.reserve(header_length + 1 + data_length);
-  packet_t pdu = struc::pack(fmt::format(">{}", format), address_(), count_());
-  packet.insert(packet.end(), pdu.begin(), pdu.end());
+  utilities::pack_into(packet, format, address_(), count_());
   return packet;
 }
 
@@ -72,36 +73,67 @@ base_read_bits<function_code>::base_read_bits(
     const request::base_read_bits<function_code>* request,
     table*                                        data_table) noexcept
     : internal::response{function_code, request->header(), data_table},
-      request_{request} {
+      request_{request},
+      bits_(memory_pool::get()) {
   initialize({request_->transaction(), request_->unit()});
 }
 
 template <constants::function_code function_code>
-void base_read_bits<function_code>::decode_passed(const packet_t& packet) {
-  try {
-    if (packet.size() != request_->response_size()) {
-      throw ex::bad_data();
-    }
+const char* base_read_bits<function_code>::check_passed(
+    std::string_view packet) {
+  if (packet.size() != request_->response_size()) {
+    throw ex::bad_data();
+  }
 
-    packet_t::size_type byte_idx = header_length + 1;
-    count_ = static_cast<std::uint16_t>(packet[byte_idx]);
+  packet_t::size_type byte_idx = header_length + 1;
+  count_ = static_cast<std::uint8_t>(packet[byte_idx]);
 
-    if (count_ != request_->count().get()) {
-      throw ex::bad_data();
-    }
+  if (count_ != request_->byte_count()) {
+    throw ex::bad_data();
+  }
+
+  return packet.data() + byte_idx + 1;
+}
+
+template <constants::function_code function_code>
+void base_read_bits<function_code>::decode_passed(const packet_t& packet) {
+  try {
+    const char* values = check_passed({packet.data(), packet.size()});
+    auto        begin = packet.begin() + (values - packet.data());
 
-    block::bits::container_type buffer
-        = op::unpack_bits(packet.begin() + byte_idx + 1, packet.end());
+    block::bits::buffer_type buffer
+        = op::unpack_bits(begin, begin + count_, bits_.get_allocator());
 
-    if (buffer.size() != request_->count().get()) {
+    if (buffer.size() < request_->count().get()) {
       throw ex::bad_data();
     }
 
+    buffer.resize(request_->count().get());
     bits_.swap(buffer);
   } catch (...) {
     throw ex::bad_data();
   }
 }
+
+template <constants::function_code function_code>
+std::size_t base_read_bits<function_code>::decode_into(std::string_view packet,
+                                                       std::uint8_t*    output,
+                                                       std::size_t      size) {
+  const std::size_t count = request_->byte_count();
+
+  if (output == nullptr || size < count) {
+    throw ex::bad_data_size();
+  }
+
+  try {
+    check(packet);
+  } catch (const std::out_of_range&) {
+    throw ex::bad_data();
+  }
+
+  std::memcpy(output, check_passed(packet), count);
+  return count;
+}
 }  // namespace response
 }  // namespace modbus
 
@@ -162,6 +162,17 @@ public:
       const write_num_bits_t&                       count = write_num_bits_t{},
       std::initializer_list<block::bits::data_type> values = {}) noexcept;
 
+  /**
+   * request::write_multiple_coils constructor
+   *
+   * @param address    output address
+   * @param count      count
+   * @param values     coil values
+   */
+  explicit write_multiple_coils(const address_t&            address,
+                                const write_num_bits_t&     count,
+                                block::bits::container_type values) noexcept;
+
   /**
    *
    * Encode write single_coil packet from given data
@@ -230,7 +241,7 @@ public:
    *
    * @return value
    */
-  inline const block::bits::container_type& values() const { return values_; }
+  inline const block::bits::buffer_type& values() const { return values_; }
 
 private:
   /**
@@ -254,7 +265,7 @@ private:
   /**
    * Value
    */
-  block::bits::container_type values_;
+  block::bits::buffer_type values_;
   /**
    * Byte count
    */
@@ -149,6 +149,44 @@ inline constexpr const char* function_code_str(constants::function_code code) {
       return "Unknown";
   }
 }
+
+inline constexpr const char* exception_code_str(
+    constants::exception_code code) {
+  switch (code) {
+    case constants::exception_code::illegal_function:
+      return "illegal function";
+    case constants::exception_code::illegal_data_address:
+      return "illegal data address";
+    case constants::exception_code::illegal_data_value:
+      return "illegal data value";
+    case constants::exception_code::server_device_failure:
+      return "server device failure";
+    case constants::exception_code::acknowledge:
+      return "acknowledge";
+    case constants::exception_code::server_device_busy:
+      return "server device busy";
+    case constants::exception_code::negative_acknowledge:
+      return "negative acknowledge";
+    case constants::exception_code::memory_parity_error:
+      return "memory parity error";
+    case constants::exception_code::gateway_path_unavailable:
+      return "gateway path unavailable";
+    case constants::exception_code::gateway_target_device_failed_to_respond:
+      return "gateway target device failed to respond";
+    case constants::exception_code::bad_data:
+      return "bad data";
+    case constants::exception_code::bad_data_size:
+      return "bad data size";
+    case constants::exception_code::connection_problem:
+      return "connection problem";
+    case constants::exception_code::bad_exception:
+      return "bad exception";
+    case constants::exception_code::no_exception:
+      return "no exception";
+    default:
+      return "Unknown";
+  }
+}
 }  // namespace modbus
 
 #endif  // LIB_MODBUS_MODBUS_CONSTANTS_HPP_
@@ -3,11 +3,13 @@
 
 #include <cstdlib>
 #include <memory>
-#include <shared_mutex>
+#include <memory_resource>
 #include <type_traits>
 #include <utility>
 #include <vector>
 
+#include "access-heatmap.hpp"
+#include "instrumented-mutex.hpp"
 #include "types.hpp"
 #include "utilities.hpp"
 
@@ -60,6 +62,12 @@ public:
    */
   typedef base_container_t<data_type> container_type;
 
+  /**
+   * Buffer type of request and response values, allocated from
+   * memory_pool by requests and responses
+   */
+  typedef std::pmr::vector<data_type> buffer_type;
+
   /**
    * Mutable iterator type
    */
@@ -254,6 +262,41 @@ public:
    */
   inline virtual size_type capacity() const { return capacity_; }
 
+  /**
+   * Get access heatmap
+   *
+   * @return access heatmap
+   */
+  inline access_heatmap& heatmap() { return heatmap_; }
+
+  /**
+   * Get access heatmap (const)
+   *
+   * @return access heatmap (const)
+   */
+  inline const access_heatmap& heatmap() const { return heatmap_; }
+
+  /**
+   * Enable or disable lock instrumentation
+   *
+   * @param enabled instrumentation status
+   */
+  inline void instrument_lock(bool enabled) noexcept {
+    mutex_.instrument(enabled);
+  }
+
+  /**
+   * Get lock stats
+   *
+   * @return lock stats, zero unless instrumented
+   */
+  inline lock_stats_t lock_stats() const { return mutex_.stats(); }
+
+  /**
+   * Reset lock stats
+   */
+  inline void reset_lock_stats() noexcept { mutex_.reset_stats(); }
+
   /**
    * Ostream operator
    *
@@ -271,9 +314,10 @@ public:
 
 protected:
   /**
-   * Mutex
+   * Mutex, get() locks as reader and set() / reset() as writer (both
+   * exclusively)
    */
-  mutable std::shared_mutex mutex_;
+  mutable instrumented_mutex mutex_;
   /**
    * Starting address of container
    */
@@ -290,6 +334,10 @@ protected:
    * Default value
    */
   const data_t default_value_;
+  /**
+   * Access heatmap
+   */
+  access_heatmap heatmap_;
 };
 
 /**
@@ -317,6 +365,12 @@ public:
   using typename base<std::vector, data_t, read_count_t, write_count_t>::
       container_type;
 
+  /**
+   * Buffer type
+   */
+  using typename base<std::vector, data_t, read_count_t, write_count_t>::
+      buffer_type;
+
   /**
    * Mutable iterator type
    */
@@ -469,6 +523,16 @@ public:
   virtual void set(const address_t&      address,
                    const container_type& container) override;
 
+  /**
+   * Set slice of data from iterator range (e.g. of buffer_type)
+   *
+   * @param address starting address
+   * @param begin   begin of values
+   * @param end     end of values
+   */
+  template <typename iterator_t>
+  void set(const address_t& address, iterator_t begin, iterator_t end);
+
   /**
    * Set single data to container at specific address
    *
@@ -502,6 +566,28 @@ public:
    */
   using base<std::vector, data_t, read_count_t, write_count_t>::default_value;
 
+  /**
+   * Access heatmap getter
+   */
+  using base<std::vector, data_t, read_count_t, write_count_t>::heatmap;
+
+  /**
+   * Lock instrumentation
+   */
+  using base<std::vector, data_t, read_count_t, write_count_t>::
+      instrument_lock;
+
+  /**
+   * Lock stats getter
+   */
+  using base<std::vector, data_t, read_count_t, write_count_t>::lock_stats;
+
+  /**
+   * Lock stats reset
+   */
+  using base<std::vector, data_t, read_count_t, write_count_t>::
+      reset_lock_stats;
+
   /**
    * Validation with read_count_t
    */
@@ -596,6 +682,28 @@ public:
     block::registers::initializer_t input_registers;
   };
 
+  /**
+   * Lock stats of every block
+   */
+  struct lock_stats_t {
+    /**
+     * Coils lock stats
+     */
+    modbus::lock_stats_t coils;
+    /**
+     * Discrete inputs lock stats
+     */
+    modbus::lock_stats_t discrete_inputs;
+    /**
+     * Holding registers lock stats
+     */
+    modbus::lock_stats_t holding_registers;
+    /**
+     * Input registers lock stats
+     */
+    modbus::lock_stats_t input_registers;
+  };
+
   /**
    * Table constructor
    * @param initializer initializer factory
@@ -667,6 +775,32 @@ public:
     return input_registers_;
   }
 
+  /**
+   * Enable or disable lock instrumentation of every block
+   *
+   * @param enabled instrumentation status
+   */
+  void instrument_locks(bool enabled) noexcept;
+
+  /**
+   * Get lock stats of every block
+   *
+   * @return lock stats, zero unless instrumented
+   */
+  lock_stats_t lock_stats() const;
+
+  /**
+   * Reset lock stats of every block
+   */
+  void reset_lock_stats() noexcept;
+
+  /**
+   * Enable or disable access heatmap of every block
+   *
+   * @param enabled recording status
+   */
+  void enable_heatmap(bool enabled) noexcept;
+
 private:
   /**
    * Coils
@@ -24,7 +24,8 @@ inline base<base_container_t, data_t, read_count_t, write_count_t>::base(
     : starting_address_{std::move(starting_address)},
       container_(capacity, default_value),
       capacity_{capacity},
-      default_value_{default_value} {}
+      default_value_{default_value},
+      heatmap_{starting_address, capacity} {}
 
 template <template <class...> class base_container_t,
           typename data_t,
@@ -36,7 +37,8 @@ inline base<base_container_t, data_t, read_count_t, write_count_t>::base(
     : starting_address_{std::move(starting_address)},
       container_(std::move(container)),
       capacity_{container.size()},
-      default_value_{0} {}
+      default_value_{0},
+      heatmap_{starting_address, container.size()} {}
 
 template <template <class...> class base_container_t,
           typename data_t,
@@ -143,7 +145,7 @@ template <typename data_t, typename read_count_t, typename write_count_t> inline
     sequential<data_t, read_count_t, write_count_t>::get(
         const address_t&    address,
         const read_count_t& count) const {
-  std::lock_guard<std::shared_mutex> lock(mutex_);
+  instrumented_lock<access::read> lock(mutex_);
   if (!validate(address, count)) {
     throw ex::out_of_range("Address and count are not valid");
   }
@@ -157,7 +159,7 @@ template <typename data_t, typename read_count_t, typename write_count_t> inline
         const_data_reference
         sequential<data_t, read_count_t, write_count_t>::get(
             const address_t& address) const {
-  std::lock_guard<std::shared_mutex> lock(mutex_);
+  instrumented_lock<access::read> lock(mutex_);
   if (!validate(address)) {
     throw ex::out_of_range("Address is not valid");
   }
@@ -170,13 +172,24 @@ template <typename data_t, typename read_count_t, typename write_count_t>
 inline void sequential<data_t, read_count_t, write_count_t>::set(
     const address_t&      address,
     const container_type& buffer) {
-  std::lock_guard<std::shared_mutex> lock(mutex_);
-  if (!validate_sz(address, buffer.size())) {
+  set(address, buffer.begin(), buffer.end());
+}
+
+template <typename data_t, typename read_count_t, typename write_count_t>
+template <typename iterator_t>
+inline void sequential<data_t, read_count_t, write_count_t>::set(
+    const address_t& address,
+    iterator_t       begin,
+    iterator_t       end) {
+  auto size = static_cast<size_type>(std::distance(begin, end));
+
+  instrumented_lock<access::write> lock(mutex_);
+  if (!validate_sz(address, size)) {
     throw ex::out_of_range("Starting address is not valid");
   }
 
   address_t idx = address - starting_address();
-  std::transform(buffer.begin(), buffer.end(), container().begin() + idx(),
+  std::transform(begin, end, container().begin() + idx(),
                  [](const auto& data) -> data_t { return data; });
 }
 
@@ -184,7 +197,7 @@ template <typename data_t, typename read_count_t, typename write_count_t>
 inline void sequential<data_t, read_count_t, write_count_t>::set(
     const address_t& address,
     data_t           value) {
-  std::lock_guard<std::shared_mutex> lock(mutex_);
+  instrumented_lock<access::write> lock(mutex_);
   if (!validate(address)) {
     throw ex::out_of_range("Starting address is not valid");
   }
@@ -195,7 +208,7 @@ inline void sequential<data_t, read_count_t, write_count_t>::set(
 
 template <typename data_t, typename read_count_t, typename write_count_t>
 inline void sequential<data_t, read_count_t, write_count_t>::reset() {
-  std::lock_guard<std::shared_mutex> lock(mutex_);
+  instrumented_lock<access::write> lock(mutex_);
   std::fill(container().begin(), container().end(), default_value());
 }
 }  // namespace block
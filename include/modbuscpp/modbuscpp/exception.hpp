@@ -257,6 +257,46 @@ inline auto generate_exception(constants::exception_code ec,
       return ex::bad_exception();
   }
 }
+
+/**
+ * Throw exception matching the exception code
+ *
+ * Unlike generate_exception(), the thrown object keeps its type, so callers
+ * can catch e.g. ex::illegal_data_address
+ *
+ * @param ec             exception code
+ * @param function       function code
+ * @param request_header request header
+ */
+[[noreturn]] inline void throw_exception(constants::exception_code ec,
+                                         constants::function_code  function,
+                                         const header_t& request_header) {
+  switch (ec) {
+    case constants::exception_code::illegal_function:
+      throw ex::illegal_function(function, request_header);
+    case constants::exception_code::illegal_data_address:
+      throw ex::illegal_data_address(function, request_header);
+    case constants::exception_code::illegal_data_value:
+      throw ex::illegal_data_value(function, request_header);
+    case constants::exception_code::server_device_failure:
+      throw ex::server_device_failure(function, request_header);
+    case constants::exception_code::acknowledge:
+      throw ex::acknowledge(function, request_header);
+    case constants::exception_code::server_device_busy:
+      throw ex::server_device_busy(function, request_header);
+    case constants::exception_code::negative_acknowledge:
+      throw ex::negative_acknowledge(function, request_header);
+    case constants::exception_code::memory_parity_error:
+      throw ex::memory_parity_error(function, request_header);
+    case constants::exception_code::gateway_path_unavailable:
+      throw ex::gateway_path_unavailable(function, request_header);
+    case constants::exception_code::gateway_target_device_failed_to_respond:
+      throw ex::gateway_target_device_failed_to_respond(function,
+                                                        request_header);
+    default:
+      throw ex::bad_exception();
+  }
+}
 }  // namespace modbus
 
 #endif  // LIB_MODBUS_MODBUS_EXCEPTION_HPP_
@@ -0,0 +1,268 @@
+#ifndef LIB_MODBUS_MODBUS_LOG_RECORD_HPP_
+#define LIB_MODBUS_MODBUS_LOG_RECORD_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include <fmt/format.h>
+
+namespace modbus {
+namespace internal {
+/**
+ * @brief compile-time format string check
+ *
+ * True for FMT_STRING formats, the only formats known to outlive the call
+ *
+ * @tparam S format string type
+ */
+#if FMT_VERSION >= 80000
+template <typename S> using is_log_literal = fmt::detail::is_compile_string<S>;
+#else
+template <typename S> using is_log_literal = fmt::is_compile_string<S>;
+#endif
+
+/**
+ * @brief string stored in the spare storage of a log record
+ */
+struct log_string {
+  /**
+   * Offset in record storage
+   */
+  std::uint16_t offset;
+  /**
+   * Size
+   */
+  std::uint16_t size;
+};
+
+/**
+ * @brief how an argument is kept in a log record
+ *
+ * Arithmetic and enum values are copied as is, strings are copied into the
+ * spare storage of the record, anything else is not deferrable and is
+ * formatted eagerly
+ *
+ * @tparam T argument type
+ */
+template <typename T, typename = void> struct log_arg {
+  /**
+   * Deferrable
+   */
+  static constexpr bool deferrable = false;
+  /**
+   * Stored type
+   */
+  typedef char type;
+};
+
+template <typename T> struct log_arg<
+    T,
+    std::enable_if_t<std::is_arithmetic_v<T> || std::is_enum_v<T>>> {
+  static constexpr bool deferrable = true;
+  typedef T             type;
+
+  inline static std::size_t extra_size(const T&) noexcept { return 0; }
+
+  inline static void store(type&                           out,
+                           [[maybe_unused]] unsigned char* storage,
+                           [[maybe_unused]] std::size_t&   offset,
+                           const T&                        value) noexcept {
+    out = value;
+  }
+
+  inline static const type& load(
+      const type&                           value,
+      [[maybe_unused]] const unsigned char* storage) noexcept {
+    return value;
+  }
+};
+
+template <typename T> struct log_arg<
+    T,
+    std::enable_if_t<std::is_same_v<T, std::string>
+                     || std::is_same_v<T, std::string_view>
+                     || std::is_same_v<T, const char*>
+                     || std::is_same_v<T, char*>>> {
+  static constexpr bool deferrable = true;
+  typedef log_string    type;
+
+  inline static std::size_t extra_size(std::string_view value) noexcept {
+    return value.size();
+  }
+
+  inline static void store(type&            out,
+                           unsigned char*   storage,
+                           std::size_t&     offset,
+                           std::string_view value) noexcept {
+    std::memcpy(storage + offset, value.data(), value.size());
+    out.offset = static_cast<std::uint16_t>(offset);
+    out.size = static_cast<std::uint16_t>(value.size());
+    offset += value.size();
+  }
+
+  inline static std::string_view load(const type&          value,
+                                      const unsigned char* storage) noexcept {
+    return {reinterpret_cast<const char*>(storage) + value.offset, value.size};
+  }
+};
+
+/**
+ * @brief log message captured on the calling thread
+ *
+ * @author  Ray Andrew
+ * @ingroup Modbus/Internal
+ *
+ * Holds the format string and arguments in binary form so formatting can
+ * run on another thread. Only FMT_STRING formats are deferred, anything
+ * else (or arguments that cannot be captured or do not fit) is formatted
+ * on the calling thread instead.
+ */
+struct log_record {
+  /**
+   * Storage size
+   */
+  static constexpr std::size_t storage_size = 224;
+
+  /**
+   * Marker appended to messages cut to the storage size
+   */
+  static constexpr std::string_view cut_marker = "...";
+
+  /**
+   * Format function type
+   */
+  typedef void (*format_t)(const log_record& record, std::string& out);
+
+  /**
+   * Capture format string and arguments
+   *
+   * @tparam FormatString string format type
+   * @tparam Args         arguments type
+   *
+   * @param  fmt          string format
+   * @param  args         arguments
+   */
+  template <typename FormatString, typename... Args>
+  inline void pack(const FormatString& fmt, const Args&... args) {
+    typedef std::tuple<typename log_arg<std::decay_t<Args>>::type...> tuple_t;
+
+    if constexpr (is_log_literal<FormatString>::value
+                  && (log_arg<std::decay_t<Args>>::deferrable && ...)
+                  && sizeof(tuple_t) <= storage_size
+                  && alignof(tuple_t) <= alignof(std::max_align_t)) {
+      static_assert(std::is_trivially_destructible_v<tuple_t>);
+      std::size_t offset = sizeof(tuple_t);
+
+      // strings go after the tuple, format eagerly when they do not fit
+      if ((offset + ... + log_arg<std::decay_t<Args>>::extra_size(args))
+          <= storage_size) {
+        auto* stored = new (storage) tuple_t{};
+        store(*stored, offset, std::index_sequence_for<Args...>{}, args...);
+        format = &format_tuple<tuple_t, std::decay_t<Args>...>;
+        format_str = fmt;
+        return;
+      }
+    }
+
+    pack(std::string_view{fmt::format(fmt, args...)});
+  }
+
+  /**
+   * Capture formatted message, cut to storage size and marked with
+   * cut_marker when longer
+   *
+   * @param message message
+   */
+  inline void pack(std::string_view message) noexcept {
+    typedef std::tuple<log_string> tuple_t;
+
+    constexpr std::size_t capacity = storage_size - sizeof(tuple_t);
+    std::size_t           offset = sizeof(tuple_t);
+    auto*                 stored = new (storage) tuple_t{};
+    auto&                 text = std::get<0>(*stored);
+    bool                  cut = message.size() > capacity;
+
+    if (cut) {
+      message = message.substr(0, capacity - cut_marker.size());
+    }
+
+    log_arg<std::string_view>::store(text, storage, offset, message);
+
+    if (cut) {
+      std::memcpy(storage + offset, cut_marker.data(), cut_marker.size());
+      text.size = static_cast<std::uint16_t>(capacity);
+    }
+
+    format = &format_string;
+    format_str = {};
+  }
+
+  /**
+   * Format captured message
+   *
+   * @param out string to append to
+   */
+  inline void to_string(std::string& out) const { format(*this, out); }
+
+  /**
+   * Format function
+   */
+  format_t format;
+  /**
+   * Format string (FMT_STRING literal)
+   */
+  fmt::string_view format_str;
+  /**
+   * Level
+   */
+  std::uint8_t level;
+  /**
+   * Captured arguments
+   */
+  alignas(std::max_align_t) unsigned char storage[storage_size];
+
+private:
+  template <typename tuple_t, std::size_t... I, typename... Args>
+  inline void store(tuple_t&     stored,
+                    std::size_t& offset,
+                    std::index_sequence<I...>,
+                    const Args&... args) noexcept {
+    (log_arg<std::decay_t<Args>>::store(std::get<I>(stored), storage, offset,
+                                        args),
+     ...);
+  }
+
+  template <typename tuple_t, typename... Args, std::size_t... I>
+  inline static void format_args(const log_record& record,
+                                 std::string&      out,
+                                 std::index_sequence<I...>) {
+    const auto& stored = *reinterpret_cast<const tuple_t*>(record.storage);
+    out += fmt::vformat(record.format_str,
+                        fmt::make_format_args(log_arg<Args>::load(
+                            std::get<I>(stored), record.storage)...));
+  }
+
+  template <typename tuple_t, typename... Args>
+  static void format_tuple(const log_record& record, std::string& out) {
+    format_args<tuple_t, Args...>(record, out,
+                                  std::index_sequence_for<Args...>{});
+  }
+
+  static void format_string(const log_record& record, std::string& out) {
+    const auto& stored
+        = *reinterpret_cast<const std::tuple<log_string>*>(record.storage);
+    out += log_arg<std::string_view>::load(std::get<0>(stored),
+                                           record.storage);
+  }
+};
+}  // namespace internal
+}  // namespace modbus
+
+#endif  // LIB_MODBUS_MODBUS_LOG_RECORD_HPP_
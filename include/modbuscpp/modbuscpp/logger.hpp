@@ -9,9 +9,38 @@
 
 #include <fmt/format.h>
 
+#include "log-record.hpp"
+
+/**
+ * @def MODBUSCPP_LOG_LEVEL
+ *
+ * Compile-time minimum log level
+ *
+ * Messages below this level are compiled out, e.g. build with
+ * -DMODBUSCPP_LOG_LEVEL=MODBUSCPP_LOG_LEVEL_INFO to remove every debug call
+ * from the hot path
+ */
+#define MODBUSCPP_LOG_LEVEL_DEBUG 0
+#define MODBUSCPP_LOG_LEVEL_INFO 1
+#define MODBUSCPP_LOG_LEVEL_ERROR 2
+#define MODBUSCPP_LOG_LEVEL_OFF 3
+
+#ifndef MODBUSCPP_LOG_LEVEL
+#  define MODBUSCPP_LOG_LEVEL MODBUSCPP_LOG_LEVEL_DEBUG
+#endif
+
 namespace modbus {
 class logger : private boost::noncopyable {
 public:
+  /**
+   * Log level
+   */
+  enum class level : std::uint8_t {
+    debug,
+    info,
+    error,
+  };
+
   /**
    * Create singleton instance
    *
@@ -69,6 +98,21 @@ public:
    */
   inline void set_debug(bool debug__) noexcept { debug_ = debug__; }
 
+  /**
+   * Check if debug messages are logged
+   *
+   * Use to guard arguments that are expensive to compute
+   *
+   * @return true if debug is compiled in and enabled
+   */
+  inline static bool debug_enabled() noexcept {
+    if constexpr (debug_level) {
+      return get()->debug_;
+    } else {
+      return false;
+    }
+  }
+
   /**
    * Log info message to stdout
    *
@@ -80,7 +124,9 @@ public:
    */
   template <typename FormatString, typename... Args>
   inline static void info(const FormatString& fmt, Args&&... args) {
-    get()->info_impl(fmt, std::forward<Args>(args)...);
+    if constexpr (info_level) {
+      get()->info_impl(fmt, std::forward<Args>(args)...);
+    }
   }
 
   /**
@@ -94,7 +140,9 @@ public:
    */
   template <typename FormatString, typename... Args>
   inline static void error(const FormatString& fmt, Args&&... args) {
-    get()->error_impl(fmt, std::forward<Args>(args)...);
+    if constexpr (error_level) {
+      get()->error_impl(fmt, std::forward<Args>(args)...);
+    }
   }
 
   /**
@@ -108,7 +156,14 @@ public:
    */
   template <typename FormatString, typename... Args>
   inline static void debug(const FormatString& fmt, Args&&... args) {
-    get()->debug_impl(fmt, std::forward<Args>(args)...);
+    if constexpr (debug_level) {
+      auto* instance = get();
+
+      // check level before paying for fmt::format
+      if (instance->debug_) {
+        instance->debug_impl(fmt, std::forward<Args>(args)...);
+      }
+    }
   }
 
   /**
@@ -117,7 +172,9 @@ public:
    * @param message message to log
    */
   inline static void info(const std::string& message) noexcept {
-    get()->info_impl(message);
+    if constexpr (info_level) {
+      get()->info_impl(message);
+    }
   }
 
   /**
@@ -126,7 +183,9 @@ public:
    * @param message message to log
    */
   inline static void error(const std::string& message) noexcept {
-    get()->error_impl(message);
+    if constexpr (error_level) {
+      get()->error_impl(message);
+    }
   }
 
   /**
@@ -135,7 +194,13 @@ public:
    * @param message message to log
    */
   inline static void debug(const std::string& message) noexcept {
-    get()->debug_impl(message);
+    if constexpr (debug_level) {
+      auto* instance = get();
+
+      if (instance->debug_) {
+        instance->debug_impl(message);
+      }
+    }
   }
 
 protected:
@@ -150,7 +215,11 @@ protected:
    */
   template <typename FormatString, typename... Args>
   inline void info_impl(const FormatString& fmt, Args&&... args) const {
-    info_impl(fmt::format(fmt, std::forward<Args>(args)...));
+    if (deferred_) {
+      defer(level::info, fmt, args...);
+    } else {
+      info_impl(fmt::format(fmt, std::forward<Args>(args)...));
+    }
   }
 
   /**
@@ -162,7 +231,11 @@ protected:
    */
   template <typename FormatString, typename... Args>
   inline void error_impl(const FormatString& fmt, Args&&... args) const {
-    error_impl(fmt::format(fmt, std::forward<Args>(args)...));
+    if (deferred_) {
+      defer(level::error, fmt, args...);
+    } else {
+      error_impl(fmt::format(fmt, std::forward<Args>(args)...));
+    }
   }
 
   /**
@@ -176,7 +249,11 @@ protected:
    */
   template <typename FormatString, typename... Args>
   inline void debug_impl(const FormatString& fmt, Args&&... args) const {
-    debug_impl(fmt::format(fmt, std::forward<Args>(args)...));
+    if (deferred_) {
+      defer(level::debug, fmt, args...);
+    } else {
+      debug_impl(fmt::format(fmt, std::forward<Args>(args)...));
+    }
   }
 
   /**
@@ -200,11 +277,71 @@ protected:
    */
   virtual void debug_impl(const std::string& message) const noexcept;
 
+  /**
+   * Capture message into a record that is formatted later
+   *
+   * @tparam FormatString string format type
+   * @tparam Args         arguments type
+   *
+   * @param  lvl          level
+   * @param  fmt          string format
+   * @param  args         arguments
+   */
+  template <typename FormatString, typename... Args>
+  inline void defer(level               lvl,
+                    const FormatString& fmt,
+                    const Args&... args) const {
+    if (auto* record = acquire()) {
+      record->level = static_cast<std::uint8_t>(lvl);
+      record->pack(fmt, args...);
+      commit(record);
+    }
+  }
+
+  /**
+   * Get free record of calling thread, only used when deferred_ is set
+   *
+   * @return record, nullptr to drop the message
+   */
+  inline virtual internal::log_record* acquire() const noexcept {
+    return nullptr;
+  }
+
+  /**
+   * Publish record returned by acquire()
+   *
+   * @param record record to publish
+   */
+  inline virtual void commit(
+      [[maybe_unused]] internal::log_record* record) const noexcept {}
+
+protected:
+  /**
+   * Debug messages compiled in
+   */
+  static constexpr bool debug_level
+      = MODBUSCPP_LOG_LEVEL <= MODBUSCPP_LOG_LEVEL_DEBUG;
+  /**
+   * Info messages compiled in
+   */
+  static constexpr bool info_level
+      = MODBUSCPP_LOG_LEVEL <= MODBUSCPP_LOG_LEVEL_INFO;
+  /**
+   * Error messages compiled in
+   */
+  static constexpr bool error_level
+      = MODBUSCPP_LOG_LEVEL <= MODBUSCPP_LOG_LEVEL_ERROR;
+
 protected:
   /**
    * Debug
    */
   bool debug_;
+  /**
+   * Formatted messages are captured with defer() instead of formatted on
+   * the calling thread
+   */
+  bool deferred_;
 
 private:
   /**
@@ -0,0 +1,110 @@
+#ifndef LIB_MODBUS_MODBUS_MEMORY_POOL_HPP_
+#define LIB_MODBUS_MODBUS_MEMORY_POOL_HPP_
+
+#include <cstddef>
+#include <memory_resource>
+
+#include <boost/core/noncopyable.hpp>
+
+namespace modbus {
+/**
+ * @brief per-thread memory pool
+ *
+ * @author  Ray Andrew
+ * @ingroup Modbus
+ *
+ * Memory resource that recycles small blocks through free lists owned by
+ * the calling thread. Request / response objects and their buffers are
+ * bounded by the ADU length, so after warm-up every io thread serves them
+ * from its own lists without touching the global allocator or contending
+ * with the other io threads.
+ *
+ * Blocks are grouped in power-of-two size classes up to max_block_size.
+ * A block freed by another thread joins the free list of that thread; a
+ * list keeps at most max_cached blocks and returns the rest upstream.
+ * Larger or over-aligned blocks go straight upstream.
+ *
+ * The pool is stateless, every handle compares equal, so containers using
+ * it can be moved and swapped across threads.
+ *
+ * Usage:
+ * block::registers::buffer_type buffer(memory_pool::get());
+ */
+class memory_pool : public std::pmr::memory_resource,
+                    private boost::noncopyable {
+public:
+  /**
+   * Smallest size class
+   */
+  static constexpr std::size_t min_block_size = 16;
+
+  /**
+   * Largest size class, fits a full ADU worth of registers or bits
+   */
+  static constexpr std::size_t max_block_size = 512;
+
+  /**
+   * Max blocks cached per size class and thread
+   */
+  static constexpr std::size_t max_cached = 64;
+
+  /**
+   * Get pool
+   *
+   * @return pool
+   */
+  static memory_pool* get() noexcept;
+
+  /**
+   * Get number of blocks cached by the calling thread
+   *
+   * @return cached blocks
+   */
+  static std::size_t cached() noexcept;
+
+  /**
+   * Return blocks cached by the calling thread to the upstream allocator
+   */
+  static void release() noexcept;
+
+protected:
+  /**
+   * Allocate block
+   *
+   * @param bytes     block size
+   * @param alignment block alignment
+   *
+   * @return block
+   */
+  virtual void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+
+  /**
+   * Deallocate block
+   *
+   * @param ptr       block
+   * @param bytes     block size
+   * @param alignment block alignment
+   */
+  virtual void do_deallocate(void*       ptr,
+                             std::size_t bytes,
+                             std::size_t alignment) override;
+
+  /**
+   * Compare resources
+   *
+   * @param other other resource
+   *
+   * @return true if other is the memory pool
+   */
+  virtual bool do_is_equal(
+      const std::pmr::memory_resource& other) const noexcept override;
+
+private:
+  /**
+   * Memory pool constructor, use get()
+   */
+  memory_pool() noexcept = default;
+};
+}  // namespace modbus
+
+#endif  // LIB_MODBUS_MODBUS_MEMORY_POOL_HPP_
@@ -0,0 +1,130 @@
+#ifndef LIB_MODBUS_MODBUS_METRICS_SERVER_HPP_
+#define LIB_MODBUS_MODBUS_METRICS_SERVER_HPP_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include <boost/core/noncopyable.hpp>
+
+#include "asio2.hpp"
+
+#include "data-table.hpp"
+#include "server.hpp"
+#include "stats.hpp"
+#include "utilities.hpp"
+
+namespace modbus {
+/**
+ * @brief metrics endpoint
+ *
+ * @author  Ray Andrew
+ * @ingroup Modbus
+ *
+ * Minimal HTTP listener serving the stats of a modbus server in Prometheus
+ * text exposition format (version 0.0.4). Runs on its own io thread, so
+ * scraping never runs on (or blocks) the modbus io threads: the rendering
+ * only reads the relaxed per-thread counters.
+ *
+ * Usage:
+ * auto&& metrics = modbus::metrics_server::create(*server);
+ * metrics->run("127.0.0.1", "9502");
+ */
+class metrics_server : private boost::noncopyable {
+public:
+  /**
+   * Session pointer type
+   */
+  typedef std::shared_ptr<asio2::tcp_session> session_ptr_t;
+
+  /**
+   * Metrics server pointer
+   */
+  typedef std::unique_ptr<metrics_server> pointer;
+
+  /**
+   * Metrics server create
+   */
+  MAKE_STD_UNIQUE(metrics_server)
+
+public:
+  /**
+   * Metrics server constructor
+   *
+   * @param modbus_server modbus server to export, must outlive this instance
+   */
+  explicit metrics_server(server& modbus_server);
+
+  /**
+   * Metrics server destructor
+   */
+  ~metrics_server();
+
+  /**
+   * Run metrics server
+   *
+   * @param host host to listen to
+   * @param port port to listen to
+   */
+  void run(std::string_view host = "127.0.0.1",
+           std::string_view port = "9502");
+
+  /**
+   * Stop metrics server
+   */
+  void stop();
+
+  /**
+   * Render current stats of modbus server
+   *
+   * @return metrics in Prometheus text format
+   */
+  std::string render() const;
+
+  /**
+   * Render stats
+   *
+   * @param snapshot stats snapshot
+   * @param sessions number of active sessions
+   * @param locks    data table lock stats
+   *
+   * @return metrics in Prometheus text format
+   */
+  static std::string render(const modbus::stats::snapshot_t& snapshot,
+                            std::size_t                       sessions,
+                            const table::lock_stats_t&        locks);
+
+  /**
+   * Build HTTP response of request
+   *
+   * Only "GET /metrics" (and "GET /") renders the stats
+   *
+   * @param request raw HTTP request
+   *
+   * @return HTTP response, empty if the request line is incomplete
+   */
+  std::string respond(std::string_view request) const;
+
+private:
+  /**
+   * Receive callback
+   *
+   * @param session_ptr session pointer
+   * @param raw_request raw request
+   */
+  void on_receive(session_ptr_t& session_ptr, std::string_view raw_request);
+
+private:
+  /**
+   * Exported modbus server
+   */
+  server& server_;
+  /**
+   * HTTP listener
+   */
+  asio2::tcp_server http_;
+};
+}  // namespace modbus
+
+#endif  // LIB_MODBUS_MODBUS_METRICS_SERVER_HPP_
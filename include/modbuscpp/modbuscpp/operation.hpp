@@ -6,11 +6,75 @@
 
 namespace modbus {
 namespace op {
-packet_t pack_bits(const block::bits::container_type::const_iterator& begin,
-                   const block::bits::container_type::const_iterator& end);
+/**
+ * Pack bits into bytes, first bit in the LSB of the first byte
+ *
+ * @param begin begin of bits
+ * @param end   end of bits
+ *
+ * @return packed bytes
+ */
+packet_t pack_bits(const block::bits::buffer_type::const_iterator& begin,
+                   const block::bits::buffer_type::const_iterator& end);
 
-block::bits::container_type unpack_bits(const packet_t::const_iterator& begin,
-                                        const packet_t::const_iterator& end);
+/**
+ * Pack bits and append them to packet
+ *
+ * @param packet packet to append to
+ * @param begin  begin of bits
+ * @param end    end of bits
+ */
+void pack_bits(packet_t&                                          packet,
+               const block::bits::buffer_type::const_iterator& begin,
+               const block::bits::buffer_type::const_iterator& end);
+
+/**
+ * Unpack bytes into bits, 8 bits per byte starting from the LSB
+ *
+ * @param begin     begin of bytes
+ * @param end       end of bytes
+ * @param allocator allocator of result
+ *
+ * @return unpacked bits
+ */
+block::bits::buffer_type unpack_bits(
+    const packet_t::const_iterator&                     begin,
+    const packet_t::const_iterator&                     end,
+    const block::bits::buffer_type::allocator_type& allocator = {});
+
+/**
+ * Bit by bit reference implementations
+ *
+ * The functions above work on whole storage words of the bits container
+ * where the standard library exposes them (libstdc++) and fall back to
+ * these otherwise.
+ */
+namespace scalar {
+/**
+ * Pack bits and append them to packet, bit by bit
+ *
+ * @param packet packet to append to
+ * @param begin  begin of bits
+ * @param end    end of bits
+ */
+void pack_bits(packet_t&                                          packet,
+               const block::bits::buffer_type::const_iterator& begin,
+               const block::bits::buffer_type::const_iterator& end);
+
+/**
+ * Unpack bytes into bits, bit by bit
+ *
+ * @param begin     begin of bytes
+ * @param end       end of bytes
+ * @param allocator allocator of result
+ *
+ * @return unpacked bits
+ */
+block::bits::buffer_type unpack_bits(
+    const packet_t::const_iterator&                     begin,
+    const packet_t::const_iterator&                     end,
+    const block::bits::buffer_type::allocator_type& allocator = {});
+}  // namespace scalar
 }  // namespace op
 }  // namespace modbus
 
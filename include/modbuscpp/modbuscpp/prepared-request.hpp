@@ -0,0 +1,181 @@
+#ifndef LIB_MODBUS_MODBUS_PREPARED_REQUEST_HPP_
+#define LIB_MODBUS_MODBUS_PREPARED_REQUEST_HPP_
+
+#include <cstdint>
+#include <string_view>
+
+#include "constants.hpp"
+#include "data-table.hpp"
+#include "types.hpp"
+
+namespace modbus {
+// forward declarations
+namespace internal {
+class request;
+}
+
+/**
+ * @brief prepared request
+ *
+ * @author  Ray Andrew
+ * @ingroup Modbus
+ *
+ * Encodes a request once for cyclic polling. Every send only patches the
+ * transaction id (and unit id) in place, and responses are validated
+ * against an expected prefix computed at preparation time:
+ *
+ * [ Transaction (2 bytes) ] <- patched per send
+ * [ Protocol    (2 bytes) ]
+ * [ Length      (2 bytes) ]
+ * [ Unit        (1 byte)  ]
+ * [ Function    (1 byte)  ]
+ * [ Byte count / echoed request data ]
+ * [ Payload (e.g. registers) ]
+ *
+ * The instance owns a single send buffer, so use one instance per
+ * connection (or copy_to() when several threads share it).
+ */
+class prepared_request {
+public:
+  /**
+   * Prepared request constructor
+   *
+   * Encodes request (throws whatever request::encode() throws)
+   *
+   * @param request request to prepare
+   */
+  explicit prepared_request(internal::request& request);
+
+  /**
+   * Patch transaction id into send buffer
+   *
+   * @param transaction transaction id
+   *
+   * @return encoded request
+   */
+  std::string_view stamp(std::uint16_t transaction) noexcept;
+
+  /**
+   * Patch transaction id and unit id into send buffer
+   *
+   * @param transaction transaction id
+   * @param unit        unit id
+   *
+   * @return encoded request
+   */
+  std::string_view stamp(std::uint16_t transaction,
+                         std::uint8_t  unit) noexcept;
+
+  /**
+   * Copy encoded request into buffer of at least size() bytes
+   *
+   * @param output      buffer to write to
+   * @param transaction transaction id
+   */
+  void copy_to(char* output, std::uint16_t transaction) const noexcept;
+
+  /**
+   * Validate response in place
+   *
+   * Throws ex::bad_data if packet does not match the expected response and
+   * the matching modbus exception if packet is an exception response
+   *
+   * @param packet      response packet
+   * @param transaction transaction id the request was sent with
+   *
+   * @return payload following the expected prefix
+   */
+  std::string_view check(std::string_view packet,
+                         std::uint16_t    transaction) const;
+
+  /**
+   * Validate read registers response and decode registers into buffer
+   *
+   * Throws ex::bad_data if the prepared function does not return registers
+   *
+   * @param packet      response packet
+   * @param transaction transaction id the request was sent with
+   * @param output      buffer to write registers to
+   * @param size        capacity of output (in registers)
+   *
+   * @return number of registers written
+   */
+  std::size_t decode_into(std::string_view             packet,
+                          std::uint16_t                transaction,
+                          block::registers::data_type* output,
+                          std::size_t                  size) const;
+
+  /**
+   * Get encoded request
+   *
+   * @return encoded request
+   */
+  inline const packet_t& packet() const { return packet_; }
+
+  /**
+   * Get encoded request size
+   *
+   * @return encoded request size
+   */
+  inline typename packet_t::size_type size() const { return packet_.size(); }
+
+  /**
+   * Get expected response size
+   *
+   * @return expected response size
+   */
+  inline typename packet_t::size_type response_size() const {
+    return response_size_;
+  }
+
+  /**
+   * Get function
+   *
+   * @return function
+   */
+  inline constants::function_code function() const { return function_; }
+
+  /**
+   * Get unit id
+   *
+   * @return unit id
+   */
+  inline std::uint8_t unit() const {
+    return static_cast<std::uint8_t>(packet_[unit_idx]);
+  }
+
+private:
+  /**
+   * Check exception response, throws if packet is one
+   *
+   * @param packet      response packet
+   * @param transaction transaction id the request was sent with
+   */
+  void throw_exception(std::string_view packet,
+                       std::uint16_t    transaction) const;
+
+private:
+  /**
+   * Unit index
+   */
+  static constexpr typename packet_t::size_type unit_idx = 6;
+  /**
+   * Function
+   */
+  constants::function_code function_;
+  /**
+   * Encoded request
+   */
+  packet_t packet_;
+  /**
+   * Expected response prefix (transaction bytes are ignored)
+   */
+  packet_t expected_;
+  /**
+   * Expected response size
+   */
+  typename packet_t::size_type response_size_;
+};
+}  // namespace modbus
+
+#endif  // LIB_MODBUS_MODBUS_PREPARED_REQUEST_HPP_
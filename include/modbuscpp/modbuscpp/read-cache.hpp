@@ -0,0 +1,279 @@
+#ifndef LIB_MODBUS_MODBUS_READ_CACHE_HPP_
+#define LIB_MODBUS_MODBUS_READ_CACHE_HPP_
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
+
+#include <boost/core/noncopyable.hpp>
+
+#include "constants.hpp"
+#include "data-table.hpp"
+#include "types.hpp"
+
+namespace modbus {
+/**
+ * @brief client read cache
+ *
+ * @author  Ray Andrew
+ * @ingroup Modbus
+ *
+ * Bounded-staleness cache of decoded read results keyed by
+ * (unit, function, address, count) with single-flight coalescing:
+ * concurrent reads of the same key while a fetch is in flight wait for
+ * that fetch instead of sending another request to the device.
+ *
+ * At most max_entries keys are kept: inserting a new key into a full cache
+ * first drops entries older than the default staleness bound, then the
+ * least recently fetched one. Keys with a fetch in flight are never
+ * dropped, so the cache may briefly exceed the bound while that many reads
+ * are outstanding.
+ *
+ * @tparam value_t decoded value type
+ */
+template <typename value_t> class read_cache : private boost::noncopyable {
+public:
+  /**
+   * Value type
+   */
+  typedef value_t value_type;
+
+  /**
+   * Shared value pointer type
+   */
+  typedef std::shared_ptr<const value_type> value_pointer;
+
+  /**
+   * Clock type
+   */
+  typedef std::chrono::steady_clock clock;
+
+  /**
+   * Fetch function type, performs the actual request
+   */
+  typedef std::function<value_type()> fetch_t;
+
+  /**
+   * Cache key
+   */
+  struct key_t {
+    /**
+     * Unit id
+     */
+    std::uint8_t unit;
+    /**
+     * Modbus function
+     */
+    constants::function_code function;
+    /**
+     * Starting address
+     */
+    std::uint16_t address;
+    /**
+     * Quantity
+     */
+    std::uint16_t count;
+
+    /**
+     * Less-than operator
+     *
+     * @param other other key
+     *
+     * @return true if key is ordered before other
+     */
+    inline bool operator<(const key_t& other) const {
+      return std::tie(unit, function, address, count)
+             < std::tie(other.unit, other.function, other.address,
+                        other.count);
+    }
+  };
+
+  /**
+   * Cache counters
+   */
+  struct stats_t {
+    /**
+     * Reads served from cache
+     */
+    std::uint64_t hits;
+    /**
+     * Reads that issued a fetch
+     */
+    std::uint64_t misses;
+    /**
+     * Reads that joined an in-flight fetch
+     */
+    std::uint64_t coalesced;
+  };
+
+  /**
+   * Read cache constructor
+   *
+   * @param max_age     default staleness bound
+   * @param max_entries maximum number of cached keys
+   */
+  explicit read_cache(
+      clock::duration max_age = std::chrono::milliseconds(100),
+      std::size_t     max_entries = 1024) noexcept;
+
+  /**
+   * Get value of key, fetching it if cached value is older than max_age
+   *
+   * Exception thrown by fetch is rethrown to every waiter and nothing is
+   * cached
+   *
+   * @param key     cache key
+   * @param fetch   function performing the read
+   * @param max_age staleness bound
+   *
+   * @return shared value
+   */
+  value_pointer get(const key_t& key, const fetch_t& fetch,
+                    clock::duration max_age);
+
+  /**
+   * Get value of key with default staleness bound
+   *
+   * @param key   cache key
+   * @param fetch function performing the read
+   *
+   * @return shared value
+   */
+  inline value_pointer get(const key_t& key, const fetch_t& fetch) {
+    return get(key, fetch, max_age_);
+  }
+
+  /**
+   * Store value (e.g. after write-through)
+   *
+   * @param key   cache key
+   * @param value value to store
+   */
+  void put(const key_t& key, value_type value);
+
+  /**
+   * Drop cached value of key
+   *
+   * @param key cache key
+   */
+  void invalidate(const key_t& key);
+
+  /**
+   * Drop cached values of unit
+   *
+   * @param unit unit id
+   */
+  void invalidate(std::uint8_t unit);
+
+  /**
+   * Drop every cached value
+   */
+  void clear();
+
+  /**
+   * Get counters
+   *
+   * @return counters
+   */
+  stats_t stats() const;
+
+  /**
+   * Get number of cached keys
+   *
+   * @return number of cached keys
+   */
+  std::size_t size() const;
+
+private:
+  /**
+   * Cache entry
+   */
+  struct entry_t {
+    /**
+     * Cached value
+     */
+    value_pointer value;
+    /**
+     * Time of fetch
+     */
+    clock::time_point fetched_at;
+    /**
+     * In-flight fetch
+     */
+    std::shared_future<value_pointer> inflight;
+  };
+
+  /**
+   * Entries iterator type
+   */
+  typedef typename std::map<key_t, entry_t>::iterator iterator;
+
+private:
+  /**
+   * Find entry of key, inserting it (and evicting if full) if missing
+   *
+   * Must be called with mutex held
+   *
+   * @param key cache key
+   *
+   * @return entry iterator
+   */
+  iterator find_or_insert(const key_t& key);
+
+  /**
+   * Drop expired entries, or the least recently fetched one if none expired
+   *
+   * Must be called with mutex held
+   */
+  void evict();
+
+private:
+  /**
+   * Default staleness bound
+   */
+  const clock::duration max_age_;
+  /**
+   * Maximum number of cached keys
+   */
+  const std::size_t max_entries_;
+  /**
+   * Mutex
+   */
+  mutable std::mutex mutex_;
+  /**
+   * Entries
+   */
+  std::map<key_t, entry_t> entries_;
+  /**
+   * Hits
+   */
+  std::atomic<std::uint64_t> hits_;
+  /**
+   * Misses
+   */
+  std::atomic<std::uint64_t> misses_;
+  /**
+   * Coalesced reads
+   */
+  std::atomic<std::uint64_t> coalesced_;
+};
+
+/**
+ * Register read cache
+ */
+using register_cache = read_cache<block::registers::container_type>;
+
+/**
+ * Bit read cache
+ */
+using bit_cache = read_cache<block::bits::container_type>;
+}  // namespace modbus
+
+#endif  // LIB_MODBUS_MODBUS_READ_CACHE_HPP_
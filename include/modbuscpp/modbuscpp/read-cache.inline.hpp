@@ -0,0 +1,174 @@
+#ifndef LIB_MODBUS_MODBUS_READ_CACHE_INLINE_HPP_
+#define LIB_MODBUS_MODBUS_READ_CACHE_INLINE_HPP_
+
+#include "read-cache.hpp"
+
+#include <exception>
+#include <utility>
+
+namespace modbus {
+template <typename value_t>
+inline read_cache<value_t>::read_cache(clock::duration max_age,
+                                       std::size_t     max_entries) noexcept
+    : max_age_{max_age},
+      max_entries_{max_entries},
+      hits_{0},
+      misses_{0},
+      coalesced_{0} {}
+
+template <typename value_t> inline typename read_cache<value_t>::value_pointer
+read_cache<value_t>::get(const key_t&    key,
+                         const fetch_t&  fetch,
+                         clock::duration max_age) {
+  std::promise<value_pointer> promise;
+
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    auto&                        entry = find_or_insert(key)->second;
+
+    if (entry.value && clock::now() - entry.fetched_at <= max_age) {
+      hits_++;
+      return entry.value;
+    }
+
+    if (entry.inflight.valid()) {
+      // single-flight: join the request that is already on the wire
+      auto inflight = entry.inflight;
+      lock.unlock();
+      coalesced_++;
+      return inflight.get();
+    }
+
+    entry.inflight = promise.get_future().share();
+  }
+
+  misses_++;
+
+  try {
+    auto value = std::make_shared<const value_type>(fetch());
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto&                       entry = find_or_insert(key)->second;
+      entry.value = value;
+      entry.fetched_at = clock::now();
+      entry.inflight = {};
+    }
+    promise.set_value(value);
+    return value;
+  } catch (...) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto                        it = entries_.find(key);
+
+      if (it != entries_.end()) {
+        it->second.inflight = {};
+
+        // nothing worth keeping for a key that was never fetched
+        if (!it->second.value) {
+          entries_.erase(it);
+        }
+      }
+    }
+    promise.set_exception(std::current_exception());
+    throw;
+  }
+}
+
+template <typename value_t>
+inline void read_cache<value_t>::put(const key_t& key, value_type value) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto&                       entry = find_or_insert(key)->second;
+  entry.value = std::make_shared<const value_type>(std::move(value));
+  entry.fetched_at = clock::now();
+}
+
+template <typename value_t>
+inline void read_cache<value_t>::invalidate(const key_t& key) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto                        it = entries_.find(key);
+
+  if (it != entries_.end()) {
+    // keep in-flight fetch so its waiters are still served
+    it->second.value.reset();
+  }
+}
+
+template <typename value_t>
+inline void read_cache<value_t>::invalidate(std::uint8_t unit) {
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  for (auto& [key, entry] : entries_) {
+    if (key.unit == unit) {
+      entry.value.reset();
+    }
+  }
+}
+
+template <typename value_t> inline void read_cache<value_t>::clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  for (auto it = entries_.begin(); it != entries_.end();) {
+    if (it->second.inflight.valid()) {
+      it->second.value.reset();
+      ++it;
+    } else {
+      it = entries_.erase(it);
+    }
+  }
+}
+
+template <typename value_t>
+inline typename read_cache<value_t>::stats_t read_cache<value_t>::stats()
+    const {
+  return {hits_.load(), misses_.load(), coalesced_.load()};
+}
+
+template <typename value_t>
+inline std::size_t read_cache<value_t>::size() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return entries_.size();
+}
+
+template <typename value_t> inline typename read_cache<value_t>::iterator
+read_cache<value_t>::find_or_insert(const key_t& key) {
+  auto it = entries_.find(key);
+
+  if (it != entries_.end()) {
+    return it;
+  }
+
+  if (entries_.size() >= max_entries_) {
+    evict();
+  }
+
+  return entries_.try_emplace(key).first;
+}
+
+template <typename value_t> inline void read_cache<value_t>::evict() {
+  auto now = clock::now();
+  auto oldest = entries_.end();
+
+  for (auto it = entries_.begin(); it != entries_.end();) {
+    auto& entry = it->second;
+
+    if (entry.inflight.valid()) {
+      // waiters still need the entry
+      ++it;
+    } else if (!entry.value || now - entry.fetched_at > max_age_) {
+      it = entries_.erase(it);
+    } else {
+      if (oldest == entries_.end()
+          || entry.fetched_at < oldest->second.fetched_at) {
+        oldest = it;
+      }
+      ++it;
+    }
+  }
+
+  if (entries_.size() >= max_entries_ && oldest != entries_.end()) {
+    entries_.erase(oldest);
+  }
+}
+}  // namespace modbus
+
+#endif  // LIB_MODBUS_MODBUS_READ_CACHE_INLINE_HPP_
@@ -184,6 +184,37 @@ public:
    */
   virtual void decode_passed(const packet_t& packet) override;
 
+  /**
+   * Decode packet straight into caller-provided buffer
+   *
+   * Header is validated in place and registers are written to output
+   * without going through registers()
+   *
+   * @param packet packet to decode
+   * @param output buffer to write registers to
+   * @param size   capacity of output (in registers)
+   *
+   * @return number of registers written
+   */
+  std::size_t decode_into(std::string_view             packet,
+                          block::registers::data_type* output,
+                          std::size_t                  size);
+
+  /**
+   * Decode packet straight into caller-provided buffer
+   *
+   * @param packet packet to decode
+   * @param output buffer to write registers to
+   * @param size   capacity of output (in registers)
+   *
+   * @return number of registers written
+   */
+  inline std::size_t decode_into(const packet_t&              packet,
+                                 block::registers::data_type* output,
+                                 std::size_t                  size) {
+    return decode_into({packet.data(), packet.size()}, output, size);
+  }
+
   /**
    * Dump to string
    *
@@ -203,10 +234,20 @@ public:
   /**
    * Get registers
    */
-  inline const block::registers::container_type& registers() const {
+  inline const block::registers::buffer_type& registers() const {
     return registers_;
   }
 
+private:
+  /**
+   * Validate byte count of stage passed packet
+   *
+   * @param packet packet to validate
+   *
+   * @return pointer to first register in packet
+   */
+  const char* check_passed(std::string_view packet);
+
 private:
   /**
    * Request pointer
@@ -219,7 +260,7 @@ private:
   /**
    * Slice of data from block of registers from data table
    */
-  block::registers::container_type registers_;
+  block::registers::buffer_type registers_;
   /**
    * Struct format
    */
@@ -9,6 +9,7 @@
 
 #include "exception.hpp"
 #include "logger.hpp"
+#include "memory-pool.hpp"
 #include "operation.hpp"
 #include "utilities.hpp"
 
@@ -41,8 +42,7 @@ packet_t base_read_registers<function_code>::encode() {
   calc_length(data_length);
   packet_t packet = header_packet();
   packet.reserve(header_length + 1 + data_length);
-  packet_t pdu = struc::pack(fmt::format(">{}", format), address_(), count_());
-  packet.insert(packet.end(), pdu.begin(), pdu.end());
+  utilities::pack_into(packet, format, address_(), count_());
   return packet;
 }
 
@@ -68,44 +68,44 @@ base_read_registers<function_code>::base_read_registers(
     const request::base_read_registers<function_code>* request,
     table*                                             data_table) noexcept
     : internal::response{function_code, request->header(), data_table},
-      request_{request} {
+      request_{request},
+      registers_(memory_pool::get()) {
   initialize({request_->transaction(), request_->unit()});
 }
 
 template <constants::function_code function_code>
-void base_read_registers<function_code>::decode_passed(const packet_t& packet) {
-  try {
-    if (packet.size() != request_->response_size()) {
+const char* base_read_registers<function_code>::check_passed(
+    std::string_view packet) {
+  if (packet.size() != request_->response_size()) {
 #ifndef DEBUG_ON
-      logger::debug("Packet size is not as same as expected response size");
+    logger::debug("Packet size is not as same as expected response size");
 #endif
-      throw ex::bad_data();
-    }
+    throw ex::bad_data();
+  }
 
-    packet_t::size_type byte_idx = header_length + 1;
-    count_ = static_cast<std::uint16_t>(packet[byte_idx]);
+  packet_t::size_type byte_idx = header_length + 1;
+  count_ = static_cast<std::uint8_t>(packet[byte_idx]);
 
-    if (count_ != request_->byte_count()) {
+  if (count_ != request_->byte_count()) {
 #ifndef DEBUG_ON
-      logger::debug(
-          "Bytes count is not as same as expected number of registers");
+    logger::debug("Bytes count is not as same as expected number of registers");
 #endif
-      throw ex::bad_data();
-    }
+    throw ex::bad_data();
+  }
 
-    block::registers::container_type buffer;
+  return packet.data() + byte_idx + 1;
+}
 
-    for (int idx = 0; idx < request_->byte_count(); idx += 2) {
-      std::uint16_t value;
-      struc::unpack(">H", packet.data() + byte_idx + 1 + idx, value);
-      buffer.push_back(value);
-    }
+template <constants::function_code function_code>
+void base_read_registers<function_code>::decode_passed(const packet_t& packet) {
+  try {
+    const char* values = check_passed({packet.data(), packet.size()});
 
-    if (buffer.size() != request_->count().get()) {
-#ifndef DEBUG_ON
-      logger::debug("Bytes count is not as same as number of registers");
-#endif
-      throw ex::bad_data();
+    block::registers::buffer_type buffer(request_->count().get(),
+                                            registers_.get_allocator());
+
+    for (std::size_t idx = 0; idx < buffer.size(); ++idx) {
+      buffer[idx] = utilities::read_u16(values + idx * 2);
     }
 
     registers_.swap(buffer);
@@ -113,6 +113,32 @@ void base_read_registers<function_code>::decode_passed(const packet_t& packet) {
     throw ex::bad_data();
   }
 }
+
+template <constants::function_code function_code>
+std::size_t base_read_registers<function_code>::decode_into(
+    std::string_view             packet,
+    block::registers::data_type* output,
+    std::size_t                  size) {
+  const std::size_t count = request_->count().get();
+
+  if (output == nullptr || size < count) {
+    throw ex::bad_data_size();
+  }
+
+  try {
+    check(packet);
+  } catch (const std::out_of_range&) {
+    throw ex::bad_data();
+  }
+
+  const char* values = check_passed(packet);
+
+  for (std::size_t idx = 0; idx < count; ++idx) {
+    output[idx] = utilities::read_u16(values + idx * 2);
+  }
+
+  return count;
+}
 }  // namespace response
 }  // namespace modbus
 
@@ -163,6 +163,18 @@ public:
       const write_num_regs_t& count = write_num_regs_t{},
       std::initializer_list<block::registers::data_type> values = {}) noexcept;
 
+  /**
+   * request::write_multiple_registers constructor
+   *
+   * @param address    output address
+   * @param count      count
+   * @param values     register values
+   */
+  explicit write_multiple_registers(
+      const address_t&                 address,
+      const write_num_regs_t&          count,
+      block::registers::container_type values) noexcept;
+
   /**
    *
    * Encode write multiple registers packet from given data
@@ -231,7 +243,7 @@ public:
    *
    * @return value
    */
-  inline const block::registers::container_type& values() const {
+  inline const block::registers::buffer_type& values() const {
     return values_;
   }
 
@@ -257,7 +269,7 @@ private:
   /**
    * Value
    */
-  block::registers::container_type values_;
+  block::registers::buffer_type values_;
   /**
    * Struct format
    */
@@ -482,7 +494,7 @@ public:
    *
    * @return values
    */
-  inline const block::registers::container_type& values() const {
+  inline const block::registers::buffer_type& values() const {
     return values_;
   }
 
@@ -527,7 +539,7 @@ private:
   /**
    * Values
    */
-  block::registers::container_type values_;
+  block::registers::buffer_type values_;
   /**
    * Struct format
    */
@@ -868,6 +880,37 @@ public:
    */
   virtual void decode_passed(const packet_t& packet) override;
 
+  /**
+   * Decode packet straight into caller-provided buffer
+   *
+   * Header is validated in place and read registers are written to output
+   * without going through registers()
+   *
+   * @param packet packet to decode
+   * @param output buffer to write registers to
+   * @param size   capacity of output (in registers)
+   *
+   * @return number of registers written
+   */
+  std::size_t decode_into(std::string_view             packet,
+                          block::registers::data_type* output,
+                          std::size_t                  size);
+
+  /**
+   * Decode packet straight into caller-provided buffer
+   *
+   * @param packet packet to decode
+   * @param output buffer to write registers to
+   * @param size   capacity of output (in registers)
+   *
+   * @return number of registers written
+   */
+  inline std::size_t decode_into(const packet_t&              packet,
+                                 block::registers::data_type* output,
+                                 std::size_t                  size) {
+    return decode_into({packet.data(), packet.size()}, output, size);
+  }
+
   /**
    * Dump to string
    *
@@ -887,10 +930,20 @@ public:
   /**
    * Get registers
    */
-  inline const block::registers::container_type& registers() const {
+  inline const block::registers::buffer_type& registers() const {
     return registers_;
   }
 
+private:
+  /**
+   * Validate byte count of stage passed packet
+   *
+   * @param packet packet to validate
+   *
+   * @return pointer to first register in packet
+   */
+  const char* check_passed(std::string_view packet);
+
 private:
   /**
    * Request pointer
@@ -903,7 +956,7 @@ private:
   /**
    * Slice of data from block of registers from data table
    */
-  block::registers::container_type registers_;
+  block::registers::buffer_type registers_;
   /**
    * Struct format
    */
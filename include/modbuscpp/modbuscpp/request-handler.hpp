@@ -10,6 +10,9 @@
 namespace modbus {
 // forward declaration
 class table;
+namespace stats {
+class recorder;
+}
 
 class request_handler : private boost::noncopyable {
 public:
@@ -18,19 +21,39 @@ public:
    *
    * @param data_table data table
    * @param packet     request packet
+   * @param recorder   stats recorder of calling thread (optional)
    *
    * @return packet to send
    */
-  static packet_t handle(table* data_table, const std::string_view& packet);
+  static packet_t handle(table*                  data_table,
+                         const std::string_view& packet,
+                         stats::recorder*        recorder = nullptr);
   /**
    * Handle request
    *
    * @param data_table data table
    * @param packet     request packet
+   * @param recorder   stats recorder of calling thread (optional)
    *
    * @return packet to send
    */
-  static packet_t handle(table* data_table, const packet_t& packet);
+  static packet_t handle(table*           data_table,
+                         const packet_t&  packet,
+                         stats::recorder* recorder = nullptr);
+
+private:
+  /**
+   * Dispatch request to its handler
+   *
+   * @param data_table data table
+   * @param packet     request packet
+   * @param recorder   stats recorder of calling thread, may be nullptr
+   *
+   * @return packet to send
+   */
+  static packet_t dispatch(table*           data_table,
+                           const packet_t&  packet,
+                           stats::recorder* recorder);
 };
 }  // namespace modbus
 
@@ -54,6 +54,11 @@ public:
   explicit request(constants::function_code function,
                    const initializer_t&     initializer);
 
+  /**
+   * Request destructor
+   */
+  virtual ~request();
+
   /**
    * Execute on data store / mapping
    *
@@ -9,6 +9,7 @@
 #include "adu.hpp"
 #include "constants.hpp"
 #include "exception.hpp"
+#include "memory-pool.hpp"
 #include "types.hpp"
 
 #if defined(WIN32) || defined(_WIN32) \
@@ -59,6 +60,23 @@ public:
    */
   virtual ~response();
 
+  /**
+   * Allocate response from the per-thread memory pool
+   *
+   * @param size object size
+   *
+   * @return object storage
+   */
+  static void* operator new(std::size_t size);
+
+  /**
+   * Return response to the per-thread memory pool
+   *
+   * @param ptr  object storage
+   * @param size object size
+   */
+  static void operator delete(void* ptr, std::size_t size) noexcept;
+
   /**
    * Decode response
    *
@@ -108,7 +126,17 @@ protected:
    *
    * @return exception stage
    */
-  stage check_stage(const packet_t& packet);
+  stage check_stage(std::string_view packet);
+
+  /**
+   * Check packet in place
+   *
+   * Throws ex::bad_data if packet is malformed and the matching modbus
+   * exception if packet is an exception response
+   *
+   * @param packet packet to check
+   */
+  void check(std::string_view packet);
 
   /**
    * Initial packet check
@@ -120,7 +148,7 @@ protected:
    *
    * @return test passed or not
    */
-  static bool initial_check(const packet_t& packet);
+  static bool initial_check(std::string_view packet);
 
   /**
    * Data table getter
@@ -0,0 +1,292 @@
+#ifndef LIB_MODBUS_MODBUS_RTT_ESTIMATOR_HPP_
+#define LIB_MODBUS_MODBUS_RTT_ESTIMATOR_HPP_
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <utility>
+
+namespace modbus {
+/**
+ * @brief round trip time estimator
+ *
+ * @author  Ray Andrew
+ * @ingroup Modbus
+ *
+ * Jacobson/Karels estimator (RFC 6298) to derive request timeouts from
+ * observed round trip times instead of fixed timeouts:
+ * - SRTT   <- 7/8 SRTT + 1/8 R
+ * - RTTVAR <- 3/4 RTTVAR + 1/4 |SRTT - R|
+ * - RTO    <- SRTT + max(granularity, 4 RTTVAR)
+ *
+ * Following Karn's algorithm, only feed samples of requests that were
+ * answered on the first attempt; every timeout doubles RTO until the next
+ * valid sample.
+ */
+class rtt_estimator {
+public:
+  /**
+   * Duration type
+   */
+  typedef std::chrono::microseconds duration;
+
+  /**
+   * Initializer
+   */
+  struct initializer_t {
+    /**
+     * Timeout used before the first sample
+     */
+    duration initial_timeout = std::chrono::seconds(1);
+    /**
+     * Lower bound of timeout
+     */
+    duration min_timeout = std::chrono::milliseconds(20);
+    /**
+     * Upper bound of timeout (and of retry spacing)
+     */
+    duration max_timeout = std::chrono::seconds(10);
+    /**
+     * Clock granularity
+     */
+    duration granularity = std::chrono::milliseconds(1);
+  };
+
+  /**
+   * RTT estimator constructor
+   */
+  explicit rtt_estimator() noexcept;
+
+  /**
+   * RTT estimator constructor
+   *
+   * @param initializer initializer
+   */
+  explicit rtt_estimator(const initializer_t& initializer) noexcept;
+
+  /**
+   * Feed round trip time of a request answered on the first attempt
+   *
+   * @param rtt measured round trip time
+   */
+  void sample(duration rtt) noexcept;
+
+  /**
+   * Feed round trip time of a request answered on the first attempt
+   *
+   * @param rtt measured round trip time
+   */
+  template <typename Rep, typename Period>
+  inline void sample(std::chrono::duration<Rep, Period> rtt) noexcept {
+    sample(std::chrono::duration_cast<duration>(rtt));
+  }
+
+  /**
+   * Report a timed out request (exponential backoff)
+   */
+  void expired() noexcept;
+
+  /**
+   * Get request timeout (RTO) including current backoff
+   *
+   * @return request timeout
+   */
+  duration timeout() const noexcept;
+
+  /**
+   * Get delay before given retry attempt
+   *
+   * @param attempt retry attempt, starting from 1
+   *
+   * @return delay to wait before sending the attempt
+   */
+  duration retry_delay(unsigned int attempt) const noexcept;
+
+  /**
+   * Reset to initial state
+   */
+  void reset() noexcept;
+
+  /**
+   * Get smoothed round trip time
+   *
+   * @return smoothed round trip time
+   */
+  inline duration srtt() const noexcept { return srtt_; }
+
+  /**
+   * Get round trip time variance
+   *
+   * @return round trip time variance
+   */
+  inline duration rttvar() const noexcept { return rttvar_; }
+
+  /**
+   * Get number of consecutive timeouts
+   *
+   * @return number of consecutive timeouts
+   */
+  inline unsigned int backoff() const noexcept { return backoff_; }
+
+  /**
+   * Check if estimator has any sample yet
+   *
+   * @return true if at least one sample has been fed
+   */
+  inline bool has_sample() const noexcept { return has_sample_; }
+
+private:
+  /**
+   * Clamp duration to [min_timeout, max_timeout]
+   *
+   * @param value duration to clamp
+   *
+   * @return clamped duration
+   */
+  duration clamp(duration value) const noexcept;
+
+private:
+  /**
+   * Initializer
+   */
+  initializer_t initializer_;
+  /**
+   * Smoothed round trip time
+   */
+  duration srtt_;
+  /**
+   * Round trip time variance
+   */
+  duration rttvar_;
+  /**
+   * Retransmission timeout without backoff
+   */
+  duration rto_;
+  /**
+   * Number of consecutive timeouts
+   */
+  unsigned int backoff_;
+  /**
+   * Has sample
+   */
+  bool has_sample_;
+};
+
+/**
+ * @brief per endpoint round trip time estimators
+ *
+ * @author  Ray Andrew
+ * @ingroup Modbus
+ *
+ * Thread-safe map of rtt_estimator keyed by endpoint (e.g. "host:port")
+ * and unit id, so devices behind the same gateway are tracked separately
+ */
+class rtt_table {
+public:
+  /**
+   * Duration type
+   */
+  typedef rtt_estimator::duration duration;
+
+  /**
+   * RTT table constructor
+   *
+   * @param initializer initializer for every new estimator
+   */
+  explicit rtt_table(const rtt_estimator::initializer_t& initializer
+                     = {}) noexcept;
+
+  /**
+   * Feed round trip time of a request answered on the first attempt
+   *
+   * @param endpoint endpoint
+   * @param unit     unit id
+   * @param rtt      measured round trip time
+   */
+  void sample(std::string_view endpoint, std::uint8_t unit, duration rtt);
+
+  /**
+   * Report a timed out request
+   *
+   * @param endpoint endpoint
+   * @param unit     unit id
+   */
+  void expired(std::string_view endpoint, std::uint8_t unit);
+
+  /**
+   * Get request timeout of endpoint
+   *
+   * @param endpoint endpoint
+   * @param unit     unit id
+   *
+   * @return request timeout
+   */
+  duration timeout(std::string_view endpoint, std::uint8_t unit) const;
+
+  /**
+   * Get delay before given retry attempt of endpoint
+   *
+   * @param endpoint endpoint
+   * @param unit     unit id
+   * @param attempt  retry attempt, starting from 1
+   *
+   * @return delay to wait before sending the attempt
+   */
+  duration retry_delay(std::string_view endpoint,
+                       std::uint8_t     unit,
+                       unsigned int     attempt) const;
+
+  /**
+   * Get copy of estimator of endpoint
+   *
+   * @param endpoint endpoint
+   * @param unit     unit id
+   *
+   * @return estimator (initial state if endpoint is unknown)
+   */
+  rtt_estimator get(std::string_view endpoint, std::uint8_t unit) const;
+
+  /**
+   * Forget endpoint
+   *
+   * @param endpoint endpoint
+   * @param unit     unit id
+   */
+  void erase(std::string_view endpoint, std::uint8_t unit);
+
+private:
+  /**
+   * Key type
+   */
+  typedef std::pair<std::string, std::uint8_t> key_type;
+
+  /**
+   * Get or create estimator, mutex_ must be held
+   *
+   * @param endpoint endpoint
+   * @param unit     unit id
+   *
+   * @return estimator reference
+   */
+  rtt_estimator& at(std::string_view endpoint, std::uint8_t unit);
+
+private:
+  /**
+   * Mutex
+   */
+  mutable std::mutex mutex_;
+  /**
+   * Initializer for new estimators
+   */
+  rtt_estimator::initializer_t initializer_;
+  /**
+   * Estimators
+   */
+  std::map<key_type, rtt_estimator> estimators_;
+};
+}  // namespace modbus
+
+#endif  // LIB_MODBUS_MODBUS_RTT_ESTIMATOR_HPP_
@@ -1,10 +1,16 @@
 #ifndef LIB_MODBUS_SERVER_HPP_
 #define LIB_MODBUS_SERVER_HPP_
 
+#include <atomic>
 #include <exception>
 #include <functional>
 #include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
 #include <string_view>
+#include <unordered_map>
+#include <vector>
 
 #include <boost/core/noncopyable.hpp>
 
@@ -14,6 +20,9 @@
 #include "asio2.hpp"
 
 #include "data-table.hpp"
+#include "session-stats.hpp"
+#include "stats.hpp"
+#include "traffic-capture.hpp"
 #include "utilities.hpp"
 
 namespace modbus {
@@ -91,6 +100,52 @@ public:
    */
   inline const table& data_table() const { return *data_table_; }
 
+  /**
+   * Get stats snapshot
+   *
+   * Merges the per-thread counters and histograms, safe to call from any
+   * thread while the server is running
+   *
+   * @return stats snapshot
+   */
+  inline modbus::stats::snapshot_t stats() const { return stats_.snapshot(); }
+
+  /**
+   * Get stats of every connected session
+   *
+   * Use it to find slow or misbehaving clients, the key matches
+   * asio2::tcp_session::hash_key()
+   *
+   * @return session stats snapshots
+   */
+  inline std::vector<modbus::stats::session_t> sessions() const {
+    return sessions_.snapshot();
+  }
+
+  /**
+   * Get stats of session
+   *
+   * @param key session key (asio2::tcp_session::hash_key())
+   *
+   * @return session stats snapshot, empty if not connected
+   */
+  inline std::optional<modbus::stats::session_t> session(
+      std::size_t key) const {
+    return sessions_.snapshot(key);
+  }
+
+  /**
+   * Capture request / response ADUs
+   *
+   * The capture must outlive the server or be detached with nullptr
+   * before it is destroyed
+   *
+   * @param capture traffic capture, nullptr to stop capturing
+   */
+  inline void capture_traffic(traffic_capture* capture) noexcept {
+    capture_.store(capture, std::memory_order_release);
+  }
+
   /**
    * Set on connect callback
    *
@@ -141,11 +196,22 @@ private:
   /**
    * Receive callback
    *
+   * Splits received bytes into requests by the MBAP length, a request cut
+   * at the end of a read is kept until the rest arrives
+   *
    * @param session_ptr session pointer
    * @param raw_packet  raw packet
    */
   void on_receive(session_ptr_t& session_ptr, std::string_view raw_packet);
 
+  /**
+   * Handle one request
+   *
+   * @param session_ptr session pointer
+   * @param raw_packet  request ADU
+   */
+  void handle(session_ptr_t& session_ptr, std::string_view raw_packet);
+
 private:
   /**
    * Asio server
@@ -155,6 +221,30 @@ private:
    * Data table
    */
   table::pointer data_table_;
+  /**
+   * Stats
+   */
+  modbus::stats::collector stats_;
+  /**
+   * Per-session stats
+   */
+  modbus::stats::session_registry sessions_;
+  /**
+   * Traffic capture
+   */
+  std::atomic<traffic_capture*> capture_;
+  /**
+   * Requests cut at the end of a read, by session key
+   */
+  std::unordered_map<std::size_t, std::string> partial_;
+  /**
+   * Mutex guarding partial requests
+   */
+  std::mutex partial_mutex_;
+  /**
+   * Number of partial requests, lets complete reads skip the mutex
+   */
+  std::atomic<std::size_t> partial_count_;
   /**
    * On connect custom callback
    */
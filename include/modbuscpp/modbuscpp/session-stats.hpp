@@ -0,0 +1,323 @@
+#ifndef LIB_MODBUS_MODBUS_SESSION_STATS_HPP_
+#define LIB_MODBUS_MODBUS_SESSION_STATS_HPP_
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <boost/core/noncopyable.hpp>
+
+namespace modbus {
+namespace stats {
+/**
+ * @brief session stats snapshot
+ *
+ * @author  Ray Andrew
+ * @ingroup Modbus
+ */
+struct session_t {
+  /**
+   * Get mean service time
+   *
+   * @return mean service time (ns), 0 if nothing was served
+   */
+  inline double mean_service_time() const {
+    return served == 0 ? 0.0 : static_cast<double>(service_time) / served;
+  }
+
+  /**
+   * Session key (asio2 session hash key)
+   */
+  std::size_t key = 0;
+  /**
+   * Remote address
+   */
+  std::string remote_address;
+  /**
+   * Remote port
+   */
+  std::uint16_t remote_port = 0;
+  /**
+   * Connection time
+   */
+  std::chrono::system_clock::time_point connected_at;
+  /**
+   * Number of requests
+   */
+  std::uint64_t requests = 0;
+  /**
+   * Bytes received
+   */
+  std::uint64_t bytes_in = 0;
+  /**
+   * Bytes sent
+   */
+  std::uint64_t bytes_out = 0;
+  /**
+   * Number of exception responses
+   */
+  std::uint64_t exceptions = 0;
+  /**
+   * Responses queued but not sent yet
+   */
+  std::uint64_t send_queue = 0;
+  /**
+   * Max responses queued at once
+   */
+  std::uint64_t max_send_queue = 0;
+  /**
+   * Number of responses sent
+   */
+  std::uint64_t served = 0;
+  /**
+   * Total service time, receive to send completion (ns)
+   */
+  std::uint64_t service_time = 0;
+  /**
+   * Max service time (ns)
+   */
+  std::uint64_t max_service_time = 0;
+};
+
+/**
+ * @brief live session stats
+ *
+ * @author  Ray Andrew
+ * @ingroup Modbus
+ *
+ * Only written from the io thread the session is bound to (asio2 never
+ * moves a session between io threads), read from any thread
+ */
+class session : private boost::noncopyable {
+public:
+  /**
+   * Session stats constructor
+   *
+   * @param key            session key
+   * @param remote_address remote address
+   * @param remote_port    remote port
+   */
+  session(std::size_t   key,
+          std::string   remote_address,
+          std::uint16_t remote_port);
+
+  /**
+   * Record received request
+   *
+   * @param bytes request size
+   */
+  void request(std::size_t bytes) noexcept;
+
+  /**
+   * Record queued response
+   *
+   * @param exception true if the response is an exception response
+   */
+  void queued(bool exception) noexcept;
+
+  /**
+   * Record sent response
+   *
+   * @param bytes        bytes sent
+   * @param service_time receive to send completion (ns)
+   */
+  void sent(std::size_t bytes, std::uint64_t service_time) noexcept;
+
+  /**
+   * Get snapshot
+   *
+   * @return snapshot
+   */
+  session_t snapshot() const;
+
+private:
+  /**
+   * Increment counter (single writer)
+   *
+   * @param counter counter
+   * @param value   value to add
+   */
+  inline static void add(std::atomic<std::uint64_t>& counter,
+                         std::uint64_t               value) noexcept {
+    counter.store(counter.load(std::memory_order_relaxed) + value,
+                  std::memory_order_relaxed);
+  }
+
+  /**
+   * Raise counter to value (single writer)
+   *
+   * @param counter counter
+   * @param value   value
+   */
+  inline static void raise(std::atomic<std::uint64_t>& counter,
+                           std::uint64_t               value) noexcept {
+    if (value > counter.load(std::memory_order_relaxed)) {
+      counter.store(value, std::memory_order_relaxed);
+    }
+  }
+
+private:
+  /**
+   * Session key
+   */
+  const std::size_t key_;
+  /**
+   * Remote address
+   */
+  const std::string remote_address_;
+  /**
+   * Remote port
+   */
+  const std::uint16_t remote_port_;
+  /**
+   * Connection time
+   */
+  const std::chrono::system_clock::time_point connected_at_;
+  /**
+   * Number of requests
+   */
+  std::atomic<std::uint64_t> requests_;
+  /**
+   * Bytes received
+   */
+  std::atomic<std::uint64_t> bytes_in_;
+  /**
+   * Bytes sent
+   */
+  std::atomic<std::uint64_t> bytes_out_;
+  /**
+   * Number of exception responses
+   */
+  std::atomic<std::uint64_t> exceptions_;
+  /**
+   * Number of queued responses
+   */
+  std::atomic<std::uint64_t> queued_;
+  /**
+   * Max responses queued at once
+   */
+  std::atomic<std::uint64_t> max_send_queue_;
+  /**
+   * Number of responses sent
+   */
+  std::atomic<std::uint64_t> served_;
+  /**
+   * Total service time (ns)
+   */
+  std::atomic<std::uint64_t> service_time_;
+  /**
+   * Max service time (ns)
+   */
+  std::atomic<std::uint64_t> max_service_time_;
+};
+
+/**
+ * @brief session stats registry
+ *
+ * @author  Ray Andrew
+ * @ingroup Modbus
+ *
+ * Sessions are spread over sharded maps, so io threads looking up their
+ * sessions rarely meet on the same mutex
+ */
+class session_registry : private boost::noncopyable {
+public:
+  /**
+   * Session stats pointer
+   */
+  typedef std::shared_ptr<session> pointer;
+
+  /**
+   * Number of shards
+   */
+  static constexpr std::size_t shard_count = 16;
+
+  /**
+   * Register session
+   *
+   * @param key            session key
+   * @param remote_address remote address
+   * @param remote_port    remote port
+   *
+   * @return session stats
+   */
+  pointer add(std::size_t   key,
+              std::string   remote_address,
+              std::uint16_t remote_port);
+
+  /**
+   * Unregister session
+   *
+   * @param key session key
+   */
+  void remove(std::size_t key);
+
+  /**
+   * Find session
+   *
+   * @param key session key
+   *
+   * @return session stats, nullptr if not registered
+   */
+  pointer find(std::size_t key) const;
+
+  /**
+   * Get snapshot of session
+   *
+   * @param key session key
+   *
+   * @return snapshot, empty if not registered
+   */
+  std::optional<session_t> snapshot(std::size_t key) const;
+
+  /**
+   * Get snapshot of every session
+   *
+   * @return snapshots
+   */
+  std::vector<session_t> snapshot() const;
+
+private:
+  /**
+   * Shard
+   */
+  struct shard_t {
+    /**
+     * Mutex guarding sessions
+     */
+    mutable std::mutex mutex;
+    /**
+     * Sessions by key
+     */
+    std::unordered_map<std::size_t, pointer> sessions;
+  };
+
+  /**
+   * Get shard of key
+   *
+   * @param key session key
+   *
+   * @return shard
+   */
+  inline shard_t& shard(std::size_t key) const {
+    // keys are session addresses, skip the alignment bits
+    return shards_[(key >> 4) % shard_count];
+  }
+
+private:
+  /**
+   * Shards
+   */
+  mutable std::array<shard_t, shard_count> shards_;
+};
+}  // namespace stats
+}  // namespace modbus
+
+#endif  // LIB_MODBUS_MODBUS_SESSION_STATS_HPP_
@@ -0,0 +1,282 @@
+#ifndef LIB_MODBUS_MODBUS_SIMULATOR_HPP_
+#define LIB_MODBUS_MODBUS_SIMULATOR_HPP_
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <boost/core/noncopyable.hpp>
+
+#include "data-table.hpp"
+#include "types.hpp"
+#include "utilities.hpp"
+
+namespace modbus {
+/**
+ * @brief device simulator
+ *
+ * @author  Ray Andrew
+ * @ingroup Modbus
+ *
+ * Generators update ranges of input registers or discrete inputs of a
+ * table from dedicated threads while clients poll the same table, which
+ * gives realistic writer / reader contention on the blocks.
+ *
+ * Each generator advances one tick per update and writes its whole range
+ * with a single block set(). Generators are spread round-robin over the
+ * threads; a thread runs every due tick of its generators and sleeps
+ * until the next one is due. Ticks that fall behind are caught up, so the
+ * average rate holds while the thread keeps up.
+ *
+ * Usage:
+ * auto sim = modbus::simulator::create(
+ *     *data_table, {modbus::simulator::parse("sine:ir:0:100")}, 2);
+ * sim->run();
+ */
+class simulator : private boost::noncopyable {
+public:
+  /**
+   * Pointer type
+   */
+  typedef std::unique_ptr<simulator> pointer;
+
+  /**
+   * Create smart pointer of simulator
+   */
+  MAKE_STD_UNIQUE(simulator)
+
+  /**
+   * Clock type
+   */
+  typedef std::chrono::steady_clock clock;
+
+  /**
+   * Generator waveform
+   */
+  enum class waveform : std::uint8_t {
+    /**
+     * min .. max sawtooth, each address one tick ahead of the previous
+     */
+    ramp,
+    /**
+     * Sine between min and max over period ticks
+     */
+    sine,
+    /**
+     * Uniform noise between min and max
+     */
+    noise,
+    /**
+     * 32-bit counters of (tick + index) in high / low register pairs,
+     * binary digits of tick for discrete inputs
+     */
+    counter,
+    /**
+     * Alternates between min and max every period ticks
+     */
+    step,
+  };
+
+  /**
+   * Generator target block
+   */
+  enum class target : std::uint8_t {
+    input_registers,
+    discrete_inputs,
+  };
+
+  /**
+   * Generator
+   */
+  struct generator_t {
+    /**
+     * Waveform
+     */
+    waveform kind = waveform::ramp;
+    /**
+     * Target block
+     */
+    target block = target::input_registers;
+    /**
+     * Starting address
+     */
+    address_t address{0x00};
+    /**
+     * Number of registers / inputs
+     */
+    std::uint16_t count = 1;
+    /**
+     * Minimum value, discrete inputs are on above (min + max) / 2
+     */
+    std::uint16_t min = 0;
+    /**
+     * Maximum value
+     */
+    std::uint16_t max = 0xFFFF;
+    /**
+     * Ticks per cycle of sine and step
+     */
+    std::uint32_t period = 1000;
+    /**
+     * Ticks per second, 0 to run unthrottled
+     */
+    double rate = 1000;
+  };
+
+  /**
+   * Simulator constructor
+   *
+   * @param data_table table to update, must outlive the simulator
+   * @param generators generators
+   * @param threads    number of update threads
+   *
+   * @throw ex::out_of_range generator range outside of its block
+   */
+  simulator(table&                   data_table,
+            std::vector<generator_t> generators,
+            std::size_t              threads = 1);
+
+  /**
+   * Simulator destructor, calls stop()
+   */
+  ~simulator();
+
+  /**
+   * Start update threads
+   */
+  void run();
+
+  /**
+   * Stop update threads
+   */
+  void stop();
+
+  /**
+   * Get number of registers / inputs written
+   *
+   * @return number of updated values
+   */
+  inline std::uint64_t updates() const noexcept {
+    return updates_.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * Parse generator
+   *
+   * Format: <kind>:<block>:<address>:<count>[:<min>:<max>[:<period>
+   * [:<rate>]]] where kind is ramp, sine, noise, counter or step and block
+   * is ir (input registers) or di (discrete inputs), e.g.
+   * "sine:ir:0x00:64:0:1000:500:10000"
+   *
+   * @param spec generator specification
+   *
+   * @return generator
+   *
+   * @throw std::invalid_argument if the specification is malformed
+   */
+  static generator_t parse(std::string_view spec);
+
+  /**
+   * Get value of generator at tick
+   *
+   * @param generator generator
+   * @param tick      tick
+   * @param index     index in the generator range
+   *
+   * @return register value
+   */
+  static std::uint16_t value(const generator_t& generator,
+                             std::uint64_t      tick,
+                             std::size_t        index) noexcept;
+
+  /**
+   * Get discrete input of generator at tick
+   *
+   * @param generator generator
+   * @param tick      tick
+   * @param index     index in the generator range
+   *
+   * @return input status
+   */
+  static bool bit(const generator_t& generator,
+                  std::uint64_t      tick,
+                  std::size_t        index) noexcept;
+
+private:
+  /**
+   * Generator state owned by one update thread
+   */
+  struct state_t {
+    /**
+     * Generator
+     */
+    generator_t generator;
+    /**
+     * Next tick
+     */
+    std::uint64_t tick = 0;
+    /**
+     * Interval between ticks
+     */
+    clock::duration interval{};
+    /**
+     * Next tick due time
+     */
+    clock::time_point due;
+    /**
+     * Register buffer
+     */
+    block::registers::container_type registers;
+    /**
+     * Discrete input buffer
+     */
+    block::bits::container_type bits;
+  };
+
+  /**
+   * Update thread loop
+   *
+   * @param states generator states of this thread
+   */
+  void loop(std::vector<state_t> states);
+
+  /**
+   * Write next tick of generator
+   *
+   * @param state generator state
+   */
+  void update(state_t& state);
+
+private:
+  /**
+   * Table to update
+   */
+  table& data_table_;
+  /**
+   * Generators
+   */
+  std::vector<generator_t> generators_;
+  /**
+   * Number of update threads
+   */
+  std::size_t concurrency_;
+  /**
+   * Updated values
+   */
+  std::atomic<std::uint64_t> updates_;
+  /**
+   * Running status
+   */
+  std::atomic<bool> running_;
+  /**
+   * Update threads
+   */
+  std::vector<std::thread> threads_;
+};
+}  // namespace modbus
+
+#endif  // LIB_MODBUS_MODBUS_SIMULATOR_HPP_
@@ -0,0 +1,485 @@
+#ifndef LIB_MODBUS_MODBUS_STATS_HPP_
+#define LIB_MODBUS_MODBUS_STATS_HPP_
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <boost/core/noncopyable.hpp>
+
+#include "constants.hpp"
+#include "utilities.hpp"
+
+namespace modbus {
+namespace stats {
+/**
+ * Request processing stage
+ */
+enum class stage : std::uint8_t {
+  decode,
+  execute,
+  encode,
+  send,
+  max,
+};
+
+/**
+ * Get stage name
+ *
+ * @param value stage
+ *
+ * @return stage name
+ */
+inline constexpr const char* stage_str(stage value) {
+  switch (value) {
+    case stage::decode:
+      return "decode";
+    case stage::execute:
+      return "execute";
+    case stage::encode:
+      return "encode";
+    case stage::send:
+      return "send";
+    default:
+      return "unknown";
+  }
+}
+
+/**
+ * Number of stages
+ */
+static constexpr std::size_t stage_count = utilities::to_underlying(stage::max);
+
+/**
+ * Number of exception codes
+ */
+static constexpr std::size_t exception_count
+    = utilities::to_underlying(constants::exception_code::max);
+
+/**
+ * @brief histogram snapshot
+ *
+ * @author  Ray Andrew
+ * @ingroup Modbus
+ *
+ * Values are nanoseconds, see histogram for bucket layout
+ */
+struct histogram_t {
+  /**
+   * Histogram snapshot constructor
+   */
+  histogram_t();
+
+  /**
+   * Add other snapshot
+   *
+   * @param other other snapshot
+   *
+   * @return instance of snapshot
+   */
+  histogram_t& merge(const histogram_t& other);
+
+  /**
+   * Get value at quantile (upper bound of the matching bucket)
+   *
+   * @param quantile quantile in [0, 1]
+   *
+   * @return value, 0 if empty
+   */
+  std::uint64_t value_at(double quantile) const;
+
+  /**
+   * Get mean value
+   *
+   * @return mean value, 0 if empty
+   */
+  double mean() const;
+
+  /**
+   * Bucket counts
+   */
+  std::vector<std::uint64_t> counts;
+  /**
+   * Number of values
+   */
+  std::uint64_t count;
+  /**
+   * Sum of values
+   */
+  std::uint64_t sum;
+  /**
+   * Max value
+   */
+  std::uint64_t max;
+};
+
+/**
+ * @brief log-linear latency histogram
+ *
+ * @author  Ray Andrew
+ * @ingroup Modbus
+ *
+ * HDR-style buckets: every power of two is split into 16 linear
+ * sub-buckets, giving ~6% relative precision from 1 ns up to ~68 s
+ * (larger values land in the last bucket).
+ *
+ * Single writer (the owning thread), any number of readers. Writes are
+ * relaxed load/store pairs, no read-modify-write instruction is needed.
+ */
+class histogram : private boost::noncopyable {
+public:
+  /**
+   * Sub-bucket bits
+   */
+  static constexpr unsigned int sub_bucket_bits = 4;
+  /**
+   * Sub-buckets per power of two
+   */
+  static constexpr std::uint64_t sub_buckets = 1 << sub_bucket_bits;
+  /**
+   * Values are clamped below 2^max_exponent
+   */
+  static constexpr unsigned int max_exponent = 36;
+  /**
+   * Number of buckets
+   */
+  static constexpr std::size_t bucket_count
+      = (max_exponent - sub_bucket_bits + 1) * sub_buckets;
+
+  /**
+   * Histogram constructor
+   */
+  histogram() noexcept;
+
+  /**
+   * Record value (owning thread only)
+   *
+   * @param value value to record
+   */
+  void record(std::uint64_t value) noexcept;
+
+  /**
+   * Add values to snapshot
+   *
+   * @param out snapshot to add to
+   */
+  void snapshot(histogram_t& out) const;
+
+  /**
+   * Get bucket of value
+   *
+   * @param value value
+   *
+   * @return bucket index
+   */
+  static std::size_t bucket(std::uint64_t value) noexcept;
+
+  /**
+   * Get lowest value of bucket
+   *
+   * @param index bucket index
+   *
+   * @return lowest value
+   */
+  static std::uint64_t lower_bound(std::size_t index) noexcept;
+
+  /**
+   * Get highest value of bucket
+   *
+   * @param index bucket index
+   *
+   * @return highest value
+   */
+  static std::uint64_t upper_bound(std::size_t index) noexcept;
+
+private:
+  /**
+   * Increment counter (single writer)
+   *
+   * @param counter counter
+   * @param value   value to add
+   */
+  inline static void add(std::atomic<std::uint64_t>& counter,
+                         std::uint64_t               value) noexcept {
+    counter.store(counter.load(std::memory_order_relaxed) + value,
+                  std::memory_order_relaxed);
+  }
+
+private:
+  /**
+   * Bucket counts
+   */
+  std::array<std::atomic<std::uint64_t>, bucket_count> counts_;
+  /**
+   * Number of values
+   */
+  std::atomic<std::uint64_t> count_;
+  /**
+   * Sum of values
+   */
+  std::atomic<std::uint64_t> sum_;
+  /**
+   * Max value
+   */
+  std::atomic<std::uint64_t> max_;
+};
+
+/**
+ * @brief stats snapshot
+ *
+ * @author  Ray Andrew
+ * @ingroup Modbus
+ */
+struct snapshot_t {
+  /**
+   * Per function code stats
+   */
+  struct function_t {
+    /**
+     * Number of requests
+     */
+    std::uint64_t requests = 0;
+    /**
+     * Request handling latency (ns)
+     */
+    histogram_t latency;
+  };
+
+  /**
+   * Stats by function code (raw byte, so unknown functions show up too)
+   */
+  std::map<std::uint8_t, function_t> functions;
+  /**
+   * Exception responses / failures by exception code
+   */
+  std::map<constants::exception_code, std::uint64_t> exceptions;
+  /**
+   * Latency by stage (ns)
+   */
+  std::array<histogram_t, stage_count> stages;
+  /**
+   * Number of requests
+   */
+  std::uint64_t requests = 0;
+  /**
+   * Bytes received
+   */
+  std::uint64_t bytes_in = 0;
+  /**
+   * Bytes sent
+   */
+  std::uint64_t bytes_out = 0;
+};
+
+/**
+ * @brief per-thread stats recorder
+ *
+ * @author  Ray Andrew
+ * @ingroup Modbus
+ *
+ * Owned by collector, only written by the thread it was handed to
+ */
+class recorder : private boost::noncopyable {
+public:
+  /**
+   * Recorder constructor
+   */
+  recorder() noexcept;
+
+  /**
+   * Recorder destructor
+   */
+  ~recorder();
+
+  /**
+   * Record handled request
+   *
+   * @param function function code
+   * @param latency  handling latency (ns)
+   */
+  void request(std::uint8_t function, std::uint64_t latency) noexcept;
+
+  /**
+   * Record exception
+   *
+   * @param code exception code
+   */
+  void exception(constants::exception_code code) noexcept;
+
+  /**
+   * Record stage latency
+   *
+   * @param value   stage
+   * @param latency latency (ns)
+   */
+  void stage(stats::stage value, std::uint64_t latency) noexcept;
+
+  /**
+   * Record received bytes
+   *
+   * @param bytes number of bytes
+   */
+  void bytes_in(std::size_t bytes) noexcept;
+
+  /**
+   * Record sent bytes
+   *
+   * @param bytes number of bytes
+   */
+  void bytes_out(std::size_t bytes) noexcept;
+
+  /**
+   * Add values to snapshot
+   *
+   * @param out snapshot to add to
+   */
+  void snapshot(snapshot_t& out) const;
+
+private:
+  /**
+   * Increment counter (single writer)
+   *
+   * @param counter counter
+   * @param value   value to add
+   */
+  inline static void add(std::atomic<std::uint64_t>& counter,
+                         std::uint64_t               value) noexcept {
+    counter.store(counter.load(std::memory_order_relaxed) + value,
+                  std::memory_order_relaxed);
+  }
+
+private:
+  /**
+   * Requests by function code
+   */
+  std::array<std::atomic<std::uint64_t>, 256> requests_;
+  /**
+   * Latency by function code, allocated on first use
+   */
+  std::array<std::atomic<histogram*>, 256> latency_;
+  /**
+   * Exceptions by exception code
+   */
+  std::array<std::atomic<std::uint64_t>, exception_count> exceptions_;
+  /**
+   * Latency by stage
+   */
+  std::array<histogram, stage_count> stages_;
+  /**
+   * Bytes received
+   */
+  std::atomic<std::uint64_t> bytes_in_;
+  /**
+   * Bytes sent
+   */
+  std::atomic<std::uint64_t> bytes_out_;
+};
+
+/**
+ * @brief stats collector
+ *
+ * @author  Ray Andrew
+ * @ingroup Modbus
+ *
+ * Hands every thread its own recorder so recording never contends;
+ * snapshot() merges all recorders
+ */
+class collector : private boost::noncopyable {
+public:
+  /**
+   * Collector constructor
+   */
+  collector() noexcept;
+
+  /**
+   * Get recorder of calling thread
+   *
+   * @return recorder, nullptr if it cannot be allocated
+   */
+  recorder* local() noexcept;
+
+  /**
+   * Get merged snapshot
+   *
+   * @return snapshot
+   */
+  snapshot_t snapshot() const;
+
+private:
+  /**
+   * Instance id, distinguishes thread-local recorders of different
+   * collectors
+   */
+  const std::uint64_t id_;
+  /**
+   * Mutex guarding recorders_
+   */
+  mutable std::mutex mutex_;
+  /**
+   * Recorders
+   */
+  std::vector<std::unique_ptr<recorder>> recorders_;
+};
+
+/**
+ * @brief stopwatch
+ *
+ * @author  Ray Andrew
+ * @ingroup Modbus
+ */
+class stopwatch {
+public:
+  /**
+   * Clock type
+   */
+  typedef std::chrono::steady_clock clock;
+
+  /**
+   * Stopwatch constructor, starts measuring
+   */
+  inline stopwatch() noexcept : start_{clock::now()}, lap_{start_} {}
+
+  /**
+   * Get nanoseconds since previous lap (or start) and start new lap
+   *
+   * @return nanoseconds
+   */
+  inline std::uint64_t lap() noexcept {
+    auto now = clock::now();
+    auto elapsed = now - lap_;
+    lap_ = now;
+    return static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+  }
+
+  /**
+   * Get nanoseconds since start
+   *
+   * @return nanoseconds
+   */
+  inline std::uint64_t elapsed() const noexcept {
+    return static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now()
+                                                             - start_)
+            .count());
+  }
+
+private:
+  /**
+   * Start time
+   */
+  clock::time_point start_;
+  /**
+   * Lap time
+   */
+  clock::time_point lap_;
+};
+}  // namespace stats
+}  // namespace modbus
+
+#endif  // LIB_MODBUS_MODBUS_STATS_HPP_
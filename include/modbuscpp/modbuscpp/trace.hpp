@@ -0,0 +1,425 @@
+#ifndef LIB_MODBUS_MODBUS_TRACE_HPP_
+#define LIB_MODBUS_MODBUS_TRACE_HPP_
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <vector>
+
+#include <boost/core/noncopyable.hpp>
+
+namespace modbus {
+namespace trace {
+/**
+ * Traced event
+ */
+enum class event : std::uint8_t {
+  receive,   /*<< receive to response queued */
+  decode,    /*<< request decoding */
+  execute,   /*<< request execution */
+  lock_wait, /*<< waiting for data table lock */
+  lock_hold, /*<< data table lock held */
+  encode,    /*<< response encoding */
+  send,      /*<< response queued to send completion */
+  max,
+};
+
+/**
+ * Get event name
+ *
+ * @param value event
+ *
+ * @return event name
+ */
+inline constexpr const char* event_str(event value) {
+  switch (value) {
+    case event::receive:
+      return "receive";
+    case event::decode:
+      return "decode";
+    case event::execute:
+      return "execute";
+    case event::lock_wait:
+      return "lock wait";
+    case event::lock_hold:
+      return "lock hold";
+    case event::encode:
+      return "encode";
+    case event::send:
+      return "send";
+    default:
+      return "unknown";
+  }
+}
+
+/**
+ * @brief traced span
+ *
+ * @author  Ray Andrew
+ * @ingroup Modbus
+ */
+struct span_t {
+  /**
+   * Request id, 0 if outside of a request
+   */
+  std::uint64_t request = 0;
+  /**
+   * Begin time (ns, steady clock)
+   */
+  std::uint64_t begin = 0;
+  /**
+   * End time (ns, steady clock)
+   */
+  std::uint64_t end = 0;
+  /**
+   * Thread index
+   */
+  std::uint32_t thread = 0;
+  /**
+   * Event
+   */
+  event what = event::max;
+};
+
+/**
+ * @brief tracer interface
+ *
+ * @author  Ray Andrew
+ * @ingroup Modbus
+ *
+ * Tracing is disabled until a tracer is installed with set(), a disabled
+ * hook costs one relaxed atomic load.
+ *
+ * Usage:
+ * modbus::trace::ring_tracer tracer;
+ * modbus::trace::tracer::set(&tracer);
+ * ...
+ * tracer.dump(std::cout, 1'000'000);  // requests slower than 1 ms
+ */
+class tracer : private boost::noncopyable {
+public:
+  /**
+   * Tracer destructor
+   */
+  virtual ~tracer() = default;
+
+  /**
+   * Record span, called from the thread that ran it
+   *
+   * @param span span
+   */
+  virtual void record(const span_t& span) noexcept = 0;
+
+  /**
+   * Install tracer
+   *
+   * @param instance tracer, nullptr to disable tracing
+   */
+  static void set(tracer* instance) noexcept;
+
+  /**
+   * Uninstall tracer if it is installed
+   *
+   * @param instance tracer
+   */
+  static void unset(tracer* instance) noexcept;
+
+  /**
+   * Get installed tracer
+   *
+   * @return tracer, nullptr if tracing is disabled
+   */
+  inline static tracer* get() noexcept {
+    return instance_.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * Get current time
+   *
+   * @return nanoseconds (steady clock)
+   */
+  inline static std::uint64_t now() noexcept {
+    return static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch())
+            .count());
+  }
+
+  /**
+   * Get index of calling thread
+   *
+   * @return thread index, starting at 1
+   */
+  static std::uint32_t thread() noexcept;
+
+  /**
+   * Start new request on calling thread
+   *
+   * @return request id, unique across threads
+   */
+  static std::uint64_t begin_request() noexcept;
+
+  /**
+   * Get current request of calling thread
+   *
+   * @return request id, 0 if outside of a request
+   */
+  static std::uint64_t current() noexcept;
+
+  /**
+   * Leave current request of calling thread
+   */
+  static void end_request() noexcept;
+
+  /**
+   * Record span to installed tracer
+   *
+   * @param what    event
+   * @param request request id
+   * @param begin   begin time
+   * @param end     end time
+   */
+  static void emit(event         what,
+                   std::uint64_t request,
+                   std::uint64_t begin,
+                   std::uint64_t end) noexcept;
+
+private:
+  /**
+   * Installed tracer
+   */
+  static std::atomic<tracer*> instance_;
+};
+
+/**
+ * @brief scoped span
+ *
+ * @author  Ray Andrew
+ * @ingroup Modbus
+ *
+ * Records span of current request from construction to destruction
+ */
+class span : private boost::noncopyable {
+public:
+  /**
+   * Span constructor
+   *
+   * @param what event
+   */
+  inline explicit span(event what) noexcept
+      : what_{what}, begin_{tracer::get() ? tracer::now() : 0} {}
+
+  /**
+   * Span destructor
+   */
+  inline ~span() {
+    if (begin_ != 0) {
+      tracer::emit(what_, tracer::current(), begin_, tracer::now());
+    }
+  }
+
+private:
+  /**
+   * Event
+   */
+  const event what_;
+  /**
+   * Begin time, 0 if tracing was disabled
+   */
+  const std::uint64_t begin_;
+};
+
+/**
+ * @brief scoped request
+ *
+ * @author  Ray Andrew
+ * @ingroup Modbus
+ *
+ * Assigns request id to spans of calling thread
+ */
+class request_scope : private boost::noncopyable {
+public:
+  /**
+   * Request scope constructor
+   */
+  inline request_scope() noexcept
+      : id_{tracer::get() ? tracer::begin_request() : 0} {}
+
+  /**
+   * Request scope destructor
+   */
+  inline ~request_scope() {
+    if (id_ != 0) {
+      tracer::end_request();
+    }
+  }
+
+  /**
+   * Get request id
+   *
+   * @return request id, 0 if tracing was disabled
+   */
+  inline std::uint64_t id() const noexcept { return id_; }
+
+private:
+  /**
+   * Request id
+   */
+  const std::uint64_t id_;
+};
+
+/**
+ * @brief ring buffer tracer
+ *
+ * @author  Ray Andrew
+ * @ingroup Modbus
+ *
+ * Keeps the latest spans of every thread in a per-thread ring (oldest
+ * spans are overwritten), dumped on demand as Chrome trace_event JSON
+ * (chrome://tracing, Perfetto)
+ */
+class ring_tracer : public tracer {
+public:
+  /**
+   * Ring tracer constructor
+   *
+   * @param capacity spans kept per thread (rounded up to power of two)
+   */
+  explicit ring_tracer(std::size_t capacity = 1 << 14);
+
+  /**
+   * Ring tracer destructor, uninstalls itself if installed
+   */
+  virtual ~ring_tracer() override;
+
+  /**
+   * Record span into ring of calling thread
+   *
+   * @param span span
+   */
+  virtual void record(const span_t& span) noexcept override;
+
+  /**
+   * Get recorded spans
+   *
+   * @return spans sorted by begin time
+   */
+  std::vector<span_t> spans() const;
+
+  /**
+   * Get spans of requests slower than threshold
+   *
+   * @param min_duration minimum receive-to-send duration (ns)
+   *
+   * @return spans sorted by begin time
+   */
+  std::vector<span_t> spans(std::uint64_t min_duration) const;
+
+  /**
+   * Dump spans as Chrome trace_event JSON
+   *
+   * @param os           output stream
+   * @param min_duration only dump requests slower than this (ns)
+   */
+  void dump(std::ostream& os, std::uint64_t min_duration = 0) const;
+
+private:
+  /**
+   * Single-writer ring of spans
+   */
+  class ring {
+  public:
+    /**
+     * Ring constructor
+     *
+     * @param size capacity, power of two
+     */
+    explicit ring(std::size_t size);
+
+    /**
+     * Write span (owning thread)
+     *
+     * @param span span
+     */
+    void push(const span_t& span) noexcept;
+
+    /**
+     * Copy spans (any thread), spans being overwritten are skipped
+     *
+     * @param out spans to append to
+     */
+    void copy(std::vector<span_t>& out) const;
+
+  private:
+    /**
+     * Slot, guarded by sequence number
+     */
+    struct slot_t {
+      /**
+       * Sequence number, odd while being written
+       */
+      std::atomic<std::uint64_t> sequence{0};
+      /**
+       * Request id
+       */
+      std::atomic<std::uint64_t> request{0};
+      /**
+       * Begin time
+       */
+      std::atomic<std::uint64_t> begin{0};
+      /**
+       * End time
+       */
+      std::atomic<std::uint64_t> end{0};
+      /**
+       * Thread index and event
+       */
+      std::atomic<std::uint64_t> tag{0};
+    };
+
+    /**
+     * Slots
+     */
+    std::unique_ptr<slot_t[]> slots_;
+    /**
+     * Index mask
+     */
+    const std::size_t mask_;
+    /**
+     * Number of written spans
+     */
+    std::atomic<std::uint64_t> written_;
+  };
+
+  /**
+   * Get ring of calling thread, registering it on first use
+   *
+   * @return ring, nullptr if it cannot be allocated
+   */
+  ring* local() noexcept;
+
+private:
+  /**
+   * Spans per ring
+   */
+  const std::size_t capacity_;
+  /**
+   * Instance id, distinguishes thread-local rings of different instances
+   */
+  const std::uint64_t id_;
+  /**
+   * Mutex guarding rings_
+   */
+  mutable std::mutex mutex_;
+  /**
+   * Registered rings
+   */
+  std::vector<std::unique_ptr<ring>> rings_;
+};
+}  // namespace trace
+}  // namespace modbus
+
+#endif  // LIB_MODBUS_MODBUS_TRACE_HPP_
@@ -0,0 +1,234 @@
+#ifndef LIB_MODBUS_MODBUS_TRAFFIC_CAPTURE_HPP_
+#define LIB_MODBUS_MODBUS_TRAFFIC_CAPTURE_HPP_
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <boost/core/noncopyable.hpp>
+
+#include "types.hpp"
+#include "utilities.hpp"
+
+namespace modbus {
+/**
+ * @brief binary ADU capture
+ *
+ * @author  Ray Andrew
+ * @ingroup Modbus
+ *
+ * Writes request / response ADUs with nanosecond timestamps and session
+ * id into a memory-mapped ring file. Writing a packet is a timestamp and
+ * a memcpy under a short lock, no syscall is made per packet.
+ *
+ * File layout (host byte order):
+ * - file header (64 bytes): magic "MBCAPTUR", version, chunk size, chunk
+ *   count
+ * - chunks (chunk_size bytes each): chunk header (sequence, used bytes)
+ *   followed by records
+ * - record: timestamp (u64, ns since epoch), session (u64), length (u16),
+ *   direction (u8), reserved (u8), ADU (length bytes)
+ *
+ * Records never cross chunks. When the file is full the oldest chunk is
+ * overwritten, readers order chunks by sequence.
+ *
+ * Only available on POSIX systems.
+ */
+class traffic_capture : private boost::noncopyable {
+public:
+  /**
+   * Packet direction
+   */
+  enum class direction : std::uint8_t {
+    request,
+    response,
+  };
+
+  /**
+   * Initializer
+   */
+  struct initializer_t {
+    /**
+     * Capture file path
+     */
+    std::string path = "modbus.cap";
+    /**
+     * File size in bytes
+     */
+    std::size_t size = 64 * 1024 * 1024;
+    /**
+     * Chunk size in bytes
+     */
+    std::size_t chunk_size = 64 * 1024;
+  };
+
+  /**
+   * Captured record
+   */
+  struct record_t {
+    /**
+     * Timestamp (ns since epoch)
+     */
+    std::uint64_t timestamp = 0;
+    /**
+     * Session id
+     */
+    std::uint64_t session = 0;
+    /**
+     * Direction
+     */
+    traffic_capture::direction dir = traffic_capture::direction::request;
+    /**
+     * ADU
+     */
+    packet_t adu;
+  };
+
+  /**
+   * Pointer type
+   */
+  typedef std::unique_ptr<traffic_capture> pointer;
+
+  /**
+   * Create smart pointer of capture
+   */
+  MAKE_STD_UNIQUE(traffic_capture)
+
+  /**
+   * File magic
+   */
+  static constexpr std::string_view magic = "MBCAPTUR";
+
+  /**
+   * File format version
+   */
+  static constexpr std::uint32_t version = 1;
+
+  /**
+   * File header size
+   */
+  static constexpr std::size_t file_header_size = 64;
+
+  /**
+   * Chunk header size
+   */
+  static constexpr std::size_t chunk_header_size = 16;
+
+  /**
+   * Record header size
+   */
+  static constexpr std::size_t record_header_size = 20;
+
+  /**
+   * Traffic capture constructor, creates (truncates) capture file
+   *
+   * @param initializer initializer
+   *
+   * @throw std::system_error if the file cannot be created or mapped
+   */
+  explicit traffic_capture(const initializer_t& initializer);
+
+  /**
+   * Traffic capture destructor, unmaps capture file
+   */
+  ~traffic_capture();
+
+  /**
+   * Write packet
+   *
+   * @param dir     direction
+   * @param session session id
+   * @param adu     ADU
+   */
+  void write(direction        dir,
+             std::uint64_t    session,
+             std::string_view adu) noexcept;
+
+  /**
+   * Write packet
+   *
+   * @param dir     direction
+   * @param session session id
+   * @param adu     ADU
+   */
+  inline void write(direction       dir,
+                    std::uint64_t   session,
+                    const packet_t& adu) noexcept {
+    write(dir, session, std::string_view{adu.data(), adu.size()});
+  }
+
+  /**
+   * Get number of written packets
+   *
+   * @return number of written packets
+   */
+  inline std::uint64_t written() const noexcept {
+    return written_.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * Read capture file
+   *
+   * @param path capture file path
+   *
+   * @return records in capture order
+   *
+   * @throw ex::bad_data if the file is not a capture file
+   */
+  static std::vector<record_t> read(const std::string& path);
+
+private:
+  /**
+   * Start next chunk
+   */
+  void next_chunk() noexcept;
+
+private:
+  /**
+   * File descriptor
+   */
+  int fd_;
+  /**
+   * Mapped file
+   */
+  char* data_;
+  /**
+   * Mapped size
+   */
+  std::size_t size_;
+  /**
+   * Chunk size
+   */
+  std::size_t chunk_size_;
+  /**
+   * Number of chunks
+   */
+  std::size_t chunk_count_;
+  /**
+   * Mutex guarding the write position
+   */
+  std::mutex mutex_;
+  /**
+   * Current chunk
+   */
+  char* chunk_;
+  /**
+   * Bytes used in current chunk
+   */
+  std::uint32_t used_;
+  /**
+   * Sequence of current chunk
+   */
+  std::uint64_t sequence_;
+  /**
+   * Written packets
+   */
+  std::atomic<std::uint64_t> written_;
+};
+}  // namespace modbus
+
+#endif  // LIB_MODBUS_MODBUS_TRAFFIC_CAPTURE_HPP_
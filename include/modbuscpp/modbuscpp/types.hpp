@@ -8,6 +8,7 @@
 
 #include <fmt/format.h>
 
+#include "adu-buffer.hpp"
 #include "constants.hpp"
 
 namespace modbus {
@@ -27,9 +28,9 @@ struct header_t {
 };
 
 /**
- * Packet type
+ * Packet type, inline storage of max ADU length
  */
-typedef std::vector<char> packet_t;
+typedef adu_buffer packet_t;
 /**
  * Base packet type
  */
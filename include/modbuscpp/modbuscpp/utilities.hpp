@@ -3,7 +3,9 @@
 
 #include <cstdint>
 #include <memory>
+#include <stdexcept>
 #include <string>
+#include <string_view>
 #include <type_traits>
 
 #if defined(WIN32) || defined(_WIN32) \
@@ -92,6 +94,64 @@ inline T unpack(const packet_t&            packet,
   return 0;
 }
 
+/**
+ * Read big-endian 16-bit integer from raw buffer
+ *
+ * @param data pointer to the most significant byte
+ *
+ * @return value in host byte order
+ */
+inline constexpr std::uint16_t read_u16(const char* data) noexcept {
+  return static_cast<std::uint16_t>(
+      (static_cast<std::uint8_t>(data[0]) << 8)
+      | static_cast<std::uint8_t>(data[1]));
+}
+
+/**
+ * Write 16-bit integer to raw buffer in big-endian
+ *
+ * @param data  pointer to the most significant byte
+ * @param value value in host byte order
+ */
+inline void write_u16(char* data, std::uint16_t value) noexcept {
+  data[0] = static_cast<char>(value >> 8);
+  data[1] = static_cast<char>(value & 0xFF);
+}
+
+/**
+ * Append values to packet in big-endian
+ *
+ * Writes in place instead of through a struc::pack temporary. Supports the
+ * B (8-bit) and H (16-bit) codes of struc formats.
+ *
+ * @param packet packet to append to
+ * @param format struc format without byte order prefix, e.g. "HHB"
+ * @param args   values, one per format code
+ */
+template <typename... Args>
+inline void pack_into(packet_t& packet, std::string_view format, Args... args) {
+  if (format.size() != sizeof...(Args)) {
+    throw std::invalid_argument("Format does not match arguments");
+  }
+
+  std::size_t idx = 0;
+  auto        append = [&](std::uint32_t value) {
+    switch (format[idx++]) {
+      case 'B':
+        packet.push_back(static_cast<char>(value & 0xFF));
+        break;
+      case 'H':
+        packet.push_back(static_cast<char>((value >> 8) & 0xFF));
+        packet.push_back(static_cast<char>(value & 0xFF));
+        break;
+      default:
+        throw std::invalid_argument("Unsupported format code");
+    }
+  };
+
+  (append(static_cast<std::uint32_t>(args)), ...);
+}
+
 inline std::string packet_str(const packet_t& packet) {
   packet_t::size_type index = 0;
 
@@ -0,0 +1,244 @@
+#ifndef LIB_MODBUS_MODBUS_WRITE_COALESCER_HPP_
+#define LIB_MODBUS_MODBUS_WRITE_COALESCER_HPP_
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <boost/core/noncopyable.hpp>
+
+#include "constants.hpp"
+#include "data-table.hpp"
+#include "types.hpp"
+
+namespace modbus {
+// forward declarations
+namespace internal {
+class request;
+}
+
+/**
+ * @brief write coalescer
+ *
+ * @author  Ray Andrew
+ * @ingroup Modbus
+ *
+ * Collects single register / single coil writes issued within a short
+ * window and merges writes to adjacent addresses of the same unit into
+ * request::write_multiple_registers / request::write_multiple_coils.
+ *
+ * Ordering semantics:
+ * - a write is only merged into the most recent pending run of its unit,
+ *   so writes of one unit leave in the order they were issued
+ * - a write to an address already pending starts a new run instead of
+ *   overwriting the pending value
+ * - runs never exceed max_num_regs_write / max_num_bits_write
+ */
+class write_coalescer : private boost::noncopyable {
+public:
+  /**
+   * Clock type
+   */
+  typedef std::chrono::steady_clock clock;
+
+  /**
+   * Initializer
+   */
+  struct initializer_t {
+    /**
+     * Time a run may wait for adjacent writes
+     */
+    clock::duration window = std::chrono::milliseconds(5);
+    /**
+     * Max registers per request
+     */
+    std::uint16_t max_registers = constants::max_num_regs_write;
+    /**
+     * Max coils per request
+     */
+    std::uint16_t max_coils = constants::max_num_bits_write;
+  };
+
+  /**
+   * Merged request ready to be sent
+   */
+  struct batch_t {
+    /**
+     * Unit id (already set on request)
+     */
+    std::uint8_t unit;
+    /**
+     * Request, transaction id is left to the caller
+     */
+    std::unique_ptr<internal::request> request;
+    /**
+     * Number of single writes merged into request
+     */
+    std::size_t writes;
+  };
+
+  /**
+   * Write coalescer constructor
+   */
+  explicit write_coalescer() noexcept;
+
+  /**
+   * Write coalescer constructor
+   *
+   * @param initializer initializer
+   */
+  explicit write_coalescer(const initializer_t& initializer) noexcept;
+
+  /**
+   * Queue single register write
+   *
+   * @param unit    unit id
+   * @param address register address
+   * @param value   register value
+   * @param now     time of write
+   */
+  void write_register(std::uint8_t       unit,
+                      const address_t&   address,
+                      const reg_value_t& value,
+                      clock::time_point  now = clock::now());
+
+  /**
+   * Queue single coil write
+   *
+   * @param unit    unit id
+   * @param address coil address
+   * @param value   coil value
+   * @param now     time of write
+   */
+  void write_coil(std::uint8_t      unit,
+                  const address_t&  address,
+                  bool              value,
+                  clock::time_point now = clock::now());
+
+  /**
+   * Take runs whose window has elapsed or that cannot grow anymore
+   *
+   * @param now current time
+   *
+   * @return batches in issue order
+   */
+  std::vector<batch_t> poll(clock::time_point now = clock::now());
+
+  /**
+   * Take every pending run
+   *
+   * @return batches in issue order
+   */
+  std::vector<batch_t> flush();
+
+  /**
+   * Get time at which the oldest pending run is due
+   *
+   * @return deadline, clock::time_point::max() if nothing is pending
+   */
+  clock::time_point deadline() const;
+
+  /**
+   * Get number of pending runs
+   *
+   * @return number of pending runs
+   */
+  std::size_t pending() const;
+
+private:
+  /**
+   * Pending run of adjacent writes
+   */
+  struct run_t {
+    /**
+     * Unit id
+     */
+    std::uint8_t unit;
+    /**
+     * Run of coils or registers
+     */
+    bool coils;
+    /**
+     * First address
+     */
+    std::uint32_t address;
+    /**
+     * Register values
+     */
+    block::registers::container_type registers;
+    /**
+     * Coil values
+     */
+    block::bits::container_type bits;
+    /**
+     * Time of first write
+     */
+    clock::time_point since;
+    /**
+     * Number of merged writes
+     */
+    std::size_t writes;
+
+    /**
+     * Get number of values
+     *
+     * @return number of values
+     */
+    inline std::size_t size() const {
+      return coils ? bits.size() : registers.size();
+    }
+  };
+
+  /**
+   * Queue write, mutex_ must be held
+   *
+   * @param unit    unit id
+   * @param coils   coil or register write
+   * @param address address
+   * @param value   value
+   * @param now     time of write
+   */
+  void push(std::uint8_t      unit,
+            bool              coils,
+            std::uint32_t     address,
+            std::uint16_t     value,
+            clock::time_point now);
+
+  /**
+   * Check if run reached max size
+   *
+   * @param run run to check
+   *
+   * @return true if run is full
+   */
+  bool full(const run_t& run) const;
+
+  /**
+   * Build request out of run
+   *
+   * @param run run to convert
+   *
+   * @return batch
+   */
+  static batch_t make_batch(run_t& run);
+
+private:
+  /**
+   * Initializer
+   */
+  initializer_t initializer_;
+  /**
+   * Mutex
+   */
+  mutable std::mutex mutex_;
+  /**
+   * Pending runs in issue order
+   */
+  std::deque<run_t> runs_;
+};
+}  // namespace modbus
+
+#endif  // LIB_MODBUS_MODBUS_WRITE_COALESCER_HPP_
@@ -0,0 +1,83 @@
+#include <modbuscpp/modbuscpp/access-heatmap.hpp>
+
+#include <algorithm>
+
+namespace modbus {
+access_heatmap::access_heatmap(const address_t& starting_address,
+                               std::size_t      capacity)
+    : starting_address_{starting_address()},
+      capacity_{capacity},
+      bucket_count_{std::max<std::size_t>(
+          (capacity + bucket_size - 1) >> bucket_bits, 1)},
+      enabled_{false},
+      reads_{new std::atomic<std::uint64_t>[bucket_count_]},
+      writes_{new std::atomic<std::uint64_t>[bucket_count_]} {
+  reset();
+}
+
+void access_heatmap::record(std::atomic<std::uint64_t>* counters,
+                            const address_t&            address,
+                            std::size_t                 count) noexcept {
+  if (count == 0 || address() < starting_address_) {
+    return;
+  }
+
+  std::size_t offset = address() - starting_address_;
+
+  if (offset >= capacity_) {
+    return;
+  }
+
+  auto first = offset >> bucket_bits;
+  auto last = std::min(offset + count - 1, capacity_ - 1) >> bucket_bits;
+
+  for (auto bucket = first; bucket <= last; ++bucket) {
+    counters[bucket].fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+std::vector<access_heatmap::range_t> access_heatmap::ranges() const {
+  std::vector<range_t> out;
+
+  for (std::size_t bucket = 0; bucket < bucket_count_; ++bucket) {
+    range_t range;
+    range.reads = reads_[bucket].load(std::memory_order_relaxed);
+    range.writes = writes_[bucket].load(std::memory_order_relaxed);
+
+    if (range.accesses() == 0) {
+      continue;
+    }
+
+    auto offset = bucket << bucket_bits;
+    auto last = std::min(offset + bucket_size, capacity_) - 1;
+    range.first = static_cast<std::uint16_t>(starting_address_ + offset);
+    range.last = static_cast<std::uint16_t>(starting_address_ + last);
+    out.push_back(range);
+  }
+
+  return out;
+}
+
+std::vector<access_heatmap::range_t> access_heatmap::hottest(
+    std::size_t limit) const {
+  auto out = ranges();
+
+  std::stable_sort(out.begin(), out.end(),
+                   [](const auto& lhs, const auto& rhs) {
+                     return lhs.accesses() > rhs.accesses();
+                   });
+
+  if (out.size() > limit) {
+    out.resize(limit);
+  }
+
+  return out;
+}
+
+void access_heatmap::reset() noexcept {
+  for (std::size_t bucket = 0; bucket < bucket_count_; ++bucket) {
+    reads_[bucket].store(0, std::memory_order_relaxed);
+    writes_[bucket].store(0, std::memory_order_relaxed);
+  }
+}
+}  // namespace modbus
@@ -102,6 +102,10 @@ adu& adu::unit(std::uint8_t new_unit) {
 }
 
 void adu::decode_header(const packet_t& packet) {
+  decode_header(std::string_view{packet.data(), packet.size()});
+}
+
+void adu::decode_header(std::string_view packet) {
   std::uint16_t temp;
   struc::unpack(fmt::format(">{}", header_func_format), packet.data(),
                 transaction_, temp, length_, unit_, function_code_);
@@ -111,6 +115,22 @@ void adu::decode_header(const packet_t& packet) {
   }
 }
 
+std::size_t adu::frame_size(std::string_view stream) noexcept {
+  if (stream.size() < length_idx + 2) {
+    return 0;
+  }
+
+  // MBAP length counts the unit id and the PDU
+  std::size_t size = length_idx + 2 + utilities::read_u16(stream.data() + length_idx);
+
+  if (size <= header_length || size > max_length) {
+    // no way to find the next request, hand everything to the handler
+    return stream.size();
+  }
+
+  return size <= stream.size() ? size : 0;
+}
+
 bool adu::operator==(const adu& other) const {
   return transaction_ && other.transaction_;
 }
@@ -124,9 +144,9 @@ bool adu::operator<(const adu& other) const {
 }
 
 packet_t adu::header_packet() {
-  packet_t packet
-      = struc::pack(fmt::format(">{}", header_func_format), transaction_,
-                    protocol, length_, unit_, function_code_);
+  packet_t packet;
+  utilities::pack_into(packet, header_func_format, transaction_, protocol,
+                       length_, unit_, function_code_);
   return packet;
 }
 
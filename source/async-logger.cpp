@@ -0,0 +1,293 @@
+#include <modbuscpp/modbuscpp/async-logger.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <map>
+
+#include <fmt/format.h>
+
+namespace modbus {
+namespace {
+/**
+ * Round up to power of two
+ *
+ * @param value value to round
+ *
+ * @return power of two >= value
+ */
+std::size_t round_up_pow2(std::size_t value) {
+  std::size_t result = 1;
+
+  while (result < value) {
+    result <<= 1;
+  }
+
+  return result;
+}
+
+/**
+ * Instance ids
+ */
+std::atomic<std::uint64_t> next_id{1};
+}  // namespace
+
+async_logger::ring::ring(std::size_t size)
+    : slots_(round_up_pow2(std::max<std::size_t>(size, 2))),
+      mask_{slots_.size() - 1},
+      head_{0},
+      tail_{0},
+      retired_{false} {}
+
+internal::log_record* async_logger::ring::acquire() noexcept {
+  auto tail = tail_.load(std::memory_order_relaxed);
+
+  if (tail - head_.load(std::memory_order_acquire) == slots_.size()) {
+    return nullptr;
+  }
+
+  return &slots_[tail & mask_];
+}
+
+void async_logger::ring::commit() noexcept {
+  tail_.store(tail_.load(std::memory_order_relaxed) + 1,
+              std::memory_order_release);
+}
+
+const internal::log_record* async_logger::ring::front() const noexcept {
+  auto head = head_.load(std::memory_order_relaxed);
+
+  if (head == tail_.load(std::memory_order_acquire)) {
+    return nullptr;
+  }
+
+  return &slots_[head & mask_];
+}
+
+void async_logger::ring::pop() noexcept {
+  head_.store(head_.load(std::memory_order_relaxed) + 1,
+              std::memory_order_release);
+}
+
+void async_logger::ring::retire() noexcept {
+  retired_.store(true, std::memory_order_release);
+}
+
+bool async_logger::ring::retired() const noexcept {
+  return retired_.load(std::memory_order_acquire);
+}
+
+async_logger::async_logger() : async_logger{initializer_t{}} {}
+
+async_logger::async_logger(const initializer_t& initializer)
+    : logger{initializer.debug},
+      initializer_{initializer},
+      id_{next_id++},
+      dropped_{0},
+      reported_{0},
+      written_{0},
+      tokens_{static_cast<double>(initializer.burst)},
+      refilled_at_{std::chrono::steady_clock::now()},
+      running_{true} {
+  deferred_ = true;
+  thread_ = std::thread(&async_logger::run, this);
+}
+
+async_logger::~async_logger() { stop(); }
+
+void async_logger::stop() {
+  {
+    std::lock_guard<std::mutex> lock(wake_mutex_);
+    running_ = false;
+  }
+
+  wake_.notify_one();
+
+  if (thread_.joinable()) {
+    thread_.join();
+    drain();
+  }
+}
+
+void async_logger::flush() { drain(); }
+
+void async_logger::write(level lvl, const std::string& message) const noexcept {
+  std::fputs(message.c_str(), lvl == level::error ? stderr : stdout);
+  std::fputc('\n', lvl == level::error ? stderr : stdout);
+}
+
+void async_logger::info_impl(const std::string& message) const noexcept {
+  push(level::info, message);
+}
+
+void async_logger::error_impl(const std::string& message) const noexcept {
+  push(level::error, message);
+}
+
+void async_logger::debug_impl(const std::string& message) const noexcept {
+  push(level::debug, message);
+}
+
+void async_logger::push(level lvl, const std::string& message) const noexcept {
+  if (auto* record = acquire()) {
+    record->level = static_cast<std::uint8_t>(lvl);
+    record->pack(std::string_view{message});
+    commit(record);
+  }
+}
+
+async_logger::ring* async_logger::local_ring() const noexcept {
+  // trivially destructible, still readable by later thread_local dtors
+  thread_local std::uint64_t owner = 0;
+  thread_local ring*         local = nullptr;
+  thread_local bool          exited = false;
+
+  /**
+   * Rings of calling thread, retired when the thread exits
+   */
+  struct registry {
+    ~registry() {
+      for (auto& entry : known) {
+        entry.second->retire();
+      }
+
+      owner = 0;
+      local = nullptr;
+      exited = true;
+    }
+
+    std::map<std::uint64_t, std::shared_ptr<ring>> known;
+  };
+
+  thread_local registry rings;
+
+  if (owner == id_) {
+    return local;
+  }
+
+  if (exited) {
+    return nullptr;
+  }
+
+  try {
+    auto it = rings.known.find(id_);
+
+    if (it == rings.known.end()) {
+      // only this thread still holds rings of destroyed instances
+      for (auto stale = rings.known.begin(); stale != rings.known.end();) {
+        stale = stale->second.use_count() == 1 ? rings.known.erase(stale)
+                                               : std::next(stale);
+      }
+
+      auto created = std::make_shared<ring>(initializer_.ring_size);
+      std::lock_guard<std::mutex> lock(mutex_);
+      rings_.push_back(created);
+      it = rings.known.emplace(id_, std::move(created)).first;
+    }
+
+    owner = id_;
+    local = it->second.get();
+  } catch (...) {
+    return nullptr;
+  }
+
+  return local;
+}
+
+internal::log_record* async_logger::acquire() const noexcept {
+  auto* local = local_ring();
+  auto* record = local != nullptr ? local->acquire() : nullptr;
+
+  if (record == nullptr) {
+    dropped_.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  return record;
+}
+
+void async_logger::commit(
+    [[maybe_unused]] internal::log_record* record) const noexcept {
+  // acquire() succeeded on this thread, so the thread's ring exists
+  local_ring()->commit();
+}
+
+void async_logger::run() {
+  std::unique_lock<std::mutex> lock(wake_mutex_);
+
+  while (running_) {
+    wake_.wait_for(lock, initializer_.interval, [this] { return !running_; });
+    lock.unlock();
+    drain();
+    lock.lock();
+  }
+}
+
+bool async_logger::take_token(std::chrono::steady_clock::time_point now) {
+  if (initializer_.max_rate == 0) {
+    return true;
+  }
+
+  std::chrono::duration<double> elapsed = now - refilled_at_;
+  refilled_at_ = now;
+  tokens_ = std::min<double>(initializer_.burst,
+                             tokens_ + elapsed.count() * initializer_.max_rate);
+
+  if (tokens_ < 1.0) {
+    return false;
+  }
+
+  tokens_ -= 1.0;
+  return true;
+}
+
+void async_logger::drain() {
+  std::lock_guard<std::mutex> drain_lock(drain_mutex_);
+
+  {
+    // registering threads only wait for this copy, never for formatting
+    std::lock_guard<std::mutex> lock(mutex_);
+    snapshot_.clear();
+
+    // retired before checked empty, so no record can follow
+    rings_.erase(std::remove_if(rings_.begin(), rings_.end(),
+                                [](const auto& local) {
+                                  return local->retired()
+                                         && local->front() == nullptr;
+                                }),
+                 rings_.end());
+
+    for (auto& local : rings_) {
+      snapshot_.push_back(local.get());
+    }
+  }
+
+  for (auto* local : snapshot_) {
+    while (const auto* record = local->front()) {
+      if (take_token(std::chrono::steady_clock::now())) {
+        buffer_.clear();
+
+        try {
+          record->to_string(buffer_);
+          write(static_cast<level>(record->level), buffer_);
+          written_++;
+        } catch (...) {
+          dropped_++;
+        }
+      } else {
+        dropped_++;
+      }
+
+      local->pop();
+    }
+  }
+
+  auto dropped = dropped_.load();
+
+  if (dropped != reported_) {
+    write(level::error, fmt::format("{} log messages dropped (total {})",
+                                    dropped - reported_, dropped));
+    reported_ = dropped;
+  }
+
+  std::fflush(stdout);
+}
+}  // namespace modbus
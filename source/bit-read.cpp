@@ -89,16 +89,15 @@ packet_t base_read_bits<constants::function_code::read_coils>::encode() {
   try {
     const auto& [start, end]
         = data_table()->coils().get(request_->address(), request_->count());
+    data_table()->coils().heatmap().read(request_->address(),
+                                         request_->count()());
 
-    bits_ = block::bits::container_type{start, end};
+    bits_.assign(start, end);
     calc_length(request_->byte_count() + 1);
     packet_t packet = header_packet();
     packet.reserve(request_->response_size());
-    packet_t pdu
-        = struc::pack(fmt::format(">{}", format), request_->byte_count());
-    packet_t bits = op::pack_bits(start, end);
-    packet.insert(packet.end(), pdu.begin(), pdu.end());
-    packet.insert(packet.end(), bits.begin(), bits.end());
+    utilities::pack_into(packet, format, request_->byte_count());
+    op::pack_bits(packet, bits_.begin(), bits_.end());
 
     if (!request_->check_response_packet(packet)) {
       throw ex::server_device_failure(function(), header());
@@ -130,16 +129,15 @@ base_read_bits<constants::function_code::read_discrete_inputs>::encode() {
   try {
     const auto& [start, end] = data_table()->discrete_inputs().get(
         request_->address(), request_->count());
+    data_table()->discrete_inputs().heatmap().read(request_->address(),
+                                                   request_->count()());
 
-    bits_ = block::bits::container_type{start, end};
+    bits_.assign(start, end);
     calc_length(request_->byte_count() + 1);
     packet_t packet = header_packet();
     packet.reserve(request_->response_size());
-    packet_t pdu
-        = struc::pack(fmt::format(">{}", format), request_->byte_count());
-    packet_t bits = op::pack_bits(start, end);
-    packet.insert(packet.end(), pdu.begin(), pdu.end());
-    packet.insert(packet.end(), bits.begin(), bits.end());
+    utilities::pack_into(packet, format, request_->byte_count());
+    op::pack_bits(packet, bits_.begin(), bits_.end());
 
     if (!request_->check_response_packet(packet)) {
       throw ex::server_device_failure(function(), header());
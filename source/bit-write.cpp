@@ -4,8 +4,10 @@
 #include <exception>
 #include <iterator>
 
+#include <modbuscpp/modbuscpp/data-table.inline.hpp>
 #include <modbuscpp/modbuscpp/exception.hpp>
 #include <modbuscpp/modbuscpp/logger.hpp>
+#include <modbuscpp/modbuscpp/memory-pool.hpp>
 #include <modbuscpp/modbuscpp/operation.hpp>
 #include <modbuscpp/modbuscpp/struct.hpp>
 #include <modbuscpp/modbuscpp/utilities.hpp>
@@ -30,9 +32,8 @@ packet_t write_single_coil::encode() {
   calc_length(data_length);
   packet_t packet = header_packet();
   packet.reserve(header_length + 1 + data_length);
-  packet_t pdu = struc::pack(fmt::format(">{}", format), address_(),
-                             utilities::to_underlying(value_));
-  packet.insert(packet.end(), pdu.begin(), pdu.end());
+  utilities::pack_into(packet, format, address_(),
+                       utilities::to_underlying(value_));
   return packet;
 }
 
@@ -89,7 +90,18 @@ write_multiple_coils::write_multiple_coils(
     : internal::request{constants::function_code::write_multiple_coils},
       address_{address},
       count_{count},
-      values_(values) {
+      values_(values, memory_pool::get()) {
+  byte_count_ = byte_count();
+}
+
+write_multiple_coils::write_multiple_coils(
+    const address_t&            address,
+    const write_num_bits_t&     count,
+    block::bits::container_type values) noexcept
+    : internal::request{constants::function_code::write_multiple_coils},
+      address_{address},
+      count_{count},
+      values_(values.begin(), values.end(), memory_pool::get()) {
   byte_count_ = byte_count();
 }
 
@@ -101,13 +113,9 @@ packet_t write_multiple_coils::encode() {
   calc_length(data_length());
   packet_t packet = header_packet();
   packet.reserve(header_length + data_length());
-  packet_t pdu = struc::pack(fmt::format(">{}", format), address_(), count_(),
-                             byte_count());
-  packet.insert(packet.end(), pdu.begin(), pdu.end());
-
-  packet_t values_packet = op::pack_bits(values_.begin(), values_.end());
+  utilities::pack_into(packet, format, address_(), count_(), byte_count());
 
-  packet.insert(packet.end(), values_packet.begin(), values_packet.end());
+  op::pack_bits(packet, values_.begin(), values_.end());
 
   if (packet.size() != (data_length() + header_length + 1)) {
     throw ex::bad_data();
@@ -129,7 +137,8 @@ void write_multiple_coils::decode(const packet_t& packet) {
     struc::unpack(fmt::format(">{}", format), packet.data() + header_length + 1,
                   address_.ref(), count_.ref(), byte_count_recv);
     byte_count_ = byte_count_recv;
-    values_ = op::unpack_bits(packet.begin() + values_idx, packet.end());
+    values_ = op::unpack_bits(packet.begin() + values_idx, packet.end(),
+                              values_.get_allocator());
     values_.resize(count_());
   } catch (...) {
     throw ex::server_device_failure(function(), header());
@@ -154,13 +163,14 @@ typename packet_t::size_type write_multiple_coils::response_size() const {
 }
 
 std::uint8_t write_multiple_coils::byte_count() const {
-  std::uint8_t byte_count = static_cast<std::uint8_t>(count_()) / 8;
-  std::uint8_t remainder = static_cast<std::uint8_t>(count_()) % 8;
+  // count goes up to 0x7B0, divide before narrowing
+  std::uint16_t byte_count = count_() / 8;
+  std::uint16_t remainder = count_() % 8;
 
   if (remainder)
     byte_count++;
 
-  return byte_count;
+  return static_cast<std::uint8_t>(byte_count);
 }
 
 std::ostream& write_multiple_coils::dump(std::ostream& os) const {
@@ -192,10 +202,8 @@ packet_t write_single_coil::encode() {
     calc_length(data_length);
     packet_t packet = header_packet();
     packet.reserve(request_->response_size());
-    packet_t pdu
-        = struc::pack(fmt::format(">{}", format), request_->address()(),
-                      utilities::to_underlying(value_));
-    packet.insert(packet.end(), pdu.begin(), pdu.end());
+    utilities::pack_into(packet, format, request_->address()(),
+                         utilities::to_underlying(value_));
 
     if (!request_->check_response_packet(packet)) {
       throw ex::server_device_failure(function(), header());
@@ -203,6 +211,7 @@ packet_t write_single_coil::encode() {
 
     data_table()->coils().set(request_->address(),
                               request_->value() == value::bits::on);
+    data_table()->coils().heatmap().write(request_->address(), 1);
     return packet;
   } catch (const std::out_of_range&) {
     throw ex::illegal_data_address(function(), header());
@@ -264,10 +273,12 @@ packet_t write_multiple_coils::encode() {
     calc_length(data_length);
     packet_t packet = header_packet();
     packet.reserve(request_->response_size());
-    packet_t pdu = struc::pack(fmt::format(">{}", format),
-                               request_->address()(), request_->count()());
-    packet.insert(packet.end(), pdu.begin(), pdu.end());
-    data_table()->coils().set(request_->address(), request_->values());
+    utilities::pack_into(packet, format, request_->address()(),
+                         request_->count()());
+    data_table()->coils().set(request_->address(), request_->values().begin(),
+                              request_->values().end());
+    data_table()->coils().heatmap().write(request_->address(),
+                                          request_->count()());
     return packet;
   } catch (const std::out_of_range&) {
     throw ex::illegal_data_address(function(), header());
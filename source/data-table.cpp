@@ -7,4 +7,30 @@ table::table(const table::initializer_t& initializer) noexcept
       discrete_inputs_{initializer.discrete_inputs},
       holding_registers_{initializer.holding_registers},
       input_registers_{initializer.input_registers} {}
+
+void table::instrument_locks(bool enabled) noexcept {
+  coils_.instrument_lock(enabled);
+  discrete_inputs_.instrument_lock(enabled);
+  holding_registers_.instrument_lock(enabled);
+  input_registers_.instrument_lock(enabled);
+}
+
+table::lock_stats_t table::lock_stats() const {
+  return {coils_.lock_stats(), discrete_inputs_.lock_stats(),
+          holding_registers_.lock_stats(), input_registers_.lock_stats()};
+}
+
+void table::reset_lock_stats() noexcept {
+  coils_.reset_lock_stats();
+  discrete_inputs_.reset_lock_stats();
+  holding_registers_.reset_lock_stats();
+  input_registers_.reset_lock_stats();
+}
+
+void table::enable_heatmap(bool enabled) noexcept {
+  coils_.heatmap().enable(enabled);
+  discrete_inputs_.heatmap().enable(enabled);
+  holding_registers_.heatmap().enable(enabled);
+  input_registers_.heatmap().enable(enabled);
+}
 }  // namespace modbus
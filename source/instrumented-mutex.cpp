@@ -0,0 +1,106 @@
+#include <modbuscpp/modbuscpp/instrumented-mutex.hpp>
+
+namespace modbus {
+namespace {
+/**
+ * Raise counter to value
+ *
+ * @param counter counter
+ * @param value   value
+ */
+inline void raise(std::atomic<std::uint64_t>& counter, std::uint64_t value) {
+  auto current = counter.load(std::memory_order_relaxed);
+
+  while (value > current
+         && !counter.compare_exchange_weak(current, value,
+                                           std::memory_order_relaxed)) {
+  }
+}
+
+/**
+ * Copy counters of access kind
+ *
+ * @param counters counters
+ * @param out      snapshot
+ */
+template <typename counters_t>
+void copy(const counters_t& counters, lock_stats_t::access_t& out) {
+  out.acquisitions = counters.acquisitions.load(std::memory_order_relaxed);
+  out.contended = counters.contended.load(std::memory_order_relaxed);
+  out.wait_time = counters.wait_time.load(std::memory_order_relaxed);
+  out.max_wait_time = counters.max_wait_time.load(std::memory_order_relaxed);
+  out.hold_time = counters.hold_time.load(std::memory_order_relaxed);
+  out.max_hold_time = counters.max_hold_time.load(std::memory_order_relaxed);
+}
+
+/**
+ * Reset counters of access kind
+ *
+ * @param counters counters
+ */
+template <typename counters_t>
+void clear(counters_t& counters) {
+  counters.acquisitions.store(0, std::memory_order_relaxed);
+  counters.contended.store(0, std::memory_order_relaxed);
+  counters.wait_time.store(0, std::memory_order_relaxed);
+  counters.max_wait_time.store(0, std::memory_order_relaxed);
+  counters.hold_time.store(0, std::memory_order_relaxed);
+  counters.max_hold_time.store(0, std::memory_order_relaxed);
+}
+}  // namespace
+
+instrumented_mutex::instrumented_mutex() noexcept : enabled_{false} {}
+
+std::uint64_t instrumented_mutex::acquire_slow(access kind) {
+  bool instrumented = enabled_.load(std::memory_order_relaxed);
+  auto begin = trace::tracer::now();
+  bool contended = !mutex_.try_lock();
+
+  if (contended) {
+    mutex_.lock();
+  }
+
+  auto acquired = contended ? trace::tracer::now() : begin;
+
+  if (instrumented) {
+    auto& target = counters(kind);
+    target.acquisitions.fetch_add(1, std::memory_order_relaxed);
+
+    if (contended) {
+      target.contended.fetch_add(1, std::memory_order_relaxed);
+      target.wait_time.fetch_add(acquired - begin, std::memory_order_relaxed);
+      raise(target.max_wait_time, acquired - begin);
+    }
+  }
+
+  trace::tracer::emit(trace::event::lock_wait, trace::tracer::current(), begin,
+                      acquired);
+  return acquired;
+}
+
+void instrumented_mutex::release_slow(access kind, std::uint64_t acquired) {
+  auto released = trace::tracer::now();
+  mutex_.unlock();
+
+  if (enabled_.load(std::memory_order_relaxed)) {
+    auto& target = counters(kind);
+    target.hold_time.fetch_add(released - acquired, std::memory_order_relaxed);
+    raise(target.max_hold_time, released - acquired);
+  }
+
+  trace::tracer::emit(trace::event::lock_hold, trace::tracer::current(),
+                      acquired, released);
+}
+
+lock_stats_t instrumented_mutex::stats() const {
+  lock_stats_t out;
+  copy(read_, out.read);
+  copy(write_, out.write);
+  return out;
+}
+
+void instrumented_mutex::reset_stats() noexcept {
+  clear(read_);
+  clear(write_);
+}
+}  // namespace modbus
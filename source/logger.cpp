@@ -3,7 +3,7 @@
 namespace modbus {
 logger* logger::instance_ = nullptr;
 
-logger::logger(bool debug) : debug_{debug} {}
+logger::logger(bool debug) : debug_{debug}, deferred_{false} {}
 
 logger::~logger() {}
 
@@ -20,12 +20,12 @@ void logger::info_impl(const std::string& message) const noexcept {
 }
 
 void logger::error_impl(const std::string& message) const noexcept {
-  info(message);
+  info_impl(message);
 }
 
 void logger::debug_impl(const std::string& message) const noexcept {
   if (debug_) {
-    info(message);
+    info_impl(message);
   }
 }
 }  // namespace modbus
@@ -0,0 +1,174 @@
+#include <modbuscpp/modbuscpp/memory-pool.hpp>
+
+#include <new>
+
+namespace modbus {
+namespace {
+/**
+ * Number of size classes, min_block_size .. max_block_size
+ */
+constexpr std::size_t size_classes = 6;
+
+static_assert(memory_pool::min_block_size << (size_classes - 1)
+                  == memory_pool::max_block_size,
+              "size classes must cover min_block_size .. max_block_size");
+
+/**
+ * Free block
+ */
+struct node_t {
+  node_t* next;
+};
+
+/**
+ * Free lists of one thread
+ */
+struct cache_t {
+  /**
+   * Free list heads per size class
+   */
+  node_t* heads[size_classes] = {};
+  /**
+   * Free list lengths per size class
+   */
+  std::size_t counts[size_classes] = {};
+
+  /**
+   * Cache destructor, returns every block upstream
+   */
+  ~cache_t();
+
+  /**
+   * Return every block upstream
+   */
+  void release() noexcept;
+};
+
+/**
+ * Set once the cache of this thread is destroyed, blocks freed during
+ * thread / static teardown after that go straight upstream
+ */
+thread_local bool cache_destroyed = false;
+
+/**
+ * Cache of this thread
+ */
+thread_local cache_t cache;
+
+cache_t::~cache_t() {
+  release();
+  cache_destroyed = true;
+}
+
+void cache_t::release() noexcept {
+  for (std::size_t idx = 0; idx < size_classes; ++idx) {
+    while (heads[idx] != nullptr) {
+      node_t* node = heads[idx];
+      heads[idx] = node->next;
+      ::operator delete(node);
+    }
+
+    counts[idx] = 0;
+  }
+}
+
+/**
+ * Get size class of block
+ *
+ * @param bytes block size, at most max_block_size
+ *
+ * @return size class
+ */
+inline std::size_t size_class(std::size_t bytes) noexcept {
+  std::size_t index = 0;
+
+  for (std::size_t size = memory_pool::min_block_size; size < bytes;
+       size <<= 1) {
+    ++index;
+  }
+
+  return index;
+}
+
+/**
+ * Check if block is served by the free lists
+ *
+ * @param bytes     block size
+ * @param alignment block alignment
+ *
+ * @return true if pooled
+ */
+inline bool pooled(std::size_t bytes, std::size_t alignment) noexcept {
+  return bytes <= memory_pool::max_block_size
+         && alignment <= __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+}
+}  // namespace
+
+memory_pool* memory_pool::get() noexcept {
+  static memory_pool pool;
+  return &pool;
+}
+
+std::size_t memory_pool::cached() noexcept {
+  if (cache_destroyed) {
+    return 0;
+  }
+
+  std::size_t total = 0;
+
+  for (auto count : cache.counts) {
+    total += count;
+  }
+
+  return total;
+}
+
+void memory_pool::release() noexcept {
+  if (!cache_destroyed) {
+    cache.release();
+  }
+}
+
+void* memory_pool::do_allocate(std::size_t bytes, std::size_t alignment) {
+  if (!pooled(bytes, alignment)) {
+    return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+  }
+
+  auto index = size_class(bytes);
+
+  if (!cache_destroyed && cache.heads[index] != nullptr) {
+    node_t* node = cache.heads[index];
+    cache.heads[index] = node->next;
+    cache.counts[index]--;
+    return node;
+  }
+
+  return ::operator new(min_block_size << index);
+}
+
+void memory_pool::do_deallocate(void*       ptr,
+                                std::size_t bytes,
+                                std::size_t alignment) {
+  if (!pooled(bytes, alignment)) {
+    std::pmr::new_delete_resource()->deallocate(ptr, bytes, alignment);
+    return;
+  }
+
+  auto index = size_class(bytes);
+
+  if (cache_destroyed || cache.counts[index] >= max_cached) {
+    ::operator delete(ptr);
+    return;
+  }
+
+  auto node = static_cast<node_t*>(ptr);
+  node->next = cache.heads[index];
+  cache.heads[index] = node;
+  cache.counts[index]++;
+}
+
+bool memory_pool::do_is_equal(
+    const std::pmr::memory_resource& other) const noexcept {
+  return this == &other;
+}
+}  // namespace modbus
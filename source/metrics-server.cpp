@@ -0,0 +1,324 @@
+#include <modbuscpp/modbuscpp/metrics-server.hpp>
+
+#include <array>
+#include <iterator>
+#include <utility>
+
+#include <fmt/format.h>
+
+#include <modbuscpp/modbuscpp/constants.hpp>
+#include <modbuscpp/modbuscpp/logger.hpp>
+
+namespace modbus {
+namespace {
+/**
+ * Histogram bucket bounds (ns) exported as "le" labels
+ */
+constexpr std::array<std::uint64_t, 19> bucket_bounds{
+    1'000,       2'500,       5'000,       10'000,      25'000,
+    50'000,      100'000,     250'000,     500'000,     1'000'000,
+    2'500'000,   5'000'000,   10'000'000,  25'000'000,  50'000'000,
+    100'000'000, 250'000'000, 500'000'000, 1'000'000'000};
+
+/**
+ * Get label value of name, spaces become underscores
+ *
+ * @param name name
+ *
+ * @return label value
+ */
+std::string label(std::string_view name) {
+  std::string value(name);
+
+  for (auto& c : value) {
+    if (c == ' ') {
+      c = '_';
+    }
+  }
+
+  return value;
+}
+
+/**
+ * Get label value of function code
+ *
+ * @param function raw function code
+ *
+ * @return label value
+ */
+std::string function_label(std::uint8_t function) {
+  std::string_view name
+      = function_code_str(static_cast<constants::function_code>(function));
+
+  if (!check_function(function) || name == "Unknown") {
+    return fmt::format("{:#04x}", function);
+  }
+
+  return label(name);
+}
+
+/**
+ * Get seconds of nanoseconds
+ *
+ * @param ns nanoseconds
+ *
+ * @return seconds
+ */
+inline double seconds(std::uint64_t ns) {
+  return static_cast<double>(ns) / 1e9;
+}
+
+/**
+ * Write metric header
+ *
+ * @param out  output
+ * @param name metric name
+ * @param type metric type
+ * @param help metric description
+ */
+void header(std::string&      out,
+            std::string_view name,
+            std::string_view type,
+            std::string_view help) {
+  fmt::format_to(std::back_inserter(out), "# HELP {} {}\n# TYPE {} {}\n", name,
+                 help, name, type);
+}
+
+/**
+ * Write histogram samples
+ *
+ * A bucket is counted below a bound once its highest value is, so the
+ * exported buckets are within one histogram bucket (~6%) of the real value
+ *
+ * @param out       output
+ * @param name      metric name
+ * @param labels    labels without braces
+ * @param histogram histogram snapshot (ns)
+ */
+void histogram(std::string&                     out,
+               std::string_view                 name,
+               const std::string&               labels,
+               const modbus::stats::histogram_t& histogram) {
+  auto          inserter = std::back_inserter(out);
+  std::size_t   idx = 0;
+  std::uint64_t cumulative = 0;
+
+  for (auto bound : bucket_bounds) {
+    while (idx < histogram.counts.size()
+           && modbus::stats::histogram::upper_bound(idx) <= bound) {
+      cumulative += histogram.counts[idx++];
+    }
+
+    fmt::format_to(inserter, "{}_bucket{{{},le=\"{}\"}} {}\n", name, labels,
+                   seconds(bound), cumulative);
+  }
+
+  fmt::format_to(inserter, "{}_bucket{{{},le=\"+Inf\"}} {}\n", name, labels,
+                 histogram.count);
+  fmt::format_to(inserter, "{}_sum{{{}}} {}\n", name, labels,
+                 seconds(histogram.sum));
+  fmt::format_to(inserter, "{}_count{{{}}} {}\n", name, labels,
+                 histogram.count);
+}
+
+/**
+ * Write data table lock metric of every block and access kind
+ *
+ * @tparam blocks_t blocks type
+ * @tparam value_t  value getter type
+ *
+ * @param out    output
+ * @param blocks block names and lock stats
+ * @param name   metric name
+ * @param type   metric type
+ * @param help   metric description
+ * @param value  value getter
+ */
+template <typename blocks_t, typename value_t>
+void lock_metric(std::string&     out,
+                 const blocks_t&  blocks,
+                 std::string_view name,
+                 std::string_view type,
+                 std::string_view help,
+                 value_t&&        value) {
+  header(out, name, type, help);
+
+  for (const auto& [block, stats] : blocks) {
+    fmt::format_to(std::back_inserter(out),
+                   "{}{{block=\"{}\",access=\"read\"}} {}\n"
+                   "{}{{block=\"{}\",access=\"write\"}} {}\n",
+                   name, block, value(stats->read), name, block,
+                   value(stats->write));
+  }
+}
+
+/**
+ * Build HTTP response
+ *
+ * @param status HTTP status line
+ * @param body   body
+ *
+ * @return HTTP response
+ */
+std::string http_response(std::string_view status, std::string_view body) {
+  return fmt::format(
+      "HTTP/1.1 {}\r\n"
+      "Content-Type: text/plain; version=0.0.4; charset=utf-8\r\n"
+      "Content-Length: {}\r\n"
+      "Connection: close\r\n"
+      "\r\n"
+      "{}",
+      status, body.size(), body);
+}
+}  // namespace
+
+metrics_server::metrics_server(server& modbus_server)
+    : server_{modbus_server}, http_{1024, 1024 * 1024, 1} {
+  http_.bind_recv(&metrics_server::on_receive, this);
+}
+
+metrics_server::~metrics_server() {
+  stop();
+}
+
+void metrics_server::run(std::string_view host, std::string_view port) {
+  http_.start(host, port);
+}
+
+void metrics_server::stop() {
+  http_.stop();
+}
+
+std::string metrics_server::render() const {
+  const auto& data_table = server_.data_table();
+  return render(server_.stats(), server_.tcp_server().session_count(),
+                data_table.lock_stats());
+}
+
+std::string metrics_server::render(const modbus::stats::snapshot_t& snapshot,
+                                   std::size_t                       sessions,
+                                   const table::lock_stats_t&        locks) {
+  std::string out;
+  auto        inserter = std::back_inserter(out);
+
+  header(out, "modbus_requests_total", "counter",
+         "Requests handled by function code");
+  for (const auto& [function, entry] : snapshot.functions) {
+    fmt::format_to(inserter, "modbus_requests_total{{function=\"{}\"}} {}\n",
+                   function_label(function), entry.requests);
+  }
+
+  header(out, "modbus_request_duration_seconds", "histogram",
+         "Request handling time by function code");
+  for (const auto& [function, entry] : snapshot.functions) {
+    histogram(out, "modbus_request_duration_seconds",
+              fmt::format("function=\"{}\"", function_label(function)),
+              entry.latency);
+  }
+
+  header(out, "modbus_stage_duration_seconds", "histogram",
+         "Request processing time by stage");
+  for (std::size_t idx = 0; idx < modbus::stats::stage_count; ++idx) {
+    auto value = static_cast<modbus::stats::stage>(idx);
+    histogram(out, "modbus_stage_duration_seconds",
+              fmt::format("stage=\"{}\"", modbus::stats::stage_str(value)),
+              snapshot.stages[idx]);
+  }
+
+  header(out, "modbus_exceptions_total", "counter",
+         "Exception responses and failures by exception code");
+  for (const auto& [code, count] : snapshot.exceptions) {
+    fmt::format_to(inserter, "modbus_exceptions_total{{code=\"{}\"}} {}\n",
+                   label(exception_code_str(code)), count);
+  }
+
+  header(out, "modbus_active_sessions", "gauge", "Connected clients");
+  fmt::format_to(inserter, "modbus_active_sessions {}\n", sessions);
+
+  header(out, "modbus_received_bytes_total", "counter", "Bytes received");
+  fmt::format_to(inserter, "modbus_received_bytes_total {}\n",
+                 snapshot.bytes_in);
+
+  header(out, "modbus_sent_bytes_total", "counter", "Bytes sent");
+  fmt::format_to(inserter, "modbus_sent_bytes_total {}\n", snapshot.bytes_out);
+
+  const std::array<std::pair<const char*, const lock_stats_t*>, 4> blocks{{
+      {"coils", &locks.coils},
+      {"discrete_inputs", &locks.discrete_inputs},
+      {"holding_registers", &locks.holding_registers},
+      {"input_registers", &locks.input_registers},
+  }};
+
+  lock_metric(out, blocks, "modbus_table_lock_acquisitions_total", "counter",
+              "Data table lock acquisitions", [](const auto& side) {
+                return std::to_string(side.acquisitions);
+              });
+  lock_metric(out, blocks, "modbus_table_lock_contended_total", "counter",
+              "Data table lock acquisitions that had to wait",
+              [](const auto& side) {
+                return std::to_string(side.contended);
+              });
+  lock_metric(out, blocks, "modbus_table_lock_wait_seconds_total", "counter",
+              "Data table lock wait time", [](const auto& side) {
+                return fmt::format("{}", seconds(side.wait_time));
+              });
+  lock_metric(out, blocks, "modbus_table_lock_max_wait_seconds", "gauge",
+              "Data table lock max wait time", [](const auto& side) {
+                return fmt::format("{}", seconds(side.max_wait_time));
+              });
+  lock_metric(out, blocks, "modbus_table_lock_hold_seconds_total", "counter",
+              "Data table lock hold time", [](const auto& side) {
+                return fmt::format("{}", seconds(side.hold_time));
+              });
+
+  return out;
+}
+
+std::string metrics_server::respond(std::string_view request) const {
+  auto line_end = request.find("\r\n");
+
+  if (line_end == std::string_view::npos) {
+    return {};
+  }
+
+  // request line: METHOD SP TARGET SP VERSION
+  auto line = request.substr(0, line_end);
+  auto method_end = line.find(' ');
+  auto target_end = line.find(' ', method_end + 1);
+
+  if (method_end == std::string_view::npos
+      || target_end == std::string_view::npos) {
+    return http_response("400 Bad Request", "bad request\n");
+  }
+
+  auto method = line.substr(0, method_end);
+  auto target = line.substr(method_end + 1, target_end - method_end - 1);
+
+  if (method != "GET") {
+    return http_response("405 Method Not Allowed", "method not allowed\n");
+  }
+
+  if (target != "/metrics" && target != "/") {
+    return http_response("404 Not Found", "not found\n");
+  }
+
+  return http_response("200 OK", render());
+}
+
+void metrics_server::on_receive(session_ptr_t&   session_ptr,
+                                std::string_view raw_request) {
+  auto response = respond(raw_request);
+
+  if (response.empty()) {
+    logger::debug(FMT_STRING("metrics: incomplete request from {}"),
+                  session_ptr->remote_address());
+    session_ptr->stop();
+    return;
+  }
+
+  // one request per connection
+  session_ptr->send(response, [session_ptr](std::size_t) {
+    session_ptr->stop();
+  });
+}
+}  // namespace modbus
@@ -1,12 +1,156 @@
 #include <modbuscpp/modbuscpp/operation.hpp>
 
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
 namespace modbus {
 namespace op {
+namespace {
+#if defined(__GLIBCXX__)
+/**
+ * Storage word of the bits container, holding bits from the LSB up
+ *
+ * That is the coil byte order of the protocol, so packing is a matter of
+ * shifting words into place rather than testing bit by bit.
+ */
+typedef std::_Bit_type word_t;
+
+/**
+ * Bits per storage word
+ */
+constexpr std::size_t word_bits = sizeof(word_t) * 8;
+
+/**
+ * Pack bits of storage words into bytes
+ *
+ * @param words  first storage word
+ * @param offset offset of first bit in first word
+ * @param count  number of bits, not zero
+ * @param out    output, (count + 7) / 8 bytes
+ */
+void pack_words(const word_t* words,
+                unsigned      offset,
+                std::size_t   count,
+                char*         out) noexcept {
+  const std::size_t bytes = (count + 7) / 8;
+  const std::size_t last = (offset + count - 1) / word_bits;
+  std::size_t       idx = 0;
+
+  for (std::size_t word_idx = 0; idx < bytes; ++word_idx) {
+    word_t word = words[word_idx] >> offset;
+
+    if (offset != 0 && word_idx < last) {
+      word |= words[word_idx + 1] << (word_bits - offset);
+    }
+
+    if (bytes - idx >= sizeof(word_t)) {
+#  if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+      std::memcpy(out + idx, &word, sizeof(word_t));
+#  else
+      for (std::size_t byte = 0; byte < sizeof(word_t); ++byte) {
+        out[idx + byte] = static_cast<char>(word >> (byte * 8));
+      }
+#  endif
+
+      idx += sizeof(word_t);
+    } else {
+      for (; idx < bytes; word >>= 8) {
+        out[idx++] = static_cast<char>(word);
+      }
+    }
+  }
+
+  // bits past the end are not ours to send
+  if (count % 8 != 0) {
+    out[bytes - 1] &= static_cast<char>((1u << (count % 8)) - 1);
+  }
+}
+
+/**
+ * Unpack bytes into storage words
+ *
+ * @param in    input
+ * @param bytes number of bytes
+ * @param words output, (bytes + 7) / 8 words
+ */
+void unpack_words(const char* in, std::size_t bytes, word_t* words) noexcept {
+  std::size_t idx = 0;
+
+  for (std::size_t word_idx = 0; idx < bytes; ++word_idx) {
+    word_t word = 0;
+
+    if (bytes - idx >= sizeof(word_t)) {
+#  if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+      std::memcpy(&word, in + idx, sizeof(word_t));
+#  else
+      for (std::size_t byte = 0; byte < sizeof(word_t); ++byte) {
+        word |= static_cast<word_t>(static_cast<std::uint8_t>(in[idx + byte]))
+                << (byte * 8);
+      }
+#  endif
+
+      idx += sizeof(word_t);
+    } else {
+      for (std::size_t shift = 0; idx < bytes; shift += 8) {
+        word |= static_cast<word_t>(static_cast<std::uint8_t>(in[idx++]))
+                << shift;
+      }
+    }
 
-packet_t pack_bits(const block::bits::container_type::const_iterator& begin,
-                   const block::bits::container_type::const_iterator& end) {
+    words[word_idx] = word;
+  }
+}
+#endif
+}  // namespace
+
+packet_t pack_bits(const block::bits::buffer_type::const_iterator& begin,
+                   const block::bits::buffer_type::const_iterator& end) {
   packet_t packet;
+  pack_bits(packet, begin, end);
+  return packet;
+}
+
+void pack_bits(packet_t&                                          packet,
+               const block::bits::buffer_type::const_iterator& begin,
+               const block::bits::buffer_type::const_iterator& end) {
+#if defined(__GLIBCXX__)
+  if (!(begin < end)) {
+    return;
+  }
+
+  auto count = static_cast<std::size_t>(end - begin);
+  auto size = packet.size();
+  packet.resize(size + (count + 7) / 8);
+  pack_words(begin._M_p, begin._M_offset, count, packet.data() + size);
+#else
+  scalar::pack_bits(packet, begin, end);
+#endif
+}
+
+block::bits::buffer_type unpack_bits(
+    const packet_t::const_iterator&                     begin,
+    const packet_t::const_iterator&                     end,
+    const block::bits::buffer_type::allocator_type& allocator) {
+#if defined(__GLIBCXX__)
+  block::bits::buffer_type result(allocator);
 
+  if (begin < end) {
+    auto bytes = static_cast<std::size_t>(end - begin);
+    result.resize(bytes * 8);
+    unpack_words(begin, bytes, result.begin()._M_p);
+  }
+
+  return result;
+#else
+  return scalar::unpack_bits(begin, end, allocator);
+#endif
+}
+
+namespace scalar {
+void pack_bits(packet_t&                                          packet,
+               const block::bits::buffer_type::const_iterator& begin,
+               const block::bits::buffer_type::const_iterator& end) {
   char shift = 0;
   char one_byte = 0;
 
@@ -23,13 +167,17 @@ packet_t pack_bits(const block::bits::container_type::const_iterator& begin,
   if (shift != 0) {
     packet.push_back(one_byte);
   }
-
-  return packet;
 }
 
-block::bits::container_type unpack_bits(const packet_t::const_iterator& begin,
-                                        const packet_t::const_iterator& end) {
-  block::bits::container_type result;
+block::bits::buffer_type unpack_bits(
+    const packet_t::const_iterator&                     begin,
+    const packet_t::const_iterator&                     end,
+    const block::bits::buffer_type::allocator_type& allocator) {
+  block::bits::buffer_type result(allocator);
+
+  if (begin < end) {
+    result.reserve(static_cast<std::size_t>(end - begin) * 8);
+  }
 
   for (auto ptr = begin; ptr < end; ++ptr) {
     for (int bit = 0x01; bit & 0xff; bit <<= 1) {
@@ -39,5 +187,6 @@ block::bits::container_type unpack_bits(const packet_t::const_iterator& begin,
 
   return result;
 }
+}  // namespace scalar
 }  // namespace op
 }  // namespace modbus
@@ -0,0 +1,140 @@
+#include <modbuscpp/modbuscpp/prepared-request.hpp>
+
+#include <cstring>
+
+#include <modbuscpp/modbuscpp/exception.hpp>
+#include <modbuscpp/modbuscpp/request.hpp>
+#include <modbuscpp/modbuscpp/response.hpp>
+#include <modbuscpp/modbuscpp/utilities.hpp>
+
+namespace modbus {
+prepared_request::prepared_request(internal::request& request)
+    : function_{request.function()},
+      packet_{request.encode()},
+      response_size_{request.response_size()} {
+  constexpr auto header_length = internal::adu::header_length;
+
+  // expected response header: same transaction, protocol and unit,
+  // length derived from the expected response size
+  expected_.assign(packet_.begin(), packet_.begin() + header_length + 1);
+
+  if (response_size_ > 0) {
+    utilities::write_u16(
+        expected_.data() + 4,
+        static_cast<std::uint16_t>(response_size_ - (header_length - 1)));
+  }
+
+  switch (function_) {
+    case constants::function_code::read_coils:
+    case constants::function_code::read_discrete_inputs:
+    case constants::function_code::read_holding_registers:
+    case constants::function_code::read_input_registers:
+    case constants::function_code::read_write_multiple_registers:
+      // byte count
+      expected_.push_back(
+          static_cast<char>(response_size_ - (header_length + 2)));
+      break;
+    case constants::function_code::write_single_coil:
+    case constants::function_code::write_single_register:
+    case constants::function_code::mask_write_register:
+      // whole request is echoed
+      expected_.assign(packet_.begin(), packet_.end());
+      break;
+    case constants::function_code::write_multiple_coils:
+    case constants::function_code::write_multiple_registers:
+      // starting address and quantity are echoed
+      expected_.insert(expected_.end(), packet_.begin() + header_length + 1,
+                       packet_.begin() + header_length + 5);
+      break;
+    default:
+      break;
+  }
+}
+
+std::string_view prepared_request::stamp(std::uint16_t transaction) noexcept {
+  utilities::write_u16(packet_.data(), transaction);
+  return {packet_.data(), packet_.size()};
+}
+
+std::string_view prepared_request::stamp(std::uint16_t transaction,
+                                         std::uint8_t  unit) noexcept {
+  packet_[unit_idx] = static_cast<char>(unit);
+  expected_[unit_idx] = static_cast<char>(unit);
+  return stamp(transaction);
+}
+
+void prepared_request::copy_to(char*         output,
+                               std::uint16_t transaction) const noexcept {
+  std::memcpy(output, packet_.data(), packet_.size());
+  utilities::write_u16(output, transaction);
+}
+
+void prepared_request::throw_exception(std::string_view packet,
+                                       std::uint16_t    transaction) const {
+  constexpr auto header_length = internal::adu::header_length;
+
+  if (packet.size() != response::error::packet_size
+      || utilities::read_u16(packet.data()) != transaction
+      || std::memcmp(packet.data() + 2, expected_.data() + 2, 2) != 0
+      || packet[unit_idx] != expected_[unit_idx]
+      || static_cast<std::uint8_t>(packet[header_length])
+             != (utilities::to_underlying(function_) | 0x80)) {
+    return;
+  }
+
+  auto ec = static_cast<std::uint8_t>(packet[header_length + 1]);
+
+  if (!check_exception(ec)) {
+    throw ex::bad_exception();
+  }
+
+  modbus::throw_exception(
+      static_cast<constants::exception_code>(ec), function_,
+      {transaction, utilities::read_u16(packet.data() + 4),
+       static_cast<std::uint8_t>(packet[unit_idx])});
+}
+
+std::string_view prepared_request::check(std::string_view packet,
+                                         std::uint16_t    transaction) const {
+  if ((response_size_ > 0 && packet.size() != response_size_)
+      || packet.size() < expected_.size()
+      || utilities::read_u16(packet.data()) != transaction
+      || std::memcmp(packet.data() + 2, expected_.data() + 2,
+                     expected_.size() - 2)
+             != 0) {
+    throw_exception(packet, transaction);
+    throw ex::bad_data();
+  }
+
+  return packet.substr(expected_.size());
+}
+
+std::size_t prepared_request::decode_into(
+    std::string_view             packet,
+    std::uint16_t                transaction,
+    block::registers::data_type* output,
+    std::size_t                  size) const {
+  switch (function_) {
+    case constants::function_code::read_holding_registers:
+    case constants::function_code::read_input_registers:
+    case constants::function_code::read_write_multiple_registers:
+      break;
+    default:
+      // payload of any other response is not registers
+      throw ex::bad_data();
+  }
+
+  auto payload = check(packet, transaction);
+  auto count = payload.size() / 2;
+
+  if (output == nullptr || size < count) {
+    throw ex::bad_data_size();
+  }
+
+  for (std::size_t idx = 0; idx < count; ++idx) {
+    output[idx] = utilities::read_u16(payload.data() + idx * 2);
+  }
+
+  return count;
+}
+}  // namespace modbus
@@ -97,19 +97,17 @@ template <> packet_t base_read_registers<
   try {
     const auto& [start, end] = data_table()->holding_registers().get(
         request_->address(), request_->count());
+    data_table()->holding_registers().heatmap().read(request_->address(),
+                                                     request_->count()());
 
-    registers_ = block::registers::container_type{start, end};
+    registers_.assign(start, end);
     calc_length(request_->byte_count() + 1);
     packet_t packet = header_packet();
     packet.reserve(request_->response_size());
-    packet_t pdu
-        = struc::pack(fmt::format(">{}", format), request_->byte_count());
-    packet.insert(packet.end(), pdu.begin(), pdu.end());
+    utilities::pack_into(packet, format, request_->byte_count());
 
     for (auto ptr = start; ptr < end; ++ptr) {
-      using namespace std::string_literals;
-      auto regs = struc::pack(">H"s, *ptr);
-      packet.insert(packet.end(), regs.begin(), regs.end());
+      utilities::pack_into(packet, "H", *ptr);
     }
 
     if (!request_->check_response_packet(packet)) {
@@ -142,19 +140,17 @@ base_read_registers<constants::function_code::read_input_registers>::encode() {
   try {
     const auto& [start, end] = data_table()->input_registers().get(
         request_->address(), request_->count());
+    data_table()->input_registers().heatmap().read(request_->address(),
+                                                   request_->count()());
 
-    registers_ = block::registers::container_type{start, end};
+    registers_.assign(start, end);
     calc_length(request_->byte_count() + 1);
     packet_t packet = header_packet();
     packet.reserve(request_->response_size());
-    packet_t pdu
-        = struc::pack(fmt::format(">{}", format), request_->byte_count());
-    packet.insert(packet.end(), pdu.begin(), pdu.end());
+    utilities::pack_into(packet, format, request_->byte_count());
 
     for (auto ptr = start; ptr < end; ++ptr) {
-      using namespace std::string_literals;
-      auto regs = struc::pack(">H"s, *ptr);
-      packet.insert(packet.end(), regs.begin(), regs.end());
+      utilities::pack_into(packet, "H", *ptr);
     }
 
     if (!request_->check_response_packet(packet)) {
@@ -4,8 +4,10 @@
 #include <exception>
 #include <iterator>
 
+#include <modbuscpp/modbuscpp/data-table.inline.hpp>
 #include <modbuscpp/modbuscpp/exception.hpp>
 #include <modbuscpp/modbuscpp/logger.hpp>
+#include <modbuscpp/modbuscpp/memory-pool.hpp>
 #include <modbuscpp/modbuscpp/operation.hpp>
 #include <modbuscpp/modbuscpp/struct.hpp>
 #include <modbuscpp/modbuscpp/utilities.hpp>
@@ -30,8 +32,7 @@ packet_t write_single_register::encode() {
   calc_length(data_length);
   packet_t packet = header_packet();
   packet.reserve(header_length + 1 + data_length);
-  packet_t pdu = struc::pack(fmt::format(">{}", format), address_(), value_());
-  packet.insert(packet.end(), pdu.begin(), pdu.end());
+  utilities::pack_into(packet, format, address_(), value_());
   return packet;
 }
 
@@ -87,7 +88,16 @@ write_multiple_registers::write_multiple_registers(
     : internal::request{constants::function_code::write_multiple_registers},
       address_{address},
       count_{count},
-      values_(values) {}
+      values_(values, memory_pool::get()) {}
+
+write_multiple_registers::write_multiple_registers(
+    const address_t&                 address,
+    const write_num_regs_t&          count,
+    block::registers::container_type values) noexcept
+    : internal::request{constants::function_code::write_multiple_registers},
+      address_{address},
+      count_{count},
+      values_(values.begin(), values.end(), memory_pool::get()) {}
 
 packet_t write_multiple_registers::encode() {
   if (!address_.validate() || !count_.validate()) {
@@ -97,14 +107,10 @@ packet_t write_multiple_registers::encode() {
   calc_length(data_length());
   packet_t packet = header_packet();
   packet.reserve(header_length + data_length());
-  packet_t pdu = struc::pack(fmt::format(">{}", format), address_(), count_(),
-                             byte_count());
-  packet.insert(packet.end(), pdu.begin(), pdu.end());
+  utilities::pack_into(packet, format, address_(), count_(), byte_count());
 
   for (const auto& value : values_) {
-    using namespace std::string_literals;
-    auto regs = struc::pack(">H"s, value);
-    packet.insert(packet.end(), regs.begin(), regs.end());
+    utilities::pack_into(packet, "H", value);
   }
 
   if (packet.size() != (data_length() + header_length + 1)) {
@@ -131,7 +137,8 @@ void write_multiple_registers::decode(const packet_t& packet) {
       throw ex::bad_data();
     }
 
-    block::registers::container_type buffer;
+    block::registers::buffer_type buffer(values_.get_allocator());
+    buffer.reserve(byte_count() / 2);
 
     for (int idx = 0; idx < byte_count(); idx += 2) {
       std::uint16_t value;
@@ -195,9 +202,7 @@ packet_t mask_write_register::encode() {
   calc_length(data_length);
   packet_t packet = header_packet();
   packet.reserve(header_length + 1 + data_length);
-  packet_t pdu = struc::pack(fmt::format(">{}", format), address_(),
-                             and_mask_(), or_mask_());
-  packet.insert(packet.end(), pdu.begin(), pdu.end());
+  utilities::pack_into(packet, format, address_(), and_mask_(), or_mask_());
   return packet;
 }
 
@@ -255,7 +260,7 @@ read_write_multiple_registers::read_write_multiple_registers(
       read_count_{read_count},
       write_address_{write_address},
       write_count_{write_count},
-      values_(values) {}
+      values_(values, memory_pool::get()) {}
 
 packet_t read_write_multiple_registers::encode() {
   if (!read_address_.validate() || !read_count_.validate()
@@ -266,15 +271,11 @@ packet_t read_write_multiple_registers::encode() {
   calc_length(data_length());
   packet_t packet = header_packet();
   packet.reserve(header_length + data_length());
-  packet_t pdu
-      = struc::pack(fmt::format(">{}", format), read_address_(), read_count_(),
-                    write_address_(), write_count_(), byte_count());
-  packet.insert(packet.end(), pdu.begin(), pdu.end());
+  utilities::pack_into(packet, format, read_address_(), read_count_(),
+                       write_address_(), write_count_(), byte_count());
 
   for (const auto& value : values_) {
-    using namespace std::string_literals;
-    auto regs = struc::pack(">H"s, value);
-    packet.insert(packet.end(), regs.begin(), regs.end());
+    utilities::pack_into(packet, "H", value);
   }
 
   if (packet.size() != (data_length() + header_length + 1)) {
@@ -302,7 +303,8 @@ void read_write_multiple_registers::decode(const packet_t& packet) {
       throw ex::bad_data();
     }
 
-    block::registers::container_type buffer;
+    block::registers::buffer_type buffer(values_.get_allocator());
+    buffer.reserve(byte_count() / 2);
 
     for (int idx = 0; idx < byte_count(); idx += 2) {
       std::uint16_t value;
@@ -370,9 +372,8 @@ packet_t write_single_register::encode() {
     calc_length(data_length);
     packet_t packet = header_packet();
     packet.reserve(request_->response_size());
-    packet_t pdu = struc::pack(fmt::format(">{}", format),
-                               request_->address()(), request_->value()());
-    packet.insert(packet.end(), pdu.begin(), pdu.end());
+    utilities::pack_into(packet, format, request_->address()(),
+                         request_->value()());
 
     if (!request_->check_response_packet(packet)) {
       throw ex::server_device_failure(function(), header());
@@ -380,6 +381,7 @@ packet_t write_single_register::encode() {
 
     data_table()->holding_registers().set(request_->address(),
                                           request_->value()());
+    data_table()->holding_registers().heatmap().write(request_->address(), 1);
     address_ = request_->address();
     value_ = request_->value();
 
@@ -443,11 +445,13 @@ packet_t write_multiple_registers::encode() {
     calc_length(data_length);
     packet_t packet = header_packet();
     packet.reserve(request_->response_size());
-    packet_t pdu = struc::pack(fmt::format(">{}", format),
-                               request_->address()(), request_->count()());
-    packet.insert(packet.end(), pdu.begin(), pdu.end());
+    utilities::pack_into(packet, format, request_->address()(),
+                         request_->count()());
     data_table()->holding_registers().set(request_->address(),
-                                          request_->values());
+                                          request_->values().begin(),
+                                          request_->values().end());
+    data_table()->holding_registers().heatmap().write(request_->address(),
+                                                      request_->count()());
     return packet;
   } catch (const std::out_of_range&) {
     throw ex::illegal_data_address(function(), header());
@@ -503,10 +507,8 @@ packet_t mask_write_register::encode() {
     calc_length(data_length);
     packet_t packet = header_packet();
     packet.reserve(request_->response_size());
-    packet_t pdu
-        = struc::pack(fmt::format(">{}", format), request_->address()(),
-                      request_->and_mask()(), request_->or_mask()());
-    packet.insert(packet.end(), pdu.begin(), pdu.end());
+    utilities::pack_into(packet, format, request_->address()(),
+                         request_->and_mask()(), request_->or_mask()());
 
     if (!request_->check_response_packet(packet)) {
       throw ex::server_device_failure(function(), header());
@@ -518,6 +520,7 @@ packet_t mask_write_register::encode() {
     std::uint16_t new_value
         = (current_value & request_->and_mask()()) | request_->or_mask()();
     data_table()->holding_registers().set(request_->address(), new_value);
+    data_table()->holding_registers().heatmap().write(request_->address(), 1);
     address_ = request_->address();
     and_mask_ = request_->and_mask();
     or_mask_ = request_->or_mask();
@@ -580,7 +583,8 @@ read_write_multiple_registers::read_write_multiple_registers(
     const request::read_write_multiple_registers* request,
     table*                                        data_table) noexcept
     : internal::response{request->function(), request->header(), data_table},
-      request_{request} {
+      request_{request},
+      registers_(memory_pool::get()) {
   initialize({request_->transaction(), request_->unit()});
   count_ = static_cast<std::uint8_t>(request_->read_count()() * 2);
 }
@@ -588,23 +592,25 @@ read_write_multiple_registers::read_write_multiple_registers(
 packet_t read_write_multiple_registers::encode() {
   try {
     data_table()->holding_registers().set(request_->write_address(),
-                                          request_->values());
+                                          request_->values().begin(),
+                                          request_->values().end());
+    data_table()->holding_registers().heatmap().write(
+        request_->write_address(), request_->write_count()());
 
     const auto& [start, end] = data_table()->holding_registers().get(
         request_->read_address(), request_->read_count());
+    data_table()->holding_registers().heatmap().read(
+        request_->read_address(), request_->read_count()());
 
-    registers_ = block::registers::container_type{start, end};
+    registers_.assign(start, end);
 
     calc_length(1 + count_);
     packet_t packet = header_packet();
     packet.reserve(request_->response_size());
-    packet_t pdu = struc::pack(fmt::format(">{}", format), count_);
-    packet.insert(packet.end(), pdu.begin(), pdu.end());
+    utilities::pack_into(packet, format, count_);
 
     for (auto ptr = start; ptr < end; ++ptr) {
-      using namespace std::string_literals;
-      auto regs = struc::pack(">H"s, *ptr);
-      packet.insert(packet.end(), regs.begin(), regs.end());
+      utilities::pack_into(packet, "H", *ptr);
     }
 
     if (!request_->check_response_packet(packet)) {
@@ -619,37 +625,36 @@ packet_t read_write_multiple_registers::encode() {
   }
 }
 
-void read_write_multiple_registers::decode_passed(const packet_t& packet) {
-  try {
-    if (packet.size() != request_->response_size()) {
-      throw ex::bad_data();
-    }
+const char* read_write_multiple_registers::check_passed(
+    std::string_view packet) {
+  if (packet.size() != request_->response_size()) {
+    throw ex::bad_data();
+  }
 
-    uint8_t byte_count_recv
-        = static_cast<std::uint8_t>(request_->read_count().get() * 2);
-    packet_t::size_type byte_idx = header_length + 1;
-    count_ = static_cast<std::uint8_t>(packet[byte_idx]);
+  uint8_t byte_count_recv
+      = static_cast<std::uint8_t>(request_->read_count().get() * 2);
+  packet_t::size_type byte_idx = header_length + 1;
+  count_ = static_cast<std::uint8_t>(packet[byte_idx]);
 
-    if (count_ != byte_count_recv) {
-      logger::debug(
-          "ResponseReadWriteMultipleRegisters: Byte register read count "
-          "mismatch");
-      throw ex::bad_data();
-    }
+  if (count_ != byte_count_recv) {
+    logger::debug(
+        "ResponseReadWriteMultipleRegisters: Byte register read count "
+        "mismatch");
+    throw ex::bad_data();
+  }
 
-    block::registers::container_type buffer;
+  return packet.data() + byte_idx + 1;
+}
 
-    for (int idx = 0; idx < count_; idx += 2) {
-      std::uint16_t value;
-      struc::unpack(">H", packet.data() + byte_idx + 1 + idx, value);
-      buffer.push_back(value);
-    }
+void read_write_multiple_registers::decode_passed(const packet_t& packet) {
+  try {
+    const char* values = check_passed({packet.data(), packet.size()});
 
-    if (buffer.size() != request_->read_count().get()) {
-#ifndef DEBUG_ON
-      logger::debug("Bytes count is not as same as number of registers");
-#endif
-      throw ex::bad_data();
+    block::registers::buffer_type buffer(request_->read_count().get(),
+                                            registers_.get_allocator());
+
+    for (std::size_t idx = 0; idx < buffer.size(); ++idx) {
+      buffer[idx] = utilities::read_u16(values + idx * 2);
     }
 
     registers_.swap(buffer);
@@ -658,6 +663,31 @@ void read_write_multiple_registers::decode_passed(const packet_t& packet) {
   }
 }
 
+std::size_t read_write_multiple_registers::decode_into(
+    std::string_view             packet,
+    block::registers::data_type* output,
+    std::size_t                  size) {
+  const std::size_t count = request_->read_count().get();
+
+  if (output == nullptr || size < count) {
+    throw ex::bad_data_size();
+  }
+
+  try {
+    check(packet);
+  } catch (const std::out_of_range&) {
+    throw ex::bad_data();
+  }
+
+  const char* values = check_passed(packet);
+
+  for (std::size_t idx = 0; idx < count; ++idx) {
+    output[idx] = utilities::read_u16(values + idx * 2);
+  }
+
+  return count;
+}
+
 std::ostream& read_write_multiple_registers::dump(std::ostream& os) const {
   fmt::print(os,
              "ResponseReadWriteMultipleRegisters(header[transaction={:#04x}, "
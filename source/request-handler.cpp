@@ -8,24 +8,159 @@
 #include <modbuscpp/modbuscpp/constants.hpp>
 #include <modbuscpp/modbuscpp/exception.hpp>
 #include <modbuscpp/modbuscpp/logger.hpp>
+#include <modbuscpp/modbuscpp/stats.hpp>
+#include <modbuscpp/modbuscpp/trace.hpp>
 #include <modbuscpp/modbuscpp/utilities.hpp>
 
 #include <modbuscpp/modbuscpp/adu.hpp>
 #include <modbuscpp/modbuscpp/response.hpp>
 
 #include <modbuscpp/modbuscpp/bit-read.hpp>
+#include <modbuscpp/modbuscpp/bit-read.inline.hpp>
 #include <modbuscpp/modbuscpp/bit-write.hpp>
 #include <modbuscpp/modbuscpp/register-read.hpp>
+#include <modbuscpp/modbuscpp/register-read.inline.hpp>
 #include <modbuscpp/modbuscpp/register-write.hpp>
 
 namespace modbus {
+namespace {
+/**
+ * @brief scoped request stage
+ *
+ * Records stage latency to the stats recorder (if any) and a span to the
+ * installed tracer (if any)
+ */
+class stage_scope : private boost::noncopyable {
+public:
+  /**
+   * Stage scope constructor
+   *
+   * @param recorder stats recorder, may be nullptr
+   * @param value    stage
+   * @param what     traced event
+   */
+  inline stage_scope(stats::recorder* recorder,
+                     stats::stage     value,
+                     trace::event     what) noexcept
+      : recorder_{recorder}, value_{value}, span_{what} {}
+
+  /**
+   * Stage scope destructor
+   */
+  inline ~stage_scope() {
+    if (recorder_ != nullptr) {
+      recorder_->stage(value_, stopwatch_.elapsed());
+    }
+  }
+
+private:
+  /**
+   * Stats recorder
+   */
+  stats::recorder* recorder_;
+  /**
+   * Stage
+   */
+  const stats::stage value_;
+  /**
+   * Traced span
+   */
+  trace::span span_;
+  /**
+   * Stopwatch
+   */
+  stats::stopwatch stopwatch_;
+};
+
+/**
+ * Decode, execute, and encode request
+ *
+ * @tparam request_t request type
+ *
+ * @param data_table data table
+ * @param packet     request packet
+ * @param recorder   stats recorder, may be nullptr
+ *
+ * @return packet to send
+ */
+template <typename request_t>
+packet_t process(table*           data_table,
+                 const packet_t&  packet,
+                 stats::recorder* recorder) {
+  request_t req;
+
+  if (recorder == nullptr && trace::tracer::get() == nullptr) {
+    req.decode(packet);
+    auto&& res = req.execute(data_table);
+    return res->encode();
+  }
+
+  {
+    stage_scope scope(recorder, stats::stage::decode, trace::event::decode);
+    req.decode(packet);
+  }
+
+  internal::response::pointer res;
+
+  {
+    stage_scope scope(recorder, stats::stage::execute, trace::event::execute);
+    res = req.execute(data_table);
+  }
+
+  stage_scope scope(recorder, stats::stage::encode, trace::event::encode);
+  return res->encode();
+}
+
+/**
+ * Record exception
+ *
+ * @param recorder stats recorder, may be nullptr
+ * @param code     exception code
+ */
+inline void record_exception(stats::recorder*          recorder,
+                             constants::exception_code code) {
+  if (recorder != nullptr) {
+    recorder->exception(code);
+  }
+}
+}  // namespace
+
 packet_t request_handler::handle(table*                  data_table,
-                                 const std::string_view& packet) {
+                                 const std::string_view& packet,
+                                 stats::recorder*        recorder) {
+  if (packet.size() > packet_t::max_capacity) {
+    record_exception(recorder, constants::exception_code::bad_data_size);
+    logger::error(FMT_STRING("Request of {} bytes exceeds max ADU length"),
+                  packet.size());
+    return {};
+  }
+
   packet_t pack{packet.begin(), packet.end()};
-  return handle(data_table, pack);
+  return handle(data_table, pack, recorder);
 }
 
-packet_t request_handler::handle(table* data_table, const packet_t& packet) {
+packet_t request_handler::handle(table*           data_table,
+                                 const packet_t&  packet,
+                                 stats::recorder* recorder) {
+  if (recorder == nullptr) {
+    return dispatch(data_table, packet, nullptr);
+  }
+
+  constexpr auto header_length = internal::adu::header_length;
+
+  stats::stopwatch stopwatch;
+  auto             response = dispatch(data_table, packet, recorder);
+  recorder->request(
+      packet.size() > header_length
+          ? static_cast<std::uint8_t>(packet[header_length])
+          : utilities::to_underlying(constants::function_code::min),
+      stopwatch.elapsed());
+  return response;
+}
+
+packet_t request_handler::dispatch(table*           data_table,
+                                   const packet_t&  packet,
+                                   stats::recorder* recorder) {
   constexpr auto header_length = internal::adu::header_length;
 
   try {
@@ -36,78 +171,47 @@ packet_t request_handler::handle(table* data_table, const packet_t& packet) {
     constants::function_code function
         = static_cast<constants::function_code>(packet.at(header_length));
 
-    logger::debug("Get {} request", function_code_str(function));
+    logger::debug(FMT_STRING("Get {} request"), function_code_str(function));
 
     switch (function) {
-      case constants::function_code::read_coils: {
-        request::read_coils req;
-        req.decode(packet);
-        auto&& res = req.execute(data_table);
-        return res->encode();
-      } break;
+      case constants::function_code::read_coils:
+        return process<request::read_coils>(data_table, packet, recorder);
 
-      case constants::function_code::read_discrete_inputs: {
-        request::read_discrete_inputs req;
-        req.decode(packet);
-        auto&& res = req.execute(data_table);
-        return res->encode();
-      } break;
+      case constants::function_code::read_discrete_inputs:
+        return process<request::read_discrete_inputs>(data_table, packet,
+                                                      recorder);
 
-      case constants::function_code::read_holding_registers: {
-        request::read_holding_registers req;
-        req.decode(packet);
-        auto&& res = req.execute(data_table);
-        return res->encode();
-      } break;
+      case constants::function_code::read_holding_registers:
+        return process<request::read_holding_registers>(data_table, packet,
+                                                        recorder);
 
-      case constants::function_code::read_input_registers: {
-        request::read_input_registers req;
-        req.decode(packet);
-        auto&& res = req.execute(data_table);
-        return res->encode();
-      } break;
+      case constants::function_code::read_input_registers:
+        return process<request::read_input_registers>(data_table, packet,
+                                                      recorder);
 
-      case constants::function_code::write_single_coil: {
-        request::write_single_coil req;
-        req.decode(packet);
-        auto&& res = req.execute(data_table);
-        return res->encode();
-      } break;
+      case constants::function_code::write_single_coil:
+        return process<request::write_single_coil>(data_table, packet,
+                                                   recorder);
 
-      case constants::function_code::write_single_register: {
-        request::write_single_register req;
-        req.decode(packet);
-        auto&& res = req.execute(data_table);
-        return res->encode();
-      } break;
+      case constants::function_code::write_single_register:
+        return process<request::write_single_register>(data_table, packet,
+                                                       recorder);
 
-      case constants::function_code::write_multiple_coils: {
-        request::write_multiple_coils req;
-        req.decode(packet);
-        auto&& res = req.execute(data_table);
-        return res->encode();
-      } break;
+      case constants::function_code::write_multiple_coils:
+        return process<request::write_multiple_coils>(data_table, packet,
+                                                      recorder);
 
-      case constants::function_code::write_multiple_registers: {
-        request::write_multiple_registers req;
-        req.decode(packet);
-        auto&& res = req.execute(data_table);
-        return res->encode();
-      } break;
+      case constants::function_code::write_multiple_registers:
+        return process<request::write_multiple_registers>(data_table, packet,
+                                                          recorder);
 
-      case constants::function_code::mask_write_register: {
-        request::mask_write_register req;
-        req.decode(packet);
-        auto&& res = req.execute(data_table);
-        return res->encode();
-      } break;
+      case constants::function_code::mask_write_register:
+        return process<request::mask_write_register>(data_table, packet,
+                                                     recorder);
 
-      case constants::function_code::read_write_multiple_registers: {
-        request::read_write_multiple_registers req;
-        req.decode(packet);
-        auto&& res = req.execute(data_table);
-        return res->encode();
-      } break;
+      case constants::function_code::read_write_multiple_registers:
+        return process<request::read_write_multiple_registers>(
+            data_table, packet, recorder);
 
       default: {
         logger::error("Unknown request");
@@ -116,19 +220,25 @@ packet_t request_handler::handle(table* data_table, const packet_t& packet) {
       } break;
     }
   } catch (const ex::specification_error& exc) {
-    logger::error("Modbus exception occured: {}", exc.what());
+    record_exception(recorder, exc.code());
+    logger::error(FMT_STRING("Modbus exception occured: {}"), exc.what());
     response::error response(exc);
     auto            resp = response.encode();
 #ifdef DEBUG_ON
-    logger::error("Exception packet: {}", utilities::packet_str(resp));
+    logger::error(FMT_STRING("Exception packet: {}"),
+                  utilities::packet_str(resp));
 #endif
     return resp;
   } catch (const ex::base_error& exc) {
-    logger::error("Internal exception occured: {}", exc.what());
+    record_exception(recorder, exc.code());
+    logger::error(FMT_STRING("Internal exception occured: {}"), exc.what());
   } catch (const std::out_of_range& exc) {
-    logger::error("Out of range exception occured: {}", exc.what());
+    record_exception(recorder, constants::exception_code::bad_data);
+    logger::error(FMT_STRING("Out of range exception occured: {}"),
+                  exc.what());
   } catch (const std::exception& exc) {
-    logger::error("Unintended exception occured {}", exc.what());
+    record_exception(recorder, constants::exception_code::bad_exception);
+    logger::error(FMT_STRING("Unintended exception occured {}"), exc.what());
   }
 
   return {};
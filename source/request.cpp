@@ -15,6 +15,8 @@ request::request(constants::function_code function,
                  std::uint16_t            transaction,
                  std::uint8_t             unit)
     : adu{function, transaction, unit} {}
+
+request::~request() {}
 }  // namespace internal
 
 namespace request {
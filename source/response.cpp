@@ -18,11 +18,19 @@ response::response(constants::function_code function,
 
 response::~response() {}
 
-bool response::initial_check(const packet_t& packet) {
+void* response::operator new(std::size_t size) {
+  return memory_pool::get()->allocate(size);
+}
+
+void response::operator delete(void* ptr, std::size_t size) noexcept {
+  memory_pool::get()->deallocate(ptr, size);
+}
+
+bool response::initial_check(std::string_view packet) {
   return packet.size() > header_length;
 }
 
-stage response::check_stage(const packet_t& packet) {
+stage response::check_stage(std::string_view packet) {
   // 1. check packet size (at least we got header and the function code)
   if (!initial_check(packet)) {
     // bad packet
@@ -37,10 +45,10 @@ stage response::check_stage(const packet_t& packet) {
 
 #ifdef DEBUG_ON
   logger::debug(
-      "Checking header: transaction(req[{:#04x}]=packet[{:#04x}]) "
-      "protocol(req[{:#04x}]=packet[{:#04x}]) "
-      "unit(req[{:#04x}]=packet[{:#04x}]) "
-      "length(expected[{:#04x}]=packet[{:#04x}]",
+      FMT_STRING("Checking header: transaction(req[{:#04x}]=packet[{:#04x}]) "
+                 "protocol(req[{:#04x}]=packet[{:#04x}]) "
+                 "unit(req[{:#04x}]=packet[{:#04x}]) "
+                 "length(expected[{:#04x}]=packet[{:#04x}]"),
       req_header_.transaction, tr, protocol, pr, req_header_.unit, un, len,
       (packet.size() - (header_length - 1)));
 #endif
@@ -83,21 +91,25 @@ stage response::check_stage(const packet_t& packet) {
   return stage::passed;
 }
 
+void response::check(std::string_view packet) {
+  switch (check_stage(packet)) {
+    case internal::stage::bad:
+      throw ex::bad_data();
+    case internal::stage::error: {
+      // decode the packet
+      auto exc = packet.at(header_length + 1);
+      throw generate_exception(static_cast<constants::exception_code>(exc),
+                               function(), header());
+    } break;
+    default:
+      break;
+  }
+}
+
 void response::decode(const packet_t& packet) {
   try {
-    switch (check_stage(packet)) {
-      case internal::stage::bad:
-        throw ex::bad_data();
-      case internal::stage::error: {
-        // decode the packet
-        auto exc = packet.at(header_length + 1);
-        throw generate_exception(static_cast<constants::exception_code>(exc),
-                                 function(), header());
-      } break;
-      default:
-        decode_passed(packet);
-        break;
-    }
+    check({packet.data(), packet.size()});
+    decode_passed(packet);
   } catch (const std::out_of_range&) {
     // anything happens, such as packet is malformed
     throw ex::bad_data();
@@ -113,10 +125,9 @@ packet_t error::encode() {
   packet_t packet = header_packet();
   packet.pop_back();
   packet.reserve(header_length + 1 + 1);
-  packet_t pdu = struc::pack(fmt::format(">{}", format),
-                             utilities::to_underlying(function()) + 0x80,
-                             utilities::to_underlying(ec_));
-  packet.insert(packet.end(), pdu.begin(), pdu.end());
+  utilities::pack_into(packet, format,
+                       utilities::to_underlying(function()) + 0x80,
+                       utilities::to_underlying(ec_));
 
   if (packet.size() != calc_adu_length(1)) {
     throw ex::bad_data();
@@ -0,0 +1,136 @@
+#include <modbuscpp/modbuscpp/rtt-estimator.hpp>
+
+#include <algorithm>
+
+namespace modbus {
+rtt_estimator::rtt_estimator() noexcept : rtt_estimator{initializer_t{}} {}
+
+rtt_estimator::rtt_estimator(const initializer_t& initializer) noexcept
+    : initializer_{initializer} {
+  reset();
+}
+
+void rtt_estimator::reset() noexcept {
+  srtt_ = duration::zero();
+  rttvar_ = duration::zero();
+  rto_ = clamp(initializer_.initial_timeout);
+  backoff_ = 0;
+  has_sample_ = false;
+}
+
+rtt_estimator::duration rtt_estimator::clamp(duration value) const noexcept {
+  return std::clamp(value, initializer_.min_timeout, initializer_.max_timeout);
+}
+
+void rtt_estimator::sample(duration rtt) noexcept {
+  if (rtt < duration::zero()) {
+    return;
+  }
+
+  if (!has_sample_) {
+    // first measurement
+    srtt_ = rtt;
+    rttvar_ = rtt / 2;
+    has_sample_ = true;
+  } else {
+    // beta = 1/4, alpha = 1/8
+    duration delta = srtt_ > rtt ? srtt_ - rtt : rtt - srtt_;
+    rttvar_ = rttvar_ - rttvar_ / 4 + delta / 4;
+    srtt_ = srtt_ - srtt_ / 8 + rtt / 8;
+  }
+
+  rto_ = clamp(srtt_ + std::max(initializer_.granularity, 4 * rttvar_));
+  backoff_ = 0;
+}
+
+void rtt_estimator::expired() noexcept {
+  // stop doubling once max timeout is reached
+  if (timeout() < initializer_.max_timeout) {
+    backoff_++;
+  }
+}
+
+rtt_estimator::duration rtt_estimator::timeout() const noexcept {
+  duration value = rto_;
+
+  for (unsigned int i = 0; i < backoff_ && value < initializer_.max_timeout;
+       ++i) {
+    value *= 2;
+  }
+
+  return clamp(value);
+}
+
+rtt_estimator::duration rtt_estimator::retry_delay(
+    unsigned int attempt) const noexcept {
+  if (attempt == 0) {
+    return duration::zero();
+  }
+
+  // space retries by the smoothed rtt, doubling for every attempt
+  duration value = has_sample_ ? std::max(srtt_, initializer_.granularity)
+                               : initializer_.min_timeout;
+
+  for (unsigned int i = 1; i < attempt && value < initializer_.max_timeout;
+       ++i) {
+    value *= 2;
+  }
+
+  return std::min(value, initializer_.max_timeout);
+}
+
+rtt_table::rtt_table(const rtt_estimator::initializer_t& initializer) noexcept
+    : initializer_{initializer} {}
+
+rtt_estimator& rtt_table::at(std::string_view endpoint, std::uint8_t unit) {
+  key_type key{std::string{endpoint}, unit};
+  auto     it = estimators_.find(key);
+
+  if (it == estimators_.end()) {
+    it = estimators_.emplace(std::move(key), rtt_estimator{initializer_})
+             .first;
+  }
+
+  return it->second;
+}
+
+void rtt_table::sample(std::string_view endpoint,
+                       std::uint8_t     unit,
+                       duration         rtt) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  at(endpoint, unit).sample(rtt);
+}
+
+void rtt_table::expired(std::string_view endpoint, std::uint8_t unit) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  at(endpoint, unit).expired();
+}
+
+rtt_table::duration rtt_table::timeout(std::string_view endpoint,
+                                       std::uint8_t     unit) const {
+  return get(endpoint, unit).timeout();
+}
+
+rtt_table::duration rtt_table::retry_delay(std::string_view endpoint,
+                                           std::uint8_t     unit,
+                                           unsigned int     attempt) const {
+  return get(endpoint, unit).retry_delay(attempt);
+}
+
+rtt_estimator rtt_table::get(std::string_view endpoint,
+                             std::uint8_t     unit) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = estimators_.find(key_type{std::string{endpoint}, unit});
+
+  if (it == estimators_.end()) {
+    return rtt_estimator{initializer_};
+  }
+
+  return it->second;
+}
+
+void rtt_table::erase(std::string_view endpoint, std::uint8_t unit) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  estimators_.erase(key_type{std::string{endpoint}, unit});
+}
+}  // namespace modbus
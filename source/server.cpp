@@ -8,6 +8,7 @@
 #include <modbuscpp/modbuscpp/constants.hpp>
 #include <modbuscpp/modbuscpp/logger.hpp>
 #include <modbuscpp/modbuscpp/request-handler.hpp>
+#include <modbuscpp/modbuscpp/trace.hpp>
 #include <modbuscpp/modbuscpp/types.hpp>
 
 namespace modbus {
@@ -15,6 +16,8 @@ server::server(table::pointer data_table, std::size_t concurrency)
     : server_{constants::max_adu_length, constants::max_adu_length,
               concurrency},
       data_table_{std::move(data_table)},
+      capture_{nullptr},
+      partial_count_{0},
       on_connect_cb_{[](auto&, auto&) {}},
       on_disconnect_cb_{[](auto&, auto&) {}} {
   server_.bind_start(&server::on_start, this)
@@ -29,40 +32,143 @@ server::~server() {
 }
 
 void server::on_start(asio::error_code ec) {
-  logger::debug("starting tcp server @ {} {}, message: {}",
+  logger::debug(FMT_STRING("starting tcp server @ {} {}, message: {}"),
                 server_.listen_address(), server_.listen_port(), ec.message());
 }
 
 void server::on_stop(asio::error_code ec) {
-  logger::debug("stopping tcp server, message: {}", ec.message());
+  logger::debug(FMT_STRING("stopping tcp server, message: {}"), ec.message());
 }
 
 void server::on_connect(session_ptr_t& session_ptr) {
   session_ptr->no_delay(true);
+  sessions_.add(session_ptr->hash_key(), session_ptr->remote_address(),
+                session_ptr->remote_port());
   on_connect_cb_(session_ptr, *data_table_);
-  logger::debug("client enters: {} {} {} {}", session_ptr->remote_address(),
-                session_ptr->remote_port(), session_ptr->local_address(),
-                session_ptr->local_port());
+  logger::debug(FMT_STRING("client enters: {} {} {} {}"),
+                session_ptr->remote_address(), session_ptr->remote_port(),
+                session_ptr->local_address(), session_ptr->local_port());
 }
 
 void server::on_disconnect(session_ptr_t& session_ptr) {
   on_disconnect_cb_(session_ptr, *data_table_);
-  logger::debug("client leaves: {} {} {}", session_ptr->remote_address(),
-                session_ptr->remote_port(), asio2::last_error_msg());
+  sessions_.remove(session_ptr->hash_key());
+
+  if (partial_count_.load(std::memory_order_acquire) != 0) {
+    std::lock_guard<std::mutex> lock(partial_mutex_);
+
+    if (partial_.erase(session_ptr->hash_key()) != 0) {
+      partial_count_.fetch_sub(1, std::memory_order_release);
+    }
+  }
+
+  logger::debug(FMT_STRING("client leaves: {} {} {}"),
+                session_ptr->remote_address(), session_ptr->remote_port(),
+                asio2::last_error_msg());
 }
 
 void server::on_receive(session_ptr_t&   session_ptr,
                         std::string_view raw_packet) {
-  auto response = request_handler::handle(data_table_.get(), raw_packet);
+  auto             key = session_ptr->hash_key();
+  std::string      buffer;
+  std::string_view stream = raw_packet;
+
+  // reads of one session are serialized, so only this call can have left
+  // a partial request for it
+  if (partial_count_.load(std::memory_order_acquire) != 0) {
+    std::lock_guard<std::mutex> lock(partial_mutex_);
+    auto                        partial = partial_.find(key);
+
+    if (partial != partial_.end()) {
+      buffer = std::move(partial->second);
+      partial_.erase(partial);
+      partial_count_.fetch_sub(1, std::memory_order_release);
+      buffer.append(raw_packet);
+      stream = buffer;
+    }
+  }
+
+  while (auto size = internal::adu::frame_size(stream)) {
+    handle(session_ptr, stream.substr(0, size));
+    stream.remove_prefix(size);
+  }
+
+  if (!stream.empty()) {
+    std::lock_guard<std::mutex> lock(partial_mutex_);
+    partial_[key] = std::string(stream);
+    partial_count_.fetch_add(1, std::memory_order_release);
+  }
+}
+
+void server::handle(session_ptr_t& session_ptr, std::string_view raw_packet) {
+  modbus::stats::stopwatch stopwatch;
+  trace::request_scope     request;
+  trace::span              span(trace::event::receive);
+  auto*                    recorder = stats_.local();
+  auto                     session = sessions_.find(session_ptr->hash_key());
+  auto*                    capture = capture_.load(std::memory_order_acquire);
+
+  if (capture != nullptr) {
+    capture->write(traffic_capture::direction::request,
+                   session_ptr->hash_key(), raw_packet);
+  }
+
+  if (recorder != nullptr) {
+    recorder->bytes_in(raw_packet.size());
+  }
+
+  if (session) {
+    session->request(raw_packet.size());
+  }
+
+  auto response
+      = request_handler::handle(data_table_.get(), raw_packet, recorder);
 
 #ifdef DEBUG_ON
-  logger::debug("[Response, {}]", utilities::packet_str(response));
+  if (logger::debug_enabled()) {
+    logger::debug(FMT_STRING("[Response, {}]"),
+                  utilities::packet_str(response));
+  }
 #endif
 
   if (!response.empty()) {
-    session_ptr->send(response, []([[maybe_unused]] std::size_t bytes_sent) {
+    if (capture != nullptr) {
+      capture->write(traffic_capture::direction::response,
+                     session_ptr->hash_key(), response);
+    }
+
+    if (session) {
+      // exception responses set the high bit of the function code
+      session->queued(response.size() > internal::adu::header_length
+                      && (static_cast<std::uint8_t>(
+                              response[internal::adu::header_length])
+                          & 0x80));
+    }
+
+    // send completes on an io thread, record into that thread's recorder
+    auto handled = stopwatch.lap();
+    auto queued_at = request.id() != 0 ? trace::tracer::now() : 0;
+    // asio2 keeps its own copy of the bytes until the send completes
+    session_ptr->send(response.view(), [this, stopwatch, handled, session,
+                                        id = request.id(), queued_at](
+                                           std::size_t bytes_sent) mutable {
+      auto sent = stopwatch.lap();
+
+      if (queued_at != 0) {
+        trace::tracer::emit(trace::event::send, id, queued_at,
+                            trace::tracer::now());
+      }
+
+      if (auto* recorder = stats_.local()) {
+        recorder->stage(modbus::stats::stage::send, sent);
+        recorder->bytes_out(bytes_sent);
+      }
+
+      if (session) {
+        session->sent(bytes_sent, handled + sent);
+      }
 #ifdef DEBUG_ON
-      logger::debug("bytes sent {}", bytes_sent);
+      logger::debug(FMT_STRING("bytes sent {}"), bytes_sent);
 #endif
     });
   }
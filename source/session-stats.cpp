@@ -0,0 +1,121 @@
+#include <modbuscpp/modbuscpp/session-stats.hpp>
+
+#include <utility>
+
+namespace modbus {
+namespace stats {
+session::session(std::size_t   key,
+                 std::string   remote_address,
+                 std::uint16_t remote_port)
+    : key_{key},
+      remote_address_{std::move(remote_address)},
+      remote_port_{remote_port},
+      connected_at_{std::chrono::system_clock::now()},
+      requests_{0},
+      bytes_in_{0},
+      bytes_out_{0},
+      exceptions_{0},
+      queued_{0},
+      max_send_queue_{0},
+      served_{0},
+      service_time_{0},
+      max_service_time_{0} {}
+
+void session::request(std::size_t bytes) noexcept {
+  add(requests_, 1);
+  add(bytes_in_, bytes);
+}
+
+void session::queued(bool exception) noexcept {
+  if (exception) {
+    add(exceptions_, 1);
+  }
+
+  add(queued_, 1);
+  raise(max_send_queue_,
+        queued_.load(std::memory_order_relaxed)
+            - served_.load(std::memory_order_relaxed));
+}
+
+void session::sent(std::size_t bytes, std::uint64_t service_time) noexcept {
+  add(bytes_out_, bytes);
+  add(served_, 1);
+  add(service_time_, service_time);
+  raise(max_service_time_, service_time);
+}
+
+session_t session::snapshot() const {
+  session_t out;
+  out.key = key_;
+  out.remote_address = remote_address_;
+  out.remote_port = remote_port_;
+  out.connected_at = connected_at_;
+  out.requests = requests_.load(std::memory_order_relaxed);
+  out.bytes_in = bytes_in_.load(std::memory_order_relaxed);
+  out.bytes_out = bytes_out_.load(std::memory_order_relaxed);
+  out.exceptions = exceptions_.load(std::memory_order_relaxed);
+  out.served = served_.load(std::memory_order_relaxed);
+  out.service_time = service_time_.load(std::memory_order_relaxed);
+  out.max_service_time = max_service_time_.load(std::memory_order_relaxed);
+  out.max_send_queue = max_send_queue_.load(std::memory_order_relaxed);
+
+  auto queued = queued_.load(std::memory_order_relaxed);
+  out.send_queue = queued > out.served ? queued - out.served : 0;
+  return out;
+}
+
+session_registry::pointer session_registry::add(std::size_t   key,
+                                                std::string   remote_address,
+                                                std::uint16_t remote_port) {
+  auto created
+      = std::make_shared<session>(key, std::move(remote_address), remote_port);
+  auto&                       target = shard(key);
+  std::lock_guard<std::mutex> lock(target.mutex);
+  target.sessions[key] = created;
+  return created;
+}
+
+void session_registry::remove(std::size_t key) {
+  auto&                       target = shard(key);
+  std::lock_guard<std::mutex> lock(target.mutex);
+  target.sessions.erase(key);
+}
+
+session_registry::pointer session_registry::find(std::size_t key) const {
+  auto&                       target = shard(key);
+  std::lock_guard<std::mutex> lock(target.mutex);
+  auto                        it = target.sessions.find(key);
+  return it == target.sessions.end() ? nullptr : it->second;
+}
+
+std::optional<session_t> session_registry::snapshot(std::size_t key) const {
+  if (auto found = find(key)) {
+    return found->snapshot();
+  }
+
+  return std::nullopt;
+}
+
+std::vector<session_t> session_registry::snapshot() const {
+  std::vector<pointer> sessions;
+
+  for (auto& target : shards_) {
+    std::lock_guard<std::mutex> lock(target.mutex);
+
+    for (const auto& [key, value] : target.sessions) {
+      sessions.push_back(value);
+    }
+  }
+
+  // snapshot outside of the locks
+  std::vector<session_t> out;
+  out.reserve(sessions.size());
+
+  for (const auto& value : sessions) {
+    out.push_back(value->snapshot());
+  }
+
+  return out;
+}
+}  // namespace stats
+}  // namespace modbus
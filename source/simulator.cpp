@@ -0,0 +1,322 @@
+#include <modbuscpp/modbuscpp/simulator.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include <modbuscpp/modbuscpp/data-table.inline.hpp>
+#include <modbuscpp/modbuscpp/exception.hpp>
+
+namespace modbus {
+namespace {
+/**
+ * Max ticks of one generator caught up before the others get a turn
+ */
+constexpr std::size_t max_catch_up = 1024;
+
+/**
+ * Longest sleep, bounds stop() latency
+ */
+constexpr auto max_sleep = std::chrono::milliseconds(10);
+
+/**
+ * Mix tick and index into uniformly distributed bits (splitmix64)
+ *
+ * @param tick  tick
+ * @param index index
+ *
+ * @return random bits
+ */
+std::uint64_t mix(std::uint64_t tick, std::size_t index) noexcept {
+  std::uint64_t z = tick * 0x9E3779B97F4A7C15ULL + index + 1;
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+  return z ^ (z >> 31);
+}
+
+/**
+ * Split spec into fields
+ *
+ * @param spec spec
+ *
+ * @return fields
+ */
+std::vector<std::string> split(std::string_view spec) {
+  std::vector<std::string> fields;
+  std::size_t              start = 0;
+
+  while (true) {
+    auto separator = spec.find(':', start);
+    fields.emplace_back(spec.substr(start, separator - start));
+
+    if (separator == std::string_view::npos) {
+      break;
+    }
+
+    start = separator + 1;
+  }
+
+  return fields;
+}
+
+/**
+ * Parse unsigned number in range
+ *
+ * @param field field
+ * @param limit max value
+ * @param name  field name
+ *
+ * @return number
+ */
+std::uint64_t number(const std::string& field,
+                     std::uint64_t      limit,
+                     const char*        name) {
+  std::size_t parsed = 0;
+  auto        result = std::stoull(field, &parsed, 0);
+
+  if (parsed != field.size() || result > limit) {
+    throw std::invalid_argument("invalid generator " + std::string(name)
+                                + " \"" + field + "\"");
+  }
+
+  return result;
+}
+}  // namespace
+
+simulator::simulator(table&                   data_table,
+                     std::vector<generator_t> generators,
+                     std::size_t              threads)
+    : data_table_{data_table},
+      generators_{std::move(generators)},
+      concurrency_{std::max<std::size_t>(threads, 1)},
+      updates_{0},
+      running_{false} {
+  for (const auto& generator : generators_) {
+    bool valid
+        = generator.block == target::input_registers
+              ? data_table_.input_registers().validate_sz(generator.address,
+                                                          generator.count)
+              : data_table_.discrete_inputs().validate_sz(generator.address,
+                                                          generator.count);
+
+    if (!valid) {
+      throw ex::out_of_range("Generator range is not valid");
+    }
+  }
+}
+
+simulator::~simulator() {
+  stop();
+}
+
+void simulator::run() {
+  if (running_.exchange(true)) {
+    return;
+  }
+
+  auto threads = std::min(concurrency_, generators_.size());
+  std::vector<std::vector<state_t>> states(threads);
+  auto                              now = clock::now();
+
+  for (std::size_t idx = 0; idx < generators_.size(); ++idx) {
+    state_t state;
+    state.generator = generators_[idx];
+    state.due = now;
+
+    if (state.generator.rate > 0) {
+      state.interval = std::chrono::duration_cast<clock::duration>(
+          std::chrono::duration<double>(1.0 / state.generator.rate));
+    }
+
+    if (state.generator.block == target::input_registers) {
+      state.registers.resize(state.generator.count);
+    } else {
+      state.bits.resize(state.generator.count);
+    }
+
+    states[idx % threads].push_back(std::move(state));
+  }
+
+  for (auto& thread_states : states) {
+    threads_.emplace_back(&simulator::loop, this, std::move(thread_states));
+  }
+}
+
+void simulator::stop() {
+  running_ = false;
+
+  for (auto& thread : threads_) {
+    if (thread.joinable()) {
+      thread.join();
+    }
+  }
+
+  threads_.clear();
+}
+
+void simulator::loop(std::vector<state_t> states) {
+  while (running_.load(std::memory_order_relaxed)) {
+    auto now = clock::now();
+    auto wake = now + max_sleep;
+
+    for (auto& state : states) {
+      for (std::size_t idx = 0; idx < max_catch_up && state.due <= now;
+           ++idx) {
+        update(state);
+        state.due += state.interval;
+      }
+
+      wake = std::min(wake, state.due);
+    }
+
+    if (wake > clock::now()) {
+      std::this_thread::sleep_until(wake);
+    }
+  }
+}
+
+void simulator::update(state_t& state) {
+  const auto& generator = state.generator;
+
+  if (generator.block == target::input_registers) {
+    for (std::size_t idx = 0; idx < state.registers.size(); ++idx) {
+      state.registers[idx] = value(generator, state.tick, idx);
+    }
+
+    data_table_.input_registers().set(generator.address, state.registers);
+  } else {
+    for (std::size_t idx = 0; idx < state.bits.size(); ++idx) {
+      state.bits[idx] = bit(generator, state.tick, idx);
+    }
+
+    data_table_.discrete_inputs().set(generator.address, state.bits);
+  }
+
+  state.tick++;
+  updates_.fetch_add(generator.count, std::memory_order_relaxed);
+}
+
+simulator::generator_t simulator::parse(std::string_view spec) {
+  auto fields = split(spec);
+
+  if (fields.size() < 4 || fields.size() > 8) {
+    throw std::invalid_argument("invalid generator \"" + std::string(spec)
+                                + "\", expected <kind>:<block>:<address>:"
+                                  "<count>[:<min>:<max>[:<period>[:<rate>]]]");
+  }
+
+  generator_t generator;
+
+  if (fields[0] == "ramp") {
+    generator.kind = waveform::ramp;
+  } else if (fields[0] == "sine") {
+    generator.kind = waveform::sine;
+  } else if (fields[0] == "noise") {
+    generator.kind = waveform::noise;
+  } else if (fields[0] == "counter") {
+    generator.kind = waveform::counter;
+  } else if (fields[0] == "step") {
+    generator.kind = waveform::step;
+  } else {
+    throw std::invalid_argument("invalid generator kind \"" + fields[0]
+                                + "\"");
+  }
+
+  if (fields[1] == "ir") {
+    generator.block = target::input_registers;
+  } else if (fields[1] == "di") {
+    generator.block = target::discrete_inputs;
+  } else {
+    throw std::invalid_argument("invalid generator block \"" + fields[1]
+                                + "\"");
+  }
+
+  generator.address
+      = address_t{static_cast<std::uint16_t>(number(fields[2], 0xFFFF,
+                                                    "address"))};
+  generator.count
+      = static_cast<std::uint16_t>(number(fields[3], 0xFFFF, "count"));
+
+  if (fields.size() == 5) {
+    throw std::invalid_argument("generator min needs a max");
+  }
+
+  if (fields.size() > 5) {
+    generator.min
+        = static_cast<std::uint16_t>(number(fields[4], 0xFFFF, "min"));
+    generator.max
+        = static_cast<std::uint16_t>(number(fields[5], 0xFFFF, "max"));
+  }
+
+  if (fields.size() > 6) {
+    generator.period = static_cast<std::uint32_t>(
+        number(fields[6], 0xFFFFFFFF, "period"));
+  }
+
+  if (fields.size() > 7) {
+    std::size_t parsed = 0;
+    generator.rate = std::stod(fields[7], &parsed);
+
+    if (parsed != fields[7].size() || generator.rate < 0) {
+      throw std::invalid_argument("invalid generator rate \"" + fields[7]
+                                  + "\"");
+    }
+  }
+
+  if (generator.count == 0 || generator.min > generator.max
+      || generator.period == 0) {
+    throw std::invalid_argument("invalid generator \"" + std::string(spec)
+                                + "\"");
+  }
+
+  return generator;
+}
+
+std::uint16_t simulator::value(const generator_t& generator,
+                               std::uint64_t      tick,
+                               std::size_t        index) noexcept {
+  std::uint32_t range = generator.max - generator.min + 1u;
+
+  switch (generator.kind) {
+    case waveform::ramp:
+      return static_cast<std::uint16_t>(generator.min
+                                        + (tick + index) % range);
+    case waveform::sine: {
+      constexpr double two_pi = 6.283185307179586;
+      auto             angle
+          = two_pi * static_cast<double>((tick + index) % generator.period)
+            / generator.period;
+      auto amplitude = static_cast<double>(generator.max - generator.min);
+      return static_cast<std::uint16_t>(
+          generator.min
+          + std::lround(amplitude * (0.5 + 0.5 * std::sin(angle))));
+    }
+    case waveform::noise:
+      return static_cast<std::uint16_t>(generator.min
+                                        + mix(tick, index) % range);
+    case waveform::counter: {
+      auto counter = static_cast<std::uint32_t>(tick + index / 2);
+      return static_cast<std::uint16_t>(index % 2 == 0 ? counter >> 16
+                                                       : counter & 0xFFFF);
+    }
+    case waveform::step:
+      return (tick / generator.period) % 2 == 0 ? generator.min
+                                                : generator.max;
+  }
+
+  return generator.min;
+}
+
+bool simulator::bit(const generator_t& generator,
+                    std::uint64_t      tick,
+                    std::size_t        index) noexcept {
+  if (generator.kind == waveform::counter) {
+    return index < 64 && ((tick >> index) & 1);
+  }
+
+  return value(generator, tick, index)
+         > (static_cast<std::uint32_t>(generator.min) + generator.max) / 2;
+}
+}  // namespace modbus
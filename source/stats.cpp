@@ -0,0 +1,261 @@
+#include <modbuscpp/modbuscpp/stats.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace modbus {
+namespace stats {
+namespace {
+/**
+ * Collector ids
+ */
+std::atomic<std::uint64_t> next_id{1};
+
+/**
+ * Floor of log2
+ *
+ * @param value value, must not be 0
+ *
+ * @return floor(log2(value))
+ */
+inline unsigned int log2_floor(std::uint64_t value) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+  return 63 - static_cast<unsigned int>(__builtin_clzll(value));
+#else
+  unsigned int result = 0;
+
+  while (value >>= 1) {
+    result++;
+  }
+
+  return result;
+#endif
+}
+}  // namespace
+
+histogram_t::histogram_t()
+    : counts(histogram::bucket_count, 0), count{0}, sum{0}, max{0} {}
+
+histogram_t& histogram_t::merge(const histogram_t& other) {
+  for (std::size_t idx = 0; idx < counts.size(); ++idx) {
+    counts[idx] += other.counts[idx];
+  }
+
+  count += other.count;
+  sum += other.sum;
+  max = std::max(max, other.max);
+  return *this;
+}
+
+std::uint64_t histogram_t::value_at(double quantile) const {
+  if (count == 0) {
+    return 0;
+  }
+
+  auto target = static_cast<std::uint64_t>(
+      std::ceil(std::clamp(quantile, 0.0, 1.0) * count));
+  target = std::max<std::uint64_t>(target, 1);
+
+  std::uint64_t seen = 0;
+
+  for (std::size_t idx = 0; idx < counts.size(); ++idx) {
+    seen += counts[idx];
+
+    if (seen >= target) {
+      return std::min(histogram::upper_bound(idx), max);
+    }
+  }
+
+  return max;
+}
+
+double histogram_t::mean() const {
+  return count == 0 ? 0.0 : static_cast<double>(sum) / count;
+}
+
+histogram::histogram() noexcept : count_{0}, sum_{0}, max_{0} {
+  for (auto& counter : counts_) {
+    counter.store(0, std::memory_order_relaxed);
+  }
+}
+
+std::size_t histogram::bucket(std::uint64_t value) noexcept {
+  value = std::min<std::uint64_t>(value, (1ULL << max_exponent) - 1);
+
+  if (value < sub_buckets) {
+    return static_cast<std::size_t>(value);
+  }
+
+  auto shift = log2_floor(value) - sub_bucket_bits;
+  auto sub = (value >> shift) - sub_buckets;
+  return static_cast<std::size_t>((shift + 1) * sub_buckets + sub);
+}
+
+std::uint64_t histogram::lower_bound(std::size_t index) noexcept {
+  if (index < sub_buckets) {
+    return index;
+  }
+
+  auto shift = index / sub_buckets - 1;
+  return (sub_buckets + index % sub_buckets) << shift;
+}
+
+std::uint64_t histogram::upper_bound(std::size_t index) noexcept {
+  if (index < sub_buckets) {
+    return index;
+  }
+
+  auto shift = index / sub_buckets - 1;
+  return lower_bound(index) + (1ULL << shift) - 1;
+}
+
+void histogram::record(std::uint64_t value) noexcept {
+  add(counts_[bucket(value)], 1);
+  add(count_, 1);
+  add(sum_, value);
+
+  if (value > max_.load(std::memory_order_relaxed)) {
+    max_.store(value, std::memory_order_relaxed);
+  }
+}
+
+void histogram::snapshot(histogram_t& out) const {
+  for (std::size_t idx = 0; idx < bucket_count; ++idx) {
+    out.counts[idx] += counts_[idx].load(std::memory_order_relaxed);
+  }
+
+  out.count += count_.load(std::memory_order_relaxed);
+  out.sum += sum_.load(std::memory_order_relaxed);
+  out.max = std::max(out.max, max_.load(std::memory_order_relaxed));
+}
+
+recorder::recorder() noexcept : bytes_in_{0}, bytes_out_{0} {
+  for (auto& counter : requests_) {
+    counter.store(0, std::memory_order_relaxed);
+  }
+
+  for (auto& latency : latency_) {
+    latency.store(nullptr, std::memory_order_relaxed);
+  }
+
+  for (auto& counter : exceptions_) {
+    counter.store(0, std::memory_order_relaxed);
+  }
+}
+
+recorder::~recorder() {
+  for (auto& latency : latency_) {
+    delete latency.load(std::memory_order_relaxed);
+  }
+}
+
+void recorder::request(std::uint8_t function, std::uint64_t latency) noexcept {
+  add(requests_[function], 1);
+
+  auto* latency_histogram = latency_[function].load(std::memory_order_relaxed);
+
+  if (latency_histogram == nullptr) {
+    // first request of this function on this thread
+    latency_histogram = new (std::nothrow) histogram();
+
+    if (latency_histogram == nullptr) {
+      return;
+    }
+
+    latency_[function].store(latency_histogram, std::memory_order_release);
+  }
+
+  latency_histogram->record(latency);
+}
+
+void recorder::exception(constants::exception_code code) noexcept {
+  auto index = utilities::to_underlying(code);
+
+  if (index < exceptions_.size()) {
+    add(exceptions_[index], 1);
+  }
+}
+
+void recorder::stage(stats::stage value, std::uint64_t latency) noexcept {
+  stages_[utilities::to_underlying(value)].record(latency);
+}
+
+void recorder::bytes_in(std::size_t bytes) noexcept { add(bytes_in_, bytes); }
+
+void recorder::bytes_out(std::size_t bytes) noexcept { add(bytes_out_, bytes); }
+
+void recorder::snapshot(snapshot_t& out) const {
+  for (std::size_t function = 0; function < requests_.size(); ++function) {
+    auto requests = requests_[function].load(std::memory_order_relaxed);
+
+    if (requests == 0) {
+      continue;
+    }
+
+    auto& entry = out.functions[static_cast<std::uint8_t>(function)];
+    entry.requests += requests;
+    out.requests += requests;
+
+    if (auto* latency = latency_[function].load(std::memory_order_acquire)) {
+      latency->snapshot(entry.latency);
+    }
+  }
+
+  for (std::size_t code = 0; code < exceptions_.size(); ++code) {
+    auto count = exceptions_[code].load(std::memory_order_relaxed);
+
+    if (count > 0) {
+      out.exceptions[static_cast<constants::exception_code>(code)] += count;
+    }
+  }
+
+  for (std::size_t idx = 0; idx < stage_count; ++idx) {
+    stages_[idx].snapshot(out.stages[idx]);
+  }
+
+  out.bytes_in += bytes_in_.load(std::memory_order_relaxed);
+  out.bytes_out += bytes_out_.load(std::memory_order_relaxed);
+}
+
+collector::collector() noexcept : id_{next_id++} {}
+
+recorder* collector::local() noexcept {
+  thread_local std::uint64_t                      owner = 0;
+  thread_local recorder*                          local = nullptr;
+  thread_local std::map<std::uint64_t, recorder*> known;
+
+  if (owner == id_) {
+    return local;
+  }
+
+  try {
+    auto it = known.find(id_);
+
+    if (it == known.end()) {
+      auto                        created = std::make_unique<recorder>();
+      std::lock_guard<std::mutex> lock(mutex_);
+      recorders_.push_back(std::move(created));
+      it = known.emplace(id_, recorders_.back().get()).first;
+    }
+
+    owner = id_;
+    local = it->second;
+  } catch (...) {
+    return nullptr;
+  }
+
+  return local;
+}
+
+snapshot_t collector::snapshot() const {
+  snapshot_t                  out;
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  for (const auto& local : recorders_) {
+    local->snapshot(out);
+  }
+
+  return out;
+}
+}  // namespace stats
+}  // namespace modbus
@@ -0,0 +1,260 @@
+#include <modbuscpp/modbuscpp/trace.hpp>
+
+#include <algorithm>
+#include <map>
+#include <unordered_map>
+
+#include <fmt/format.h>
+
+namespace modbus {
+namespace trace {
+namespace {
+/**
+ * Ring tracer ids
+ */
+std::atomic<std::uint64_t> next_id{1};
+
+/**
+ * Thread indexes
+ */
+std::atomic<std::uint32_t> next_thread{1};
+
+/**
+ * Bits of request id holding the per-thread sequence
+ */
+constexpr unsigned int request_bits = 40;
+
+/**
+ * Request of calling thread
+ */
+thread_local std::uint64_t current_request = 0;
+
+/**
+ * Round up to power of two
+ *
+ * @param value value
+ *
+ * @return power of two >= value
+ */
+std::size_t power_of_two(std::size_t value) {
+  std::size_t size = 1;
+
+  while (size < value) {
+    size <<= 1;
+  }
+
+  return size;
+}
+}  // namespace
+
+std::atomic<tracer*> tracer::instance_{nullptr};
+
+void tracer::set(tracer* instance) noexcept {
+  instance_.store(instance);
+}
+
+void tracer::unset(tracer* instance) noexcept {
+  instance_.compare_exchange_strong(instance, nullptr);
+}
+
+std::uint32_t tracer::thread() noexcept {
+  thread_local std::uint32_t index = next_thread++;
+  return index;
+}
+
+std::uint64_t tracer::begin_request() noexcept {
+  // thread index in the high bits keeps ids unique without a shared counter
+  thread_local std::uint64_t sequence = 0;
+  current_request = (static_cast<std::uint64_t>(thread()) << request_bits)
+                    | (++sequence & ((1ULL << request_bits) - 1));
+  return current_request;
+}
+
+std::uint64_t tracer::current() noexcept {
+  return current_request;
+}
+
+void tracer::end_request() noexcept {
+  current_request = 0;
+}
+
+void tracer::emit(event         what,
+                  std::uint64_t request,
+                  std::uint64_t begin,
+                  std::uint64_t end) noexcept {
+  if (auto* instance = get()) {
+    span_t span;
+    span.request = request;
+    span.begin = begin;
+    span.end = end;
+    span.thread = thread();
+    span.what = what;
+    instance->record(span);
+  }
+}
+
+ring_tracer::ring::ring(std::size_t size)
+    : slots_{new slot_t[size]}, mask_{size - 1}, written_{0} {}
+
+void ring_tracer::ring::push(const span_t& span) noexcept {
+  auto  index = written_.load(std::memory_order_relaxed);
+  auto& slot = slots_[index & mask_];
+
+  slot.sequence.store(2 * index + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  slot.request.store(span.request, std::memory_order_relaxed);
+  slot.begin.store(span.begin, std::memory_order_relaxed);
+  slot.end.store(span.end, std::memory_order_relaxed);
+  slot.tag.store((static_cast<std::uint64_t>(span.thread) << 8)
+                     | static_cast<std::uint64_t>(span.what),
+                 std::memory_order_relaxed);
+  slot.sequence.store(2 * index + 2, std::memory_order_release);
+  written_.store(index + 1, std::memory_order_release);
+}
+
+void ring_tracer::ring::copy(std::vector<span_t>& out) const {
+  auto written = written_.load(std::memory_order_acquire);
+  auto first = written > mask_ + 1 ? written - (mask_ + 1) : 0;
+
+  for (auto index = first; index < written; ++index) {
+    const auto& slot = slots_[index & mask_];
+    auto        sequence = slot.sequence.load(std::memory_order_acquire);
+
+    span_t span;
+    span.request = slot.request.load(std::memory_order_relaxed);
+    span.begin = slot.begin.load(std::memory_order_relaxed);
+    span.end = slot.end.load(std::memory_order_relaxed);
+    auto tag = slot.tag.load(std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_acquire);
+
+    if (sequence != 2 * index + 2
+        || slot.sequence.load(std::memory_order_relaxed) != sequence) {
+      // overwritten while copying
+      continue;
+    }
+
+    span.thread = static_cast<std::uint32_t>(tag >> 8);
+    span.what = static_cast<event>(tag & 0xFF);
+    out.push_back(span);
+  }
+}
+
+ring_tracer::ring_tracer(std::size_t capacity)
+    : capacity_{power_of_two(std::max<std::size_t>(capacity, 2))},
+      id_{next_id++} {}
+
+ring_tracer::~ring_tracer() {
+  unset(this);
+}
+
+ring_tracer::ring* ring_tracer::local() noexcept {
+  thread_local std::uint64_t                  owner = 0;
+  thread_local ring*                          local = nullptr;
+  thread_local std::map<std::uint64_t, ring*> known;
+
+  if (owner == id_) {
+    return local;
+  }
+
+  try {
+    auto it = known.find(id_);
+
+    if (it == known.end()) {
+      auto                        created = std::make_unique<ring>(capacity_);
+      std::lock_guard<std::mutex> lock(mutex_);
+      rings_.push_back(std::move(created));
+      it = known.emplace(id_, rings_.back().get()).first;
+    }
+
+    owner = id_;
+    local = it->second;
+  } catch (...) {
+    return nullptr;
+  }
+
+  return local;
+}
+
+void ring_tracer::record(const span_t& span) noexcept {
+  if (auto* target = local()) {
+    target->push(span);
+  }
+}
+
+std::vector<span_t> ring_tracer::spans() const {
+  std::vector<span_t> out;
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    for (const auto& target : rings_) {
+      target->copy(out);
+    }
+  }
+
+  std::sort(out.begin(), out.end(), [](const auto& lhs, const auto& rhs) {
+    return lhs.begin < rhs.begin;
+  });
+  return out;
+}
+
+std::vector<span_t> ring_tracer::spans(std::uint64_t min_duration) const {
+  auto all = spans();
+
+  if (min_duration == 0) {
+    return all;
+  }
+
+  // request duration: first begin to last end of its spans
+  std::unordered_map<std::uint64_t, std::pair<std::uint64_t, std::uint64_t>>
+      requests;
+
+  for (const auto& span : all) {
+    if (span.request == 0) {
+      continue;
+    }
+
+    auto [it, inserted]
+        = requests.try_emplace(span.request, span.begin, span.end);
+
+    if (!inserted) {
+      it->second.first = std::min(it->second.first, span.begin);
+      it->second.second = std::max(it->second.second, span.end);
+    }
+  }
+
+  std::vector<span_t> out;
+
+  for (const auto& span : all) {
+    auto it = requests.find(span.request);
+
+    if (it != requests.end()
+        && it->second.second - it->second.first >= min_duration) {
+      out.push_back(span);
+    }
+  }
+
+  return out;
+}
+
+void ring_tracer::dump(std::ostream& os, std::uint64_t min_duration) const {
+  os << "{\"traceEvents\":[";
+
+  bool first = true;
+
+  for (const auto& span : spans(min_duration)) {
+    // complete events, timestamps in microseconds
+    os << (first ? "\n" : ",\n")
+       << fmt::format(
+              "{{\"name\":\"{}\",\"cat\":\"modbus\",\"ph\":\"X\","
+              "\"ts\":{:.3f},\"dur\":{:.3f},\"pid\":1,\"tid\":{},"
+              "\"args\":{{\"request\":{}}}}}",
+              event_str(span.what), span.begin / 1e3,
+              (span.end - span.begin) / 1e3, span.thread, span.request);
+    first = false;
+  }
+
+  os << "\n],\"displayTimeUnit\":\"ns\"}\n";
+}
+}  // namespace trace
+}  // namespace modbus
@@ -0,0 +1,245 @@
+#include <modbuscpp/modbuscpp/traffic-capture.hpp>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <system_error>
+
+#if defined(__unix__) || defined(__APPLE__)
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <unistd.h>
+#  define MODBUSCPP_CAPTURE_MMAP 1
+#endif
+
+#include <modbuscpp/modbuscpp/constants.hpp>
+#include <modbuscpp/modbuscpp/exception.hpp>
+
+namespace modbus {
+namespace {
+/**
+ * Store value at pointer (host byte order)
+ *
+ * @tparam T value type
+ *
+ * @param ptr   destination
+ * @param value value
+ */
+template <typename T> inline void store(char* ptr, T value) noexcept {
+  std::memcpy(ptr, &value, sizeof(T));
+}
+
+/**
+ * Load value from pointer (host byte order)
+ *
+ * @tparam T value type
+ *
+ * @param ptr source
+ *
+ * @return value
+ */
+template <typename T> inline T load(const char* ptr) noexcept {
+  T value;
+  std::memcpy(&value, ptr, sizeof(T));
+  return value;
+}
+
+/**
+ * Get current time
+ *
+ * @return nanoseconds since epoch
+ */
+inline std::uint64_t now() noexcept {
+  return static_cast<std::uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::system_clock::now().time_since_epoch())
+          .count());
+}
+}  // namespace
+
+traffic_capture::traffic_capture(const initializer_t& initializer)
+    : fd_{-1},
+      data_{nullptr},
+      size_{0},
+      chunk_size_{std::max<std::size_t>(
+          initializer.chunk_size,
+          chunk_header_size + record_header_size + constants::max_adu_length)},
+      chunk_count_{std::max<std::size_t>(
+          (initializer.size > file_header_size
+               ? initializer.size - file_header_size
+               : 0)
+              / chunk_size_,
+          2)},
+      chunk_{nullptr},
+      used_{0},
+      sequence_{0},
+      written_{0} {
+#ifdef MODBUSCPP_CAPTURE_MMAP
+  size_ = file_header_size + chunk_count_ * chunk_size_;
+  fd_ = ::open(initializer.path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+
+  if (fd_ < 0) {
+    throw std::system_error(errno, std::generic_category(),
+                            "cannot create capture file " + initializer.path);
+  }
+
+  if (::ftruncate(fd_, static_cast<off_t>(size_)) != 0) {
+    auto error = errno;
+    ::close(fd_);
+    throw std::system_error(error, std::generic_category(),
+                            "cannot size capture file " + initializer.path);
+  }
+
+  auto* mapped
+      = ::mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+
+  if (mapped == MAP_FAILED) {
+    auto error = errno;
+    ::close(fd_);
+    throw std::system_error(error, std::generic_category(),
+                            "cannot map capture file " + initializer.path);
+  }
+
+  data_ = static_cast<char*>(mapped);
+  std::memcpy(data_, magic.data(), magic.size());
+  store<std::uint32_t>(data_ + 8, version);
+  store<std::uint32_t>(data_ + 12, static_cast<std::uint32_t>(chunk_size_));
+  store<std::uint64_t>(data_ + 16, chunk_count_);
+  next_chunk();
+#else
+  throw std::system_error(std::make_error_code(std::errc::not_supported),
+                          "traffic capture needs mmap");
+#endif
+}
+
+traffic_capture::~traffic_capture() {
+#ifdef MODBUSCPP_CAPTURE_MMAP
+  if (data_ != nullptr) {
+    ::munmap(data_, size_);
+  }
+
+  if (fd_ >= 0) {
+    ::close(fd_);
+  }
+#endif
+}
+
+void traffic_capture::next_chunk() noexcept {
+  chunk_ = data_ + file_header_size + (sequence_ % chunk_count_) * chunk_size_;
+  used_ = chunk_header_size;
+  ++sequence_;
+
+  // invalidate before reuse so readers never pair old records with the new
+  // sequence
+  store<std::uint32_t>(chunk_ + 8, 0);
+  std::atomic_thread_fence(std::memory_order_release);
+  store<std::uint64_t>(chunk_, sequence_);
+  store<std::uint32_t>(chunk_ + 8, used_);
+}
+
+void traffic_capture::write(direction        dir,
+                            std::uint64_t    session,
+                            std::string_view adu) noexcept {
+  if (data_ == nullptr) {
+    return;
+  }
+
+  auto timestamp = now();
+  auto length = static_cast<std::uint16_t>(
+      std::min<std::size_t>(adu.size(), constants::max_adu_length));
+  std::size_t record_size = record_header_size + length;
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (used_ + record_size > chunk_size_) {
+      next_chunk();
+    }
+
+    char* record = chunk_ + used_;
+    store<std::uint64_t>(record, timestamp);
+    store<std::uint64_t>(record + 8, session);
+    store<std::uint16_t>(record + 16, length);
+    store<std::uint8_t>(record + 18, utilities::to_underlying(dir));
+    store<std::uint8_t>(record + 19, 0);
+    std::memcpy(record + record_header_size, adu.data(), length);
+
+    used_ += static_cast<std::uint32_t>(record_size);
+    std::atomic_thread_fence(std::memory_order_release);
+    store<std::uint32_t>(chunk_ + 8, used_);
+  }
+
+  written_.fetch_add(1, std::memory_order_relaxed);
+}
+
+std::vector<traffic_capture::record_t> traffic_capture::read(
+    const std::string& path) {
+  std::ifstream file(path, std::ios::binary);
+
+  if (!file) {
+    throw ex::bad_data();
+  }
+
+  std::vector<char> data{std::istreambuf_iterator<char>(file),
+                         std::istreambuf_iterator<char>()};
+
+  if (data.size() < file_header_size
+      || std::string_view(data.data(), magic.size()) != magic
+      || load<std::uint32_t>(data.data() + 8) != version) {
+    throw ex::bad_data();
+  }
+
+  auto chunk_size = load<std::uint32_t>(data.data() + 12);
+  auto chunk_count = load<std::uint64_t>(data.data() + 16);
+
+  if (chunk_size < chunk_header_size
+      || data.size() < file_header_size + chunk_count * chunk_size) {
+    throw ex::bad_data();
+  }
+
+  // chunks by sequence, unused chunks have sequence 0
+  std::vector<std::pair<std::uint64_t, const char*>> chunks;
+
+  for (std::uint64_t idx = 0; idx < chunk_count; ++idx) {
+    const char* chunk = data.data() + file_header_size + idx * chunk_size;
+    auto        sequence = load<std::uint64_t>(chunk);
+
+    if (sequence != 0) {
+      chunks.emplace_back(sequence, chunk);
+    }
+  }
+
+  std::sort(chunks.begin(), chunks.end());
+
+  std::vector<record_t> records;
+
+  for (const auto& [sequence, chunk] : chunks) {
+    auto        used = std::min<std::uint32_t>(load<std::uint32_t>(chunk + 8),
+                                        chunk_size);
+    std::size_t offset = chunk_header_size;
+
+    while (offset + record_header_size <= used) {
+      const char* record = chunk + offset;
+      auto        length = load<std::uint16_t>(record + 16);
+
+      if (offset + record_header_size + length > used) {
+        break;
+      }
+
+      record_t out;
+      out.timestamp = load<std::uint64_t>(record);
+      out.session = load<std::uint64_t>(record + 8);
+      out.dir = static_cast<direction>(load<std::uint8_t>(record + 18));
+      out.adu.assign(record + record_header_size,
+                     record + record_header_size + length);
+      records.push_back(std::move(out));
+      offset += record_header_size + length;
+    }
+  }
+
+  return records;
+}
+}  // namespace modbus
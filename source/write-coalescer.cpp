@@ -0,0 +1,167 @@
+#include <modbuscpp/modbuscpp/write-coalescer.hpp>
+
+#include <utility>
+
+#include <modbuscpp/modbuscpp/bit-write.hpp>
+#include <modbuscpp/modbuscpp/register-write.hpp>
+#include <modbuscpp/modbuscpp/request.hpp>
+
+namespace modbus {
+write_coalescer::write_coalescer() noexcept
+    : write_coalescer{initializer_t{}} {}
+
+write_coalescer::write_coalescer(const initializer_t& initializer) noexcept
+    : initializer_{initializer} {}
+
+void write_coalescer::write_register(std::uint8_t       unit,
+                                     const address_t&   address,
+                                     const reg_value_t& value,
+                                     clock::time_point  now) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  push(unit, false, address(), value(), now);
+}
+
+void write_coalescer::write_coil(std::uint8_t      unit,
+                                 const address_t&  address,
+                                 bool              value,
+                                 clock::time_point now) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  push(unit, true, address(), value, now);
+}
+
+bool write_coalescer::full(const run_t& run) const {
+  return run.size() >= (run.coils ? initializer_.max_coils
+                                  : initializer_.max_registers);
+}
+
+void write_coalescer::push(std::uint8_t      unit,
+                           bool              coils,
+                           std::uint32_t     address,
+                           std::uint16_t     value,
+                           clock::time_point now) {
+  // only the most recent run of the unit may grow, otherwise the write
+  // would overtake writes issued after that run
+  for (auto it = runs_.rbegin(); it != runs_.rend(); ++it) {
+    if (it->unit != unit) {
+      continue;
+    }
+
+    auto& run = *it;
+
+    if (run.coils != coils || full(run)) {
+      break;
+    }
+
+    if (address == run.address + run.size()) {
+      // append
+      if (coils) {
+        run.bits.push_back(value != 0);
+      } else {
+        run.registers.push_back(value);
+      }
+      run.writes++;
+      return;
+    }
+
+    if (address + 1 == run.address) {
+      // prepend, values in one request are written at once
+      if (coils) {
+        run.bits.insert(run.bits.begin(), value != 0);
+      } else {
+        run.registers.insert(run.registers.begin(), value);
+      }
+      run.address = address;
+      run.writes++;
+      return;
+    }
+
+    break;
+  }
+
+  run_t run{unit, coils, address, {}, {}, now, 1};
+
+  if (coils) {
+    run.bits.push_back(value != 0);
+  } else {
+    run.registers.push_back(value);
+  }
+
+  runs_.push_back(std::move(run));
+}
+
+write_coalescer::batch_t write_coalescer::make_batch(run_t& run) {
+  std::unique_ptr<internal::request> request;
+
+  if (run.coils) {
+    if (run.bits.size() == 1) {
+      request = std::make_unique<request::write_single_coil>(
+          address_t{static_cast<std::uint16_t>(run.address)},
+          run.bits.front() ? value::bits::on : value::bits::off);
+    } else {
+      auto count = static_cast<std::uint16_t>(run.bits.size());
+      request = std::make_unique<request::write_multiple_coils>(
+          address_t{static_cast<std::uint16_t>(run.address)},
+          write_num_bits_t{count}, std::move(run.bits));
+    }
+  } else {
+    if (run.registers.size() == 1) {
+      request = std::make_unique<request::write_single_register>(
+          address_t{static_cast<std::uint16_t>(run.address)},
+          reg_value_t{run.registers.front()});
+    } else {
+      auto count = static_cast<std::uint16_t>(run.registers.size());
+      request = std::make_unique<request::write_multiple_registers>(
+          address_t{static_cast<std::uint16_t>(run.address)},
+          write_num_regs_t{count}, std::move(run.registers));
+    }
+  }
+
+  request->unit(run.unit);
+  return {run.unit, std::move(request), run.writes};
+}
+
+std::vector<write_coalescer::batch_t> write_coalescer::poll(
+    clock::time_point now) {
+  std::vector<batch_t>        batches;
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  // runs leave in issue order: stop at the first run that is not due
+  while (!runs_.empty()
+         && (full(runs_.front())
+             || now - runs_.front().since >= initializer_.window)) {
+    batches.push_back(make_batch(runs_.front()));
+    runs_.pop_front();
+  }
+
+  return batches;
+}
+
+std::vector<write_coalescer::batch_t> write_coalescer::flush() {
+  std::vector<batch_t>        batches;
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  batches.reserve(runs_.size());
+
+  for (auto& run : runs_) {
+    batches.push_back(make_batch(run));
+  }
+
+  runs_.clear();
+  return batches;
+}
+
+write_coalescer::clock::time_point write_coalescer::deadline() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  if (runs_.empty()) {
+    return clock::time_point::max();
+  }
+
+  return runs_.front().since + initializer_.window;
+}
+
+std::size_t write_coalescer::pending() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return runs_.size();
+}
+}  // namespace modbus
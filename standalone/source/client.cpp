@@ -1,6 +1,8 @@
+#include <chrono>
 #include <cstdlib>
 #include <cstring>
 #include <iostream>
+#include <memory>
 #include <string>
 #include <string_view>
 
@@ -49,11 +51,19 @@ protected:
 int main(int argc, char* argv[]) {
   spdlog::set_level(spdlog::level::debug);
   try {
-    if (argc != 3) {
-      spdlog::error("Usage: tcp_client <host> <port>");
+    if (argc != 3 && argc != 4) {
+      spdlog::error("Usage: tcp_client <host> <port> [capture file]");
       return 1;
     }
 
+    modbus::traffic_capture::pointer capture;
+
+    if (argc == 4) {
+      modbus::traffic_capture::initializer_t initializer;
+      initializer.path = argv[3];
+      capture = modbus::traffic_capture::create(initializer);
+    }
+
     modbus::logger::create<client_logger>(true);
     asio2::tcp_client client;
 
@@ -83,6 +93,9 @@ int main(int argc, char* argv[]) {
 
     auto request = req.encode();
 
+    modbus::rtt_estimator rtt;
+    auto                  sent_at = std::chrono::steady_clock::now();
+
     client.auto_reconnect(true, std::chrono::milliseconds(1000));
     // client.start_timer(1, std::chrono::seconds(1), []() {});
     client
@@ -96,13 +109,25 @@ int main(int argc, char* argv[]) {
           }
 
           cout_bytes(request);
-          client.send(request);
+          sent_at = std::chrono::steady_clock::now();
+
+          if (capture) {
+            capture->write(modbus::traffic_capture::direction::request, 0,
+                           request);
+          }
+
+          client.send(request.view());
         })
         .bind_disconnect([]([[maybe_unused]] asio::error_code ec) {
           /*LOG_DEBUG("disconnect : {} {}", asio2::last_error_val(),*/
           /*asio2::last_error_msg());*/
         })
         .bind_recv([&](std::string_view packet) {
+          if (capture) {
+            capture->write(modbus::traffic_capture::direction::response, 0,
+                           packet);
+          }
+
           try {
             // modbus::response::read_coils response(&req);
             // modbus::response::write_single_coil response(&req);
@@ -113,6 +138,10 @@ int main(int argc, char* argv[]) {
             modbus::response::read_write_multiple_registers response(&req);
             response.decode(packet);
             cout_bytes(packet);
+            rtt.sample(std::chrono::steady_clock::now() - sent_at);
+            spdlog::debug("RTT srtt={}us rttvar={}us timeout={}us",
+                          rtt.srtt().count(), rtt.rttvar().count(),
+                          rtt.timeout().count());
           } catch (const modbus::ex::specification_error& exc) {
             spdlog::error("Modbus exception occured {}", exc.what());
           } catch (const modbus::ex::base_error& exc) {
@@ -0,0 +1,643 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <deque>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <spdlog/spdlog.h>
+
+#include <boost/asio.hpp>
+
+#include <modbuscpp/modbus.hpp>
+
+namespace {
+using clock_type = std::chrono::steady_clock;
+using modbus::constants::function_code;
+
+/**
+ * Load options
+ */
+struct options_t {
+  /**
+   * Server host
+   */
+  std::string host;
+  /**
+   * Server port
+   */
+  std::string port;
+  /**
+   * Number of connections
+   */
+  std::size_t connections = 8;
+  /**
+   * Max in-flight requests per connection
+   */
+  std::size_t depth = 1;
+  /**
+   * Run duration
+   */
+  std::chrono::seconds duration{10};
+  /**
+   * Total request rate (req/s), 0 for closed loop
+   */
+  double rate = 0;
+  /**
+   * Function code mix
+   */
+  std::string mix = "3:60,4:10,1:10,16:10,6:10";
+  /**
+   * Number of io threads
+   */
+  std::size_t threads = 1;
+  /**
+   * Time after which an unanswered request is dropped
+   */
+  std::chrono::milliseconds timeout{1000};
+};
+
+/**
+ * Function code mix entry
+ */
+struct mix_entry_t {
+  /**
+   * Function code
+   */
+  function_code function;
+  /**
+   * Encoded request, transaction id is patched per request
+   */
+  modbus::packet_t packet;
+  /**
+   * Cumulative weight
+   */
+  unsigned int weight;
+};
+
+/**
+ * Encode request template of function code
+ *
+ * @param function function code
+ *
+ * @return encoded request
+ */
+modbus::packet_t encode(function_code function) {
+  modbus::address_t address{0x10};
+  auto              encode = [](auto&& request) {
+    request.initialize({0x0000, 0x01});
+    return request.encode();
+  };
+
+  switch (function) {
+    case function_code::read_coils:
+      return encode(
+          modbus::request::read_coils(address, modbus::read_num_bits_t{16}));
+    case function_code::read_discrete_inputs:
+      return encode(modbus::request::read_discrete_inputs(
+          address, modbus::read_num_bits_t{16}));
+    case function_code::read_holding_registers:
+      return encode(modbus::request::read_holding_registers(
+          address, modbus::read_num_regs_t{10}));
+    case function_code::read_input_registers:
+      return encode(modbus::request::read_input_registers(
+          address, modbus::read_num_regs_t{10}));
+    case function_code::write_single_coil:
+      return encode(
+          modbus::request::write_single_coil(address, modbus::value::bits::on));
+    case function_code::write_single_register:
+      return encode(modbus::request::write_single_register(
+          address, modbus::reg_value_t{0x1234}));
+    case function_code::write_multiple_coils:
+      return encode(modbus::request::write_multiple_coils(
+          address, modbus::write_num_bits_t{16},
+          modbus::block::bits::container_type(16, true)));
+    case function_code::write_multiple_registers:
+      return encode(modbus::request::write_multiple_registers(
+          address, modbus::write_num_regs_t{10},
+          modbus::block::registers::container_type(10, 0x1234)));
+    case function_code::mask_write_register:
+      return encode(modbus::request::mask_write_register(
+          address, modbus::mask_t{0xF2}, modbus::mask_t{0x25}));
+    case function_code::read_write_multiple_registers:
+      return encode(modbus::request::read_write_multiple_registers(
+          address, modbus::read_num_regs_t{10}, address,
+          modbus::write_num_regs_t{4}, {1, 2, 3, 4}));
+    default:
+      throw std::invalid_argument(
+          fmt::format("unsupported function code {:#04x}",
+                      modbus::utilities::to_underlying(function)));
+  }
+}
+
+/**
+ * Parse function code mix
+ *
+ * @param mix "<function code>:<weight>,..." e.g. "3:60,16:40"
+ *
+ * @return mix entries
+ */
+std::vector<mix_entry_t> parse_mix(const std::string& mix) {
+  std::vector<mix_entry_t> entries;
+  std::stringstream        stream(mix);
+  std::string              item;
+  unsigned int             total = 0;
+
+  while (std::getline(stream, item, ',')) {
+    auto separator = item.find(':');
+    auto function = static_cast<function_code>(
+        std::stoul(item.substr(0, separator), nullptr, 0));
+    auto weight = separator == std::string::npos
+                      ? 1
+                      : std::stoul(item.substr(separator + 1));
+
+    if (weight == 0) {
+      continue;
+    }
+
+    total += static_cast<unsigned int>(weight);
+    entries.push_back({function, encode(function), total});
+  }
+
+  if (entries.empty()) {
+    throw std::invalid_argument("empty function code mix");
+  }
+
+  return entries;
+}
+
+/**
+ * Connection results
+ */
+struct result_t {
+  /**
+   * Latency from intended send time (ns), corrected for coordinated
+   * omission
+   */
+  std::vector<std::uint64_t> corrected;
+  /**
+   * Latency from actual send time (ns)
+   */
+  std::vector<std::uint64_t> uncorrected;
+  /**
+   * Exception responses
+   */
+  std::uint64_t exceptions = 0;
+  /**
+   * Connect / io errors
+   */
+  std::uint64_t io_errors = 0;
+  /**
+   * Responses with unknown transaction id, including late responses to
+   * requests that already timed out
+   */
+  std::uint64_t unmatched = 0;
+  /**
+   * Requests dropped without a response
+   */
+  std::uint64_t timeouts = 0;
+};
+
+/**
+ * Load generating connection
+ *
+ * Keeps up to depth requests in flight. In open loop (rate > 0) requests
+ * are scheduled at a fixed interval; a request that cannot be sent because
+ * the window is full keeps its scheduled time, so latency is measured from
+ * when it should have been sent rather than when it was.
+ *
+ * A request that is not answered within the timeout is dropped and counted,
+ * so a lost request frees its window slot instead of stalling the
+ * connection.
+ */
+class connection : public std::enable_shared_from_this<connection> {
+public:
+  connection(boost::asio::io_context&                     io,
+             const boost::asio::ip::tcp::resolver::results_type& endpoints,
+             const options_t&                             options,
+             const std::vector<mix_entry_t>&              mix,
+             unsigned int                                 seed)
+      : socket_{io},
+        timer_{io},
+        deadline_{io},
+        endpoints_{endpoints},
+        options_{options},
+        mix_{mix},
+        engine_{seed},
+        pick_{0, mix.back().weight - 1},
+        interval_{options.rate > 0
+                      ? std::chrono::nanoseconds(static_cast<std::int64_t>(
+                          1e9 * static_cast<double>(options.connections)
+                          / options.rate))
+                      : std::chrono::nanoseconds{0}},
+        transaction_{static_cast<std::uint16_t>(seed)} {}
+
+  /**
+   * Connect and start sending
+   */
+  void start() {
+    boost::asio::async_connect(
+        socket_, endpoints_,
+        [self = shared_from_this()](const boost::system::error_code& ec,
+                                    const auto&) {
+          if (ec) {
+            self->result_.io_errors++;
+            return;
+          }
+
+          self->socket_.set_option(boost::asio::ip::tcp::no_delay(true));
+          self->next_due_ = clock_type::now();
+          self->receive();
+          self->pump();
+        });
+  }
+
+  /**
+   * Get results
+   *
+   * @return results
+   */
+  inline const result_t& result() const { return result_; }
+
+private:
+  /**
+   * In-flight request
+   */
+  struct in_flight_t {
+    clock_type::time_point intended;
+    clock_type::time_point sent;
+  };
+
+  /**
+   * Send as many requests as the window and schedule allow
+   */
+  void pump() {
+    auto now = clock_type::now();
+
+    while (in_flight_.size() < options_.depth) {
+      if (interval_.count() == 0) {
+        send(now);
+      } else if (next_due_ <= now) {
+        send(next_due_);
+        next_due_ += interval_;
+      } else {
+        break;
+      }
+    }
+
+    if (interval_.count() != 0 && in_flight_.size() < options_.depth
+        && !timer_armed_) {
+      timer_armed_ = true;
+      timer_.expires_at(next_due_);
+      timer_.async_wait([self = shared_from_this()](
+                            const boost::system::error_code& ec) {
+        self->timer_armed_ = false;
+
+        if (!ec) {
+          self->pump();
+        }
+      });
+    }
+  }
+
+  /**
+   * Send request
+   *
+   * @param intended intended send time
+   */
+  void send(clock_type::time_point intended) {
+    auto  weight = pick_(engine_);
+    auto& entry = *std::find_if(mix_.begin(), mix_.end(), [&](auto& entry) {
+      return weight < entry.weight;
+    });
+
+    auto transaction = transaction_++;
+    outgoing_.push_back(entry.packet);
+    outgoing_.back()[0] = static_cast<char>(transaction >> 8);
+    outgoing_.back()[1] = static_cast<char>(transaction & 0xFF);
+    in_flight_[transaction] = {intended, clock_type::now()};
+
+    if (outgoing_.size() == 1) {
+      write();
+    }
+
+    expire();
+  }
+
+  /**
+   * Arm deadline timer for the oldest in-flight request
+   */
+  void expire() {
+    if (deadline_armed_ || in_flight_.empty()) {
+      return;
+    }
+
+    auto oldest = std::min_element(
+        in_flight_.begin(), in_flight_.end(), [](auto& lhs, auto& rhs) {
+          return lhs.second.sent < rhs.second.sent;
+        });
+
+    deadline_armed_ = true;
+    deadline_.expires_at(oldest->second.sent + options_.timeout);
+    deadline_.async_wait(
+        [self = shared_from_this()](const boost::system::error_code& ec) {
+          self->deadline_armed_ = false;
+
+          if (ec) {
+            return;
+          }
+
+          auto now = clock_type::now();
+
+          for (auto it = self->in_flight_.begin();
+               it != self->in_flight_.end();) {
+            if (now - it->second.sent >= self->options_.timeout) {
+              self->result_.timeouts++;
+              it = self->in_flight_.erase(it);
+            } else {
+              ++it;
+            }
+          }
+
+          self->pump();
+          self->expire();
+        });
+  }
+
+  /**
+   * Write queued requests one at a time
+   */
+  void write() {
+    boost::asio::async_write(
+        socket_,
+        boost::asio::buffer(outgoing_.front().data(), outgoing_.front().size()),
+        [self = shared_from_this()](const boost::system::error_code& ec,
+                                    std::size_t) {
+          if (ec) {
+            self->result_.io_errors++;
+            return;
+          }
+
+          self->outgoing_.pop_front();
+
+          if (!self->outgoing_.empty()) {
+            self->write();
+          }
+        });
+  }
+
+  /**
+   * Read next response
+   */
+  void receive() {
+    boost::asio::async_read(
+        socket_,
+        boost::asio::buffer(header_, modbus::internal::adu::header_length - 1),
+        [self = shared_from_this()](const boost::system::error_code& ec,
+                                    std::size_t) {
+          if (ec) {
+            self->result_.io_errors++;
+            return;
+          }
+
+          // MBAP length counts the unit id and the PDU
+          std::size_t length
+              = (static_cast<std::uint8_t>(self->header_[4]) << 8)
+                | static_cast<std::uint8_t>(self->header_[5]);
+          if (length > self->body_.max_size()) {
+            self->result_.io_errors++;
+            return;
+          }
+
+          self->body_.resize(length);
+          boost::asio::async_read(
+              self->socket_,
+              boost::asio::buffer(self->body_.data(), self->body_.size()),
+              [self](const boost::system::error_code& ec, std::size_t) {
+                if (ec) {
+                  self->result_.io_errors++;
+                  return;
+                }
+
+                self->complete();
+                self->receive();
+              });
+        });
+  }
+
+  /**
+   * Record completed request
+   */
+  void complete() {
+    auto          now = clock_type::now();
+    std::uint16_t transaction
+        = (static_cast<std::uint8_t>(header_[0]) << 8)
+          | static_cast<std::uint8_t>(header_[1]);
+    auto request = in_flight_.find(transaction);
+
+    if (request == in_flight_.end()) {
+      result_.unmatched++;
+      return;
+    }
+
+    // exception responses set the high bit of the function code
+    if (body_.size() > 1 && (static_cast<std::uint8_t>(body_[1]) & 0x80)) {
+      result_.exceptions++;
+    }
+
+    result_.corrected.push_back(nanoseconds(now - request->second.intended));
+    result_.uncorrected.push_back(nanoseconds(now - request->second.sent));
+    in_flight_.erase(request);
+    pump();
+  }
+
+  /**
+   * Convert duration to nanoseconds
+   *
+   * @param duration duration
+   *
+   * @return nanoseconds
+   */
+  static std::uint64_t nanoseconds(clock_type::duration duration) {
+    return static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(duration)
+            .count());
+  }
+
+private:
+  boost::asio::ip::tcp::socket                      socket_;
+  boost::asio::steady_timer                         timer_;
+  boost::asio::steady_timer                         deadline_;
+  boost::asio::ip::tcp::resolver::results_type      endpoints_;
+  const options_t&                                  options_;
+  const std::vector<mix_entry_t>&                   mix_;
+  std::minstd_rand                                  engine_;
+  std::uniform_int_distribution<unsigned int>       pick_;
+  std::chrono::nanoseconds                          interval_;
+  clock_type::time_point                            next_due_;
+  bool                                              timer_armed_ = false;
+  bool                                              deadline_armed_ = false;
+  std::uint16_t                                     transaction_;
+  std::unordered_map<std::uint16_t, in_flight_t>    in_flight_;
+  std::deque<modbus::packet_t>                      outgoing_;
+  char header_[modbus::internal::adu::header_length - 1];
+  modbus::packet_t                                  body_;
+  result_t                                          result_;
+};
+
+/**
+ * Report latency percentiles
+ *
+ * @param name      latency name
+ * @param latencies latencies (ns), sorted in place
+ */
+void report(const char* name, std::vector<std::uint64_t>& latencies) {
+  std::sort(latencies.begin(), latencies.end());
+
+  auto at = [&](double percentile) {
+    if (latencies.empty()) {
+      return 0.0;
+    }
+
+    auto rank = static_cast<std::size_t>(
+        percentile / 100.0 * static_cast<double>(latencies.size() - 1) + 0.5);
+    return static_cast<double>(latencies[rank]) / 1000.0;
+  };
+
+  spdlog::info("{} latency us p50={:.1f} p99={:.1f} p99.9={:.1f} max={:.1f}",
+               name, at(50), at(99), at(99.9), at(100));
+}
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  spdlog::set_level(spdlog::level::info);
+
+  if (argc < 3 || argc > 10) {
+    spdlog::error("Usage: load-generator <host> <port> [connections] [depth] "
+                  "[seconds] [rate] [mix] [threads] [timeout]");
+    spdlog::error("  connections  concurrent connections (default 8)");
+    spdlog::error("  depth        in-flight requests per connection "
+                  "(default 1)");
+    spdlog::error("  seconds      run duration (default 10)");
+    spdlog::error("  rate         total req/s, 0 for closed loop (default 0)");
+    spdlog::error("  mix          <function code>:<weight>,... "
+                  "(default 3:60,4:10,1:10,16:10,6:10)");
+    spdlog::error("  threads      io threads (default 1)");
+    spdlog::error("  timeout      ms before an unanswered request is dropped "
+                  "(default 1000)");
+    return 1;
+  }
+
+  options_t options;
+  options.host = argv[1];
+  options.port = argv[2];
+
+  try {
+    if (argc > 3) {
+      options.connections = std::max<std::size_t>(1, std::stoul(argv[3]));
+    }
+
+    if (argc > 4) {
+      options.depth = std::max<std::size_t>(1, std::stoul(argv[4]));
+    }
+
+    if (argc > 5) {
+      options.duration = std::chrono::seconds(std::stoul(argv[5]));
+    }
+
+    if (argc > 6) {
+      options.rate = std::stod(argv[6]);
+    }
+
+    if (argc > 7) {
+      options.mix = argv[7];
+    }
+
+    if (argc > 8) {
+      options.threads = std::max<std::size_t>(1, std::stoul(argv[8]));
+    }
+
+    if (argc > 9) {
+      options.timeout = std::chrono::milliseconds(
+          std::max<unsigned long>(1, std::stoul(argv[9])));
+    }
+
+    auto mix = parse_mix(options.mix);
+
+    std::vector<std::unique_ptr<boost::asio::io_context>> contexts;
+    std::vector<std::shared_ptr<connection>>              connections;
+
+    for (std::size_t idx = 0; idx < options.threads; ++idx) {
+      contexts.push_back(std::make_unique<boost::asio::io_context>());
+    }
+
+    boost::asio::ip::tcp::resolver resolver(*contexts.front());
+    auto endpoints = resolver.resolve(options.host, options.port);
+
+    for (std::size_t idx = 0; idx < options.connections; ++idx) {
+      auto& io = *contexts[idx % contexts.size()];
+      connections.push_back(std::make_shared<connection>(
+          io, endpoints, options, mix, static_cast<unsigned int>(idx + 1)));
+      connections.back()->start();
+    }
+
+    std::vector<std::thread> threads;
+
+    for (auto& io : contexts) {
+      threads.emplace_back([&io, &options] {
+        io->run_for(options.duration);
+      });
+    }
+
+    for (auto& thread : threads) {
+      thread.join();
+    }
+
+    result_t total;
+
+    for (const auto& connection : connections) {
+      const auto& result = connection->result();
+      total.corrected.insert(total.corrected.end(), result.corrected.begin(),
+                             result.corrected.end());
+      total.uncorrected.insert(total.uncorrected.end(),
+                               result.uncorrected.begin(),
+                               result.uncorrected.end());
+      total.exceptions += result.exceptions;
+      total.io_errors += result.io_errors;
+      total.unmatched += result.unmatched;
+      total.timeouts += result.timeouts;
+    }
+
+    auto seconds = static_cast<double>(options.duration.count());
+
+    spdlog::info("{} connections, depth {}, {}s, rate {}, mix {}",
+                 options.connections, options.depth, options.duration.count(),
+                 options.rate > 0 ? fmt::format("{} req/s", options.rate)
+                                  : std::string("closed loop"),
+                 options.mix);
+    spdlog::info("requests {} ({:.1f} req/s)", total.corrected.size(),
+                 static_cast<double>(total.corrected.size()) / seconds);
+    spdlog::info("errors exception={} io={} unmatched={} timeout={}",
+                 total.exceptions, total.io_errors, total.unmatched,
+                 total.timeouts);
+
+    if (options.rate > 0) {
+      report("corrected", total.corrected);
+      report("uncorrected", total.uncorrected);
+    } else {
+      // closed loop sends on completion, there is no schedule to omit
+      report("closed loop", total.uncorrected);
+    }
+  } catch (const std::exception& exc) {
+    spdlog::error("Exception {}", exc.what());
+    return 1;
+  }
+
+  return 0;
+}
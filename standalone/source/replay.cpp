@@ -0,0 +1,315 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <map>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <spdlog/spdlog.h>
+
+#include <boost/asio.hpp>
+
+#include <modbuscpp/modbus.hpp>
+
+namespace {
+using clock_type = std::chrono::steady_clock;
+using record_t = modbus::traffic_capture::record_t;
+
+class replay_logger : public modbus::logger {
+public:
+  explicit replay_logger(bool debug = false) : modbus::logger(debug) {}
+
+  virtual ~replay_logger() override {}
+
+protected:
+  inline virtual void error_impl(
+      const std::string& message) const noexcept override {
+    spdlog::error("{}", message);
+  }
+
+  inline virtual void debug_impl(
+      const std::string& message) const noexcept override {
+    if (debug_) {
+      spdlog::debug("{}", message);
+    }
+  }
+
+  inline virtual void info_impl(
+      const std::string& message) const noexcept override {
+    spdlog::info("{}", message);
+  }
+};
+
+/**
+ * Replay result of one session
+ */
+struct result_t {
+  /**
+   * Latency from scheduled send time (ns), corrected for coordinated
+   * omission
+   */
+  std::vector<std::uint64_t> corrected;
+  /**
+   * Latency from actual send time (ns)
+   */
+  std::vector<std::uint64_t> uncorrected;
+  /**
+   * Failed requests
+   */
+  std::uint64_t errors = 0;
+};
+
+/**
+ * Convert duration to nanoseconds
+ *
+ * @param duration duration
+ *
+ * @return nanoseconds
+ */
+inline std::uint64_t nanoseconds(clock_type::duration duration) {
+  return static_cast<std::uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count());
+}
+
+/**
+ * Read one Modbus TCP ADU
+ *
+ * @param socket socket
+ * @param buffer buffer
+ */
+void read_adu(boost::asio::ip::tcp::socket& socket, modbus::packet_t& buffer) {
+  buffer.resize(modbus::internal::adu::header_length - 1);
+  boost::asio::read(socket, boost::asio::buffer(buffer.data(), buffer.size()));
+
+  // MBAP length counts the unit id and the PDU
+  std::size_t length = (static_cast<std::uint8_t>(buffer[4]) << 8)
+                       | static_cast<std::uint8_t>(buffer[5]);
+  buffer.resize(buffer.size() + length);
+  boost::asio::read(socket,
+                    boost::asio::buffer(buffer.data() + buffer.size() - length,
+                                        length));
+}
+
+/**
+ * Replay requests over one connection
+ *
+ * With speed > 0 every request has a scheduled send time. A slow response
+ * delays the following sends, so latency is also measured from the
+ * schedule, otherwise the delay would be omitted from the percentiles.
+ *
+ * @param requests requests in capture order
+ * @param origin   timestamp of first captured request (ns)
+ * @param start    replay start
+ * @param speed    time compression, 0 to send back to back
+ * @param port     server port
+ * @param result   replay result
+ */
+void replay(const std::vector<const record_t*>& requests,
+            std::uint64_t                       origin,
+            clock_type::time_point              start,
+            double                              speed,
+            unsigned short                      port,
+            result_t&                           result) {
+  result.corrected.reserve(requests.size());
+  result.uncorrected.reserve(requests.size());
+
+  boost::asio::io_context      io;
+  boost::asio::ip::tcp::socket socket(io);
+  modbus::packet_t             response;
+
+  try {
+    socket.connect({boost::asio::ip::address_v4::loopback(), port});
+    socket.set_option(boost::asio::ip::tcp::no_delay(true));
+  } catch (const std::exception& exc) {
+    spdlog::error("cannot connect: {}", exc.what());
+    result.errors += requests.size();
+    return;
+  }
+
+  for (std::size_t idx = 0; idx < requests.size(); ++idx) {
+    const auto*            request = requests[idx];
+    clock_type::time_point scheduled;
+
+    if (speed > 0) {
+      scheduled = start
+                  + std::chrono::nanoseconds(static_cast<std::uint64_t>(
+                      static_cast<double>(request->timestamp - origin)
+                      / speed));
+      std::this_thread::sleep_until(scheduled);
+    }
+
+    try {
+      auto begin = clock_type::now();
+      boost::asio::write(socket, boost::asio::buffer(request->adu.data(),
+                                                    request->adu.size()));
+      read_adu(socket, response);
+
+      auto end = clock_type::now();
+      result.uncorrected.push_back(nanoseconds(end - begin));
+
+      if (speed > 0) {
+        result.corrected.push_back(nanoseconds(end - scheduled));
+      }
+    } catch (const std::exception& exc) {
+      spdlog::error("session failed: {}", exc.what());
+      result.errors += requests.size() - idx;
+      return;
+    }
+  }
+}
+
+/**
+ * Get percentile of sorted samples
+ *
+ * @param sorted     sorted samples
+ * @param percentile percentile [0, 100]
+ *
+ * @return sample in microseconds
+ */
+double percentile(const std::vector<std::uint64_t>& sorted,
+                  double                            percentile) {
+  if (sorted.empty()) {
+    return 0;
+  }
+
+  auto rank = static_cast<std::size_t>(
+      percentile / 100.0 * static_cast<double>(sorted.size() - 1) + 0.5);
+  return static_cast<double>(sorted[std::min(rank, sorted.size() - 1)])
+         / 1000.0;
+}
+
+/**
+ * Report latency percentiles
+ *
+ * @param name      latency name
+ * @param latencies latencies (ns), sorted in place
+ */
+void report(const char* name, std::vector<std::uint64_t>& latencies) {
+  std::sort(latencies.begin(), latencies.end());
+  spdlog::info("{} latency us p50={:.1f} p90={:.1f} p99={:.1f} p99.9={:.1f} "
+               "max={:.1f}",
+               name, percentile(latencies, 50), percentile(latencies, 90),
+               percentile(latencies, 99), percentile(latencies, 99.9),
+               percentile(latencies, 100));
+}
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  spdlog::set_level(spdlog::level::info);
+
+  if (argc < 2 || argc > 5) {
+    spdlog::error("Usage: replay <capture file> [speed] [sessions] [port]");
+    spdlog::error("  speed    1 replays at captured timing, 10 is 10x faster,");
+    spdlog::error("           0 sends back to back (default 1)");
+    spdlog::error("  sessions connections, 0 keeps captured sessions");
+    spdlog::error("           (default 0)");
+    spdlog::error("  port     loopback port of replay server (default 1503)");
+    return 1;
+  }
+
+  double      speed = argc > 2 ? std::atof(argv[2]) : 1.0;
+  std::size_t sessions = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 0;
+  std::string port = argc > 4 ? argv[4] : "1503";
+
+  try {
+    modbus::logger::create<replay_logger>(false);
+
+    // group requests by captured session, keep capture order
+    auto records = modbus::traffic_capture::read(argv[1]);
+    std::map<std::uint64_t, std::vector<const record_t*>> streams;
+
+    for (const auto& record : records) {
+      if (record.dir == modbus::traffic_capture::direction::request
+          && record.adu.size() > modbus::internal::adu::header_length) {
+        streams[record.session].push_back(&record);
+      }
+    }
+
+    if (streams.empty()) {
+      spdlog::error("no requests in {}", argv[1]);
+      return 1;
+    }
+
+    if (sessions == 0) {
+      sessions = streams.size();
+    }
+
+    std::vector<std::vector<const record_t*>> plans(sessions);
+    std::size_t                               next = 0;
+
+    for (auto& [session, requests] : streams) {
+      auto& plan = plans[next++ % sessions];
+      plan.insert(plan.end(), requests.begin(), requests.end());
+    }
+
+    std::uint64_t origin = UINT64_MAX;
+
+    for (auto& plan : plans) {
+      std::stable_sort(plan.begin(), plan.end(),
+                       [](const auto* lhs, const auto* rhs) {
+                         return lhs->timestamp < rhs->timestamp;
+                       });
+
+      if (!plan.empty()) {
+        origin = std::min(origin, plan.front()->timestamp);
+      }
+    }
+
+    // replay target, a fresh table per run keeps runs comparable
+    auto&& server = modbus::server::create(modbus::table::create());
+    server->run("127.0.0.1", port);
+
+    auto port_number = static_cast<unsigned short>(std::stoul(port));
+    std::vector<result_t>    results(sessions);
+    std::vector<std::thread> threads;
+    auto                     start = clock_type::now();
+
+    for (std::size_t idx = 0; idx < sessions; ++idx) {
+      threads.emplace_back(replay, std::cref(plans[idx]), origin, start, speed,
+                           port_number, std::ref(results[idx]));
+    }
+
+    for (auto& thread : threads) {
+      thread.join();
+    }
+
+    auto elapsed = std::chrono::duration<double>(clock_type::now() - start);
+    server->stop();
+
+    result_t total;
+
+    for (auto& result : results) {
+      total.corrected.insert(total.corrected.end(), result.corrected.begin(),
+                             result.corrected.end());
+      total.uncorrected.insert(total.uncorrected.end(),
+                               result.uncorrected.begin(),
+                               result.uncorrected.end());
+      total.errors += result.errors;
+    }
+
+    auto replayed = total.uncorrected.size();
+
+    spdlog::info("replayed {} requests from {} captured sessions over {} "
+                 "sessions in {:.3f}s",
+                 replayed, streams.size(), sessions, elapsed.count());
+    spdlog::info("errors {}", total.errors);
+    spdlog::info("throughput {:.1f} req/s",
+                 static_cast<double>(replayed) / elapsed.count());
+
+    if (speed > 0) {
+      report("corrected", total.corrected);
+      report("uncorrected", total.uncorrected);
+    } else {
+      // back to back sends on completion, there is no schedule to omit
+      report("back to back", total.uncorrected);
+    }
+  } catch (const std::exception& exc) {
+    spdlog::error("Exception {}", exc.what());
+    return 1;
+  }
+
+  return 0;
+}
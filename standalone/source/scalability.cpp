@@ -0,0 +1,610 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <spdlog/spdlog.h>
+
+#include <boost/asio.hpp>
+
+#include <modbuscpp/modbus.hpp>
+
+// Connection scalability of modbus::server. The server runs in a forked
+// child so its resident memory can be sampled on its own while the parent
+// holds the client sockets:
+//
+//  1. open <sessions> idle connections, a bounded number of connects at a
+//     time, and wait until the server has registered all of them
+//  2. send one request on every idle session so lazily allocated session
+//     buffers are committed, then leave them idle
+//  3. poll with <active> extra sessions at <rate> req/s each for <seconds>
+//
+// Resident memory is sampled after each phase; per-session cost is the
+// growth over the empty server divided by the number of sessions.
+
+namespace {
+using clock_type = std::chrono::steady_clock;
+
+/**
+ * Connects in flight at a time, keeps the listen backlog from overflowing
+ */
+constexpr std::size_t max_pending_connects = 256;
+
+/**
+ * Scalability options
+ */
+struct options_t {
+  /**
+   * Number of idle sessions
+   */
+  std::size_t sessions = 10000;
+  /**
+   * Number of active sessions
+   */
+  std::size_t active = 100;
+  /**
+   * Requests per second of each active session
+   */
+  double rate = 10;
+  /**
+   * Active phase duration
+   */
+  std::chrono::seconds duration{10};
+  /**
+   * Server io threads
+   */
+  std::size_t threads = 1;
+  /**
+   * Server port
+   */
+  std::string port = "1503";
+};
+
+/**
+ * Server child process
+ */
+class server_process {
+public:
+  /**
+   * Fork server child process
+   *
+   * @param options options
+   */
+  explicit server_process(const options_t& options) {
+    int commands[2];
+    int replies[2];
+
+    if (::pipe(commands) != 0 || ::pipe(replies) != 0) {
+      throw std::runtime_error("cannot create pipes");
+    }
+
+    pid_ = ::fork();
+
+    if (pid_ < 0) {
+      throw std::runtime_error("cannot fork server process");
+    }
+
+    if (pid_ == 0) {
+      ::close(commands[1]);
+      ::close(replies[0]);
+      int status = 1;
+
+      try {
+        status = serve(options, commands[0], replies[1]);
+      } catch (const std::exception& e) {
+        spdlog::error("server process: {}", e.what());
+      }
+
+      ::_exit(status);
+    }
+
+    ::close(commands[0]);
+    ::close(replies[1]);
+    commands_ = commands[1];
+    replies_ = replies[0];
+
+    char ready;
+
+    if (::read(replies_, &ready, 1) != 1) {
+      throw std::runtime_error("server process failed to start");
+    }
+  }
+
+  /**
+   * Stop server child process
+   */
+  ~server_process() {
+    ::close(commands_);
+    ::close(replies_);
+    ::waitpid(pid_, nullptr, 0);
+  }
+
+  /**
+   * Get number of sessions registered by the server
+   *
+   * @return number of sessions
+   */
+  std::uint64_t sessions() const {
+    std::uint64_t count = 0;
+
+    if (::write(commands_, "s", 1) != 1
+        || ::read(replies_, &count, sizeof(count)) != sizeof(count)) {
+      throw std::runtime_error("server process exited");
+    }
+
+    return count;
+  }
+
+  /**
+   * Get resident memory of the server
+   *
+   * @return resident bytes
+   */
+  std::uint64_t resident() const {
+    std::ifstream statm("/proc/" + std::to_string(pid_) + "/statm");
+    std::uint64_t size = 0;
+    std::uint64_t pages = 0;
+    statm >> size >> pages;
+    return pages * static_cast<std::uint64_t>(::sysconf(_SC_PAGESIZE));
+  }
+
+private:
+  /**
+   * Run server and answer session count queries until the parent closes
+   * the command pipe
+   *
+   * @param options  options
+   * @param commands command pipe
+   * @param replies  reply pipe
+   *
+   * @return exit status
+   */
+  static int serve(const options_t& options, int commands, int replies) {
+    spdlog::set_level(spdlog::level::warn);
+
+    auto server
+        = modbus::server::create(modbus::table::create(), options.threads);
+    server->run("127.0.0.1", options.port);
+
+    if (::write(replies, "r", 1) != 1) {
+      return 1;
+    }
+
+    char command;
+
+    while (::read(commands, &command, 1) == 1) {
+      std::uint64_t count = server->sessions().size();
+
+      if (::write(replies, &count, sizeof(count)) != sizeof(count)) {
+        break;
+      }
+    }
+
+    server->stop();
+    return 0;
+  }
+
+private:
+  pid_t pid_;
+  int   commands_;
+  int   replies_;
+};
+
+/**
+ * Client session
+ */
+class session : public std::enable_shared_from_this<session> {
+public:
+  session(boost::asio::io_context&                io,
+          const boost::asio::ip::tcp::endpoint&   endpoint,
+          const modbus::packet_t&                 request)
+      : socket_{io}, timer_{io}, endpoint_{endpoint}, request_{request} {}
+
+  /**
+   * Connect
+   *
+   * @param done called with success
+   */
+  void connect(std::function<void(bool)> done) {
+    socket_.async_connect(
+        endpoint_, [self = shared_from_this(), done = std::move(done)](
+                       const boost::system::error_code& ec) {
+          if (!ec) {
+            self->socket_.set_option(boost::asio::ip::tcp::no_delay(true));
+          }
+
+          done(!ec);
+        });
+  }
+
+  /**
+   * Send one request and read its response
+   *
+   * @param done called with success
+   */
+  void request(std::function<void(bool)> done) {
+    boost::asio::async_write(
+        socket_, boost::asio::buffer(request_.data(), request_.size()),
+        [self = shared_from_this(), done = std::move(done)](
+            const boost::system::error_code& ec, std::size_t) mutable {
+          if (ec) {
+            done(false);
+            return;
+          }
+
+          self->receive(std::move(done));
+        });
+  }
+
+  /**
+   * Poll at a fixed interval until deadline, latency is measured from the
+   * scheduled send time
+   *
+   * @param interval interval between requests
+   * @param deadline end of polling
+   */
+  void poll(clock_type::duration interval, clock_type::time_point deadline) {
+    interval_ = interval;
+    deadline_ = deadline;
+    next_due_ = clock_type::now();
+    schedule();
+  }
+
+  /**
+   * Get latencies
+   *
+   * @return latencies (ns)
+   */
+  inline std::vector<std::uint64_t>& latencies() { return latencies_; }
+
+  /**
+   * Get io errors
+   *
+   * @return io errors
+   */
+  inline std::uint64_t errors() const { return errors_; }
+
+private:
+  /**
+   * Read response
+   *
+   * @param done called with success
+   */
+  void receive(std::function<void(bool)> done) {
+    boost::asio::async_read(
+        socket_,
+        boost::asio::buffer(header_, modbus::internal::adu::header_length - 1),
+        [self = shared_from_this(), done = std::move(done)](
+            const boost::system::error_code& ec, std::size_t) mutable {
+          if (ec) {
+            done(false);
+            return;
+          }
+
+          // MBAP length counts the unit id and the PDU
+          std::size_t length
+              = (static_cast<std::uint8_t>(self->header_[4]) << 8)
+                | static_cast<std::uint8_t>(self->header_[5]);
+          if (length > self->body_.max_size()) {
+            done(false);
+            return;
+          }
+
+          self->body_.resize(length);
+          boost::asio::async_read(
+              self->socket_,
+              boost::asio::buffer(self->body_.data(), self->body_.size()),
+              [done = std::move(done)](const boost::system::error_code& ec,
+                                       std::size_t) { done(!ec); });
+        });
+  }
+
+  /**
+   * Wait for next scheduled request
+   */
+  void schedule() {
+    if (next_due_ >= deadline_) {
+      return;
+    }
+
+    timer_.expires_at(next_due_);
+    timer_.async_wait(
+        [self = shared_from_this()](const boost::system::error_code& ec) {
+          if (ec) {
+            return;
+          }
+
+          auto intended = self->next_due_;
+          self->next_due_ += self->interval_;
+          self->request([self, intended](bool success) {
+            if (!success) {
+              self->errors_++;
+              return;
+            }
+
+            self->latencies_.push_back(static_cast<std::uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    clock_type::now() - intended)
+                    .count()));
+            self->schedule();
+          });
+        });
+  }
+
+private:
+  boost::asio::ip::tcp::socket   socket_;
+  boost::asio::steady_timer      timer_;
+  boost::asio::ip::tcp::endpoint endpoint_;
+  const modbus::packet_t&        request_;
+  char header_[modbus::internal::adu::header_length - 1];
+  modbus::packet_t               body_;
+  clock_type::duration           interval_{};
+  clock_type::time_point         next_due_;
+  clock_type::time_point         deadline_;
+  std::vector<std::uint64_t>     latencies_;
+  std::uint64_t                  errors_ = 0;
+};
+
+/**
+ * Connect sessions with a bounded number of connects in flight
+ *
+ * @param io       io context
+ * @param sessions sessions
+ *
+ * @return number of failed connects
+ */
+std::size_t connect_all(boost::asio::io_context&                    io,
+                        const std::vector<std::shared_ptr<session>>& sessions) {
+  std::size_t next = 0;
+  std::size_t failed = 0;
+
+  std::function<void()> connect_next = [&] {
+    if (next == sessions.size()) {
+      return;
+    }
+
+    sessions[next++]->connect([&](bool success) {
+      failed += success ? 0 : 1;
+      connect_next();
+    });
+  };
+
+  for (std::size_t idx = 0; idx < max_pending_connects; ++idx) {
+    connect_next();
+  }
+
+  io.run();
+  io.restart();
+  return failed;
+}
+
+/**
+ * Send one request on every session, one at a time per session
+ *
+ * @param io       io context
+ * @param sessions sessions
+ *
+ * @return number of failed requests
+ */
+std::size_t request_all(boost::asio::io_context&                    io,
+                        const std::vector<std::shared_ptr<session>>& sessions) {
+  std::size_t failed = 0;
+
+  for (const auto& session : sessions) {
+    session->request([&](bool success) { failed += success ? 0 : 1; });
+  }
+
+  io.run();
+  io.restart();
+  return failed;
+}
+
+/**
+ * Raise open file limit to the hard limit
+ *
+ * @param needed file descriptors needed
+ */
+void raise_file_limit(std::size_t needed) {
+  rlimit limit{};
+
+  if (::getrlimit(RLIMIT_NOFILE, &limit) != 0) {
+    return;
+  }
+
+  limit.rlim_cur = limit.rlim_max;
+  ::setrlimit(RLIMIT_NOFILE, &limit);
+
+  if (limit.rlim_cur != RLIM_INFINITY && limit.rlim_cur < needed) {
+    spdlog::warn("open file limit {} is below the {} sessions need, raise "
+                 "it with ulimit -n",
+                 limit.rlim_cur, needed);
+  }
+}
+
+/**
+ * Format bytes as KiB
+ *
+ * @param bytes bytes
+ *
+ * @return KiB
+ */
+double kib(double bytes) {
+  return bytes / 1024.0;
+}
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  spdlog::set_level(spdlog::level::info);
+
+  if (argc > 7) {
+    spdlog::error("Usage: scalability [sessions] [active] [rate] [seconds] "
+                  "[threads] [port=1503]");
+    spdlog::error("  sessions  idle sessions (default 10000)");
+    spdlog::error("  active    polling sessions (default 100)");
+    spdlog::error("  rate      req/s of each polling session (default 10)");
+    spdlog::error("  seconds   polling duration (default 10)");
+    spdlog::error("  threads   server io threads (default 1)");
+    return 1;
+  }
+
+  options_t options;
+
+  try {
+    if (argc > 1) {
+      options.sessions = std::stoul(argv[1]);
+    }
+
+    if (argc > 2) {
+      options.active = std::stoul(argv[2]);
+    }
+
+    if (argc > 3) {
+      options.rate = std::max(std::stod(argv[3]), 0.1);
+    }
+
+    if (argc > 4) {
+      options.duration = std::chrono::seconds(std::stoul(argv[4]));
+    }
+
+    if (argc > 5) {
+      options.threads = std::max<std::size_t>(1, std::stoul(argv[5]));
+    }
+
+    if (argc > 6) {
+      options.port = argv[6];
+    }
+
+    // each session is a socket on both ends, the child inherits the limit
+    raise_file_limit(options.sessions + options.active + 64);
+
+    server_process server(options);
+
+    modbus::request::read_holding_registers read_request(
+        modbus::address_t{0x00}, modbus::read_num_regs_t{10});
+    read_request.initialize({0x0001, 0x01});
+    auto request = read_request.encode();
+
+    boost::asio::io_context        io;
+    boost::asio::ip::tcp::endpoint endpoint{
+        boost::asio::ip::address_v4::loopback(),
+        static_cast<unsigned short>(std::stoul(options.port))};
+
+    std::vector<std::shared_ptr<session>> idle;
+    std::vector<std::shared_ptr<session>> active;
+
+    for (std::size_t idx = 0; idx < options.sessions; ++idx) {
+      idle.push_back(std::make_shared<session>(io, endpoint, request));
+    }
+
+    for (std::size_t idx = 0; idx < options.active; ++idx) {
+      active.push_back(std::make_shared<session>(io, endpoint, request));
+    }
+
+    auto empty = server.resident();
+
+    // phase 1: accept
+    auto start = clock_type::now();
+    auto connect_failed = connect_all(io, idle);
+    auto expected = options.sessions - connect_failed;
+
+    // connect completes once the kernel queues the connection, wait for
+    // the server to register it
+    while (server.sessions() < expected
+           && clock_type::now() - start < std::chrono::seconds(60)) {
+      ::usleep(1000);
+    }
+
+    std::chrono::duration<double> accept_time = clock_type::now() - start;
+    auto                          accepted = server.sessions();
+    auto                          connected = server.resident();
+
+    // phase 2: touch every idle session once
+    auto request_failed = request_all(io, idle);
+    auto touched = server.resident();
+
+    // phase 3: active polling over the idle sessions
+    auto active_failed = connect_all(io, active);
+    auto deadline = clock_type::now() + options.duration;
+    auto interval = std::chrono::duration_cast<clock_type::duration>(
+        std::chrono::duration<double>(1.0 / options.rate));
+
+    for (const auto& session : active) {
+      session->poll(interval, deadline);
+    }
+
+    io.run();
+
+    auto polled = server.resident();
+
+    std::vector<std::uint64_t> latencies;
+    std::uint64_t              poll_errors = 0;
+
+    for (const auto& session : active) {
+      latencies.insert(latencies.end(), session->latencies().begin(),
+                       session->latencies().end());
+      poll_errors += session->errors();
+    }
+
+    std::sort(latencies.begin(), latencies.end());
+
+    auto at = [&](double percentile) {
+      if (latencies.empty()) {
+        return 0.0;
+      }
+
+      auto rank = static_cast<std::size_t>(
+          percentile / 100.0 * static_cast<double>(latencies.size() - 1)
+          + 0.5);
+      return static_cast<double>(latencies[rank]) / 1000.0;
+    };
+
+    auto per_session = [&](std::uint64_t resident, std::size_t count) {
+      return count == 0 ? 0.0
+                        : kib((static_cast<double>(resident)
+                               - static_cast<double>(empty))
+                              / static_cast<double>(count));
+    };
+
+    spdlog::info("{} idle sessions, {} active at {} req/s for {}s, {} server "
+                 "threads",
+                 options.sessions, options.active, options.rate,
+                 options.duration.count(), options.threads);
+    spdlog::info("accepted {} in {:.3f}s ({:.1f} sessions/s), connect "
+                 "errors {}",
+                 accepted, accept_time.count(),
+                 static_cast<double>(accepted) / accept_time.count(),
+                 connect_failed + active_failed);
+    spdlog::info("server rss KiB empty={:.0f} connected={:.0f} touched={:.0f} "
+                 "polled={:.0f}",
+                 kib(static_cast<double>(empty)),
+                 kib(static_cast<double>(connected)),
+                 kib(static_cast<double>(touched)),
+                 kib(static_cast<double>(polled)));
+    spdlog::info("rss per session KiB connected={:.2f} touched={:.2f}",
+                 per_session(connected, accepted),
+                 per_session(touched, accepted));
+    spdlog::info("active requests {} ({:.1f} req/s), errors {}",
+                 latencies.size(),
+                 static_cast<double>(latencies.size())
+                     / static_cast<double>(
+                         std::max<std::int64_t>(1, options.duration.count())),
+                 request_failed + poll_errors);
+    spdlog::info("active latency us p50={:.1f} p99={:.1f} p99.9={:.1f} "
+                 "max={:.1f}",
+                 at(50), at(99), at(99.9), at(100));
+  } catch (const std::exception& e) {
+    spdlog::error("{}", e.what());
+    return 1;
+  }
+
+  return 0;
+}
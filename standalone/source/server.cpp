@@ -1,8 +1,15 @@
+#include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <cstdint>
 #include <iomanip>
 #include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
 #include <thread>
 #include <utility>
+#include <vector>
 
 #include <arpa/inet.h>
 #include <netinet/in.h>
@@ -38,33 +45,175 @@ protected:
   }
 };
 
-int main([[maybe_unused]] int argc, [[maybe_unused]] const char** argv) {
-  spdlog::set_level(spdlog::level::debug);
-  modbus::logger::create<server_logger>(true);
-
-  auto&& data_table = modbus::table::create(
-      /*modbus::table::initializer_t{*/
-      // modbus::block::bits::initializer_t{modbus::address_t{0x00}, 0xFFFF,
-      // true}, modbus::block::bits::initializer_t{modbus::address_t{0x00},
-      // 0xFFFF, true},
-      // modbus::block::registers::initializer_t{modbus::address_t{0x00},
-      // 0xFFFF, 15},
-      /*modbus::block::registers::initializer_t{}}*/
-  );
-  auto&& server = modbus::server::create(std::move(data_table));
-
-  server->bind_connect(
-      []([[maybe_unused]] auto& session_ptr, [[maybe_unused]] auto& table) {
-        // session_ptr->start_timer(1, std::chrono::seconds(1), [&table]() {
-        /*LOG_INFO("Input registers addr 0x00: {:#04x}",*/
-        /*table.input_registers().get(modbus::address_t{0x00}));*/
-        //});
-      });
-
-  server->run();
+namespace {
+/**
+ * Server options
+ */
+struct options_t {
+  /**
+   * First device port
+   */
+  std::uint16_t port = 1502;
+  /**
+   * Number of simulated devices, one server per port
+   */
+  std::size_t devices = 1;
+  /**
+   * Simulator generators, empty to run without simulator
+   */
+  std::vector<modbus::simulator::generator_t> generators;
+  /**
+   * Simulator threads per device
+   */
+  std::size_t simulator_threads = 1;
+};
+
+/**
+ * Print usage
+ */
+void usage() {
+  spdlog::error("Usage: server [--port <port>] [--devices <n>] "
+                "[--simulate <generator>]... [--simulator-threads <n>]");
+  spdlog::error("  --port               first device port (default 1502)");
+  spdlog::error("  --devices            devices on consecutive ports "
+                "(default 1)");
+  spdlog::error("  --simulate           <kind>:<block>:<address>:<count>"
+                "[:<min>:<max>[:<period>[:<rate>]]]");
+  spdlog::error("                       kind ramp|sine|noise|counter|step, "
+                "block ir|di, rate in ticks/s (0 unthrottled)");
+  spdlog::error("  --simulator-threads  update threads per device "
+                "(default 1)");
+}
+
+/**
+ * Parse options
+ *
+ * @param argc argument count
+ * @param argv arguments
+ *
+ * @return options
+ */
+options_t parse(int argc, const char** argv) {
+  options_t options;
+
+  for (int idx = 1; idx < argc; ++idx) {
+    std::string arg = argv[idx];
+
+    if (idx + 1 == argc) {
+      throw std::invalid_argument("missing value of " + arg);
+    }
+
+    std::string value = argv[++idx];
+
+    if (arg == "--port") {
+      options.port = static_cast<std::uint16_t>(std::stoul(value));
+    } else if (arg == "--devices") {
+      options.devices = std::max<std::size_t>(1, std::stoul(value));
+    } else if (arg == "--simulate") {
+      options.generators.push_back(modbus::simulator::parse(value));
+    } else if (arg == "--simulator-threads") {
+      options.simulator_threads = std::max<std::size_t>(1, std::stoul(value));
+    } else {
+      throw std::invalid_argument("unknown option " + arg);
+    }
+  }
+
+  return options;
+}
+}  // namespace
+
+int main(int argc, const char** argv) {
+  options_t options;
+
+  try {
+    options = parse(argc, argv);
+  } catch (const std::exception& e) {
+    spdlog::error("{}", e.what());
+    usage();
+    return 1;
+  }
+
+  bool simulating = !options.generators.empty();
+
+  // per-request debug logs would dominate a simulated polling load
+  spdlog::set_level(simulating ? spdlog::level::info : spdlog::level::debug);
+  modbus::logger::create<server_logger>(!simulating);
+
+  std::vector<std::unique_ptr<modbus::server>>    servers;
+  std::vector<std::unique_ptr<modbus::simulator>> simulators;
+
+  for (std::size_t idx = 0; idx < options.devices; ++idx) {
+    auto&& data_table = modbus::table::create(
+        /*modbus::table::initializer_t{*/
+        // modbus::block::bits::initializer_t{modbus::address_t{0x00},
+        // 0xFFFF, true},
+        // modbus::block::bits::initializer_t{modbus::address_t{0x00},
+        // 0xFFFF, true},
+        // modbus::block::registers::initializer_t{modbus::address_t{0x00},
+        // 0xFFFF, 15},
+        /*modbus::block::registers::initializer_t{}}*/
+    );
+    data_table->instrument_locks(true);
+
+    auto&& server = modbus::server::create(std::move(data_table));
+
+    server->bind_connect(
+        []([[maybe_unused]] auto& session_ptr, [[maybe_unused]] auto& table) {
+          // session_ptr->start_timer(1, std::chrono::seconds(1), [&table]() {
+          /*LOG_INFO("Input registers addr 0x00: {:#04x}",*/
+          /*table.input_registers().get(modbus::address_t{0x00}));*/
+          //});
+        });
+
+    if (simulating) {
+      try {
+        simulators.push_back(modbus::simulator::create(
+            server->data_table(), options.generators,
+            options.simulator_threads));
+      } catch (const std::exception& e) {
+        spdlog::error("{}", e.what());
+        return 1;
+      }
+    }
+
+    server->run("0.0.0.0", std::to_string(options.port + idx));
+    servers.push_back(std::move(server));
+  }
+
+  auto&& metrics = modbus::metrics_server::create(*servers.front());
+  metrics->run("127.0.0.1", "9502");
+
+  for (auto& simulator : simulators) {
+    simulator->run();
+  }
+
+  std::atomic<bool> running{simulating};
+  std::thread       reporter([&] {
+    std::uint64_t previous = 0;
+
+    while (running) {
+      std::this_thread::sleep_for(std::chrono::seconds(1));
+      std::uint64_t updates = 0;
+
+      for (const auto& simulator : simulators) {
+        updates += simulator->updates();
+      }
+
+      spdlog::info("simulator {} devices, {} updates/s", simulators.size(),
+                   updates - previous);
+      previous = updates;
+    }
+  });
 
   while (std::getchar() != '\n') {
   }
 
+  running = false;
+  reporter.join();
+
+  for (auto& simulator : simulators) {
+    simulator->stop();
+  }
+
   return 0;
 }
@@ -0,0 +1,65 @@
+#include <doctest/doctest.h>
+
+#include <modbuscpp/modbus.hpp>
+
+TEST_CASE("modbuscpp access heatmap") {
+  SUBCASE("bucket ranges") {
+    modbus::access_heatmap heatmap(modbus::address_t{0x100}, 200);
+    heatmap.enable(true);
+
+    heatmap.read(modbus::address_t{0x100}, 10);
+    heatmap.read(modbus::address_t{0x100 + 60}, 10);
+    heatmap.write(modbus::address_t{0x100 + 190}, 50);
+    heatmap.read(modbus::address_t{0x00}, 10);
+
+    auto ranges = heatmap.ranges();
+    REQUIRE(ranges.size() == 4);
+    CHECK(ranges[0].first == 0x100);
+    CHECK(ranges[0].last == 0x100 + 63);
+    CHECK(ranges[0].reads == 2);
+    CHECK(ranges[1].first == 0x100 + 64);
+    CHECK(ranges[1].reads == 1);
+    CHECK(ranges[2].first == 0x100 + 128);
+    CHECK(ranges[2].writes == 1);
+    CHECK(ranges[3].first == 0x100 + 192);
+    CHECK(ranges[3].last == 0x100 + 199);
+    CHECK(ranges[3].writes == 1);
+
+    auto hottest = heatmap.hottest(1);
+    REQUIRE(hottest.size() == 1);
+    CHECK(hottest[0].first == 0x100);
+
+    heatmap.reset();
+    CHECK(heatmap.ranges().empty());
+  }
+
+  SUBCASE("recorded by request handlers") {
+    auto data_table = modbus::table::create();
+
+    modbus::request::read_holding_registers req(modbus::address_t{0x80},
+                                                modbus::read_num_regs_t{4});
+    req.initialize({0x0001, 0x01});
+
+    modbus::request_handler::handle(data_table.get(), req.encode());
+    CHECK(data_table->holding_registers().heatmap().ranges().empty());
+
+    data_table->enable_heatmap(true);
+
+    for (int i = 0; i < 3; ++i) {
+      modbus::request_handler::handle(data_table.get(), req.encode());
+    }
+
+    modbus::request::write_single_register write(modbus::address_t{0x10},
+                                                 modbus::reg_value_t{0x1234});
+    write.initialize({0x0002, 0x01});
+    modbus::request_handler::handle(data_table.get(), write.encode());
+
+    auto hottest = data_table->holding_registers().heatmap().hottest();
+    REQUIRE(hottest.size() == 2);
+    CHECK(hottest[0].first == 0x80);
+    CHECK(hottest[0].reads == 3);
+    CHECK(hottest[1].first == 0x00);
+    CHECK(hottest[1].writes == 1);
+    CHECK(data_table->input_registers().heatmap().ranges().empty());
+  }
+}
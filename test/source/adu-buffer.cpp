@@ -0,0 +1,58 @@
+#include <doctest/doctest.h>
+
+#include <stdexcept>
+#include <vector>
+
+#include <modbuscpp/modbus.hpp>
+
+TEST_CASE("modbuscpp adu buffer") {
+  using modbus::adu_buffer;
+
+  SUBCASE("vector-like interface") {
+    adu_buffer packet{0x01, 0x02, 0x03};
+    CHECK(packet.size() == 3);
+    CHECK(packet.front() == 0x01);
+    CHECK(packet.back() == 0x03);
+
+    packet.insert(packet.begin(), 2, 0x00);
+    CHECK(packet == adu_buffer{0x00, 0x00, 0x01, 0x02, 0x03});
+
+    std::vector<char> tail{0x04, 0x05};
+    packet.insert(packet.end(), tail.begin(), tail.end());
+    CHECK(packet.size() == 7);
+    CHECK(packet[6] == 0x05);
+
+    packet.erase(packet.begin(), packet.begin() + 2);
+    CHECK(packet == adu_buffer{0x01, 0x02, 0x03, 0x04, 0x05});
+
+    packet.resize(7);
+    CHECK(packet[5] == 0x00);
+    CHECK(packet.view().size() == 7);
+
+    adu_buffer copy = packet;
+    CHECK(copy == packet);
+    copy.pop_back();
+    CHECK(copy != packet);
+
+    CHECK_THROWS_AS(packet.at(7), std::out_of_range);
+
+    packet.clear();
+    CHECK(packet.empty());
+  }
+
+  SUBCASE("capacity") {
+    adu_buffer packet(adu_buffer::max_capacity);
+    CHECK(packet.size() == modbus::constants::max_adu_length);
+    CHECK_THROWS_AS(packet.push_back(0x00), std::length_error);
+    CHECK_THROWS_AS(packet.insert(packet.begin(), 0x00), std::length_error);
+    CHECK_THROWS_AS(packet.resize(adu_buffer::max_capacity + 1),
+                    std::length_error);
+    CHECK(packet.size() == adu_buffer::max_capacity);
+  }
+
+  SUBCASE("pack into") {
+    adu_buffer packet;
+    modbus::utilities::pack_into(packet, "HB", 0x1234, 0x56);
+    CHECK(packet == adu_buffer{0x12, 0x34, 0x56});
+  }
+}
@@ -0,0 +1,43 @@
+#include <doctest/doctest.h>
+
+#include <string>
+#include <string_view>
+
+#include <modbuscpp/modbus.hpp>
+
+TEST_CASE("modbuscpp adu framing") {
+  using modbus::internal::adu;
+
+  modbus::request::read_holding_registers req(modbus::address_t{0x00},
+                                              modbus::read_num_regs_t{2});
+  req.initialize({0x0001, 0x01});
+  auto        encoded = req.encode();
+  std::string one(encoded.data(), encoded.size());
+
+  SUBCASE("single request") {
+    CHECK(adu::frame_size(one) == one.size());
+  }
+
+  SUBCASE("requests coalesced into one read") {
+    std::string stream = one + one;
+    CHECK(adu::frame_size(stream) == one.size());
+    CHECK(adu::frame_size(std::string_view(stream).substr(one.size()))
+          == one.size());
+  }
+
+  SUBCASE("request cut at the end of a read") {
+    for (std::size_t size = 0; size < one.size(); ++size) {
+      CHECK(adu::frame_size(std::string_view(one).substr(0, size)) == 0);
+    }
+  }
+
+  SUBCASE("invalid length consumes the stream") {
+    std::string stream = one + one;
+    stream[4] = 0x00;
+    stream[5] = 0x00;
+    CHECK(adu::frame_size(stream) == stream.size());
+
+    stream[4] = 0x10;
+    CHECK(adu::frame_size(stream) == stream.size());
+  }
+}
@@ -0,0 +1,159 @@
+#include <doctest/doctest.h>
+
+#include <cstdlib>
+#include <new>
+
+#include <modbuscpp/modbus.hpp>
+
+// Counts heap allocations made by the calling thread while enabled. Replaces
+// the global allocation functions for the whole test binary; when disabled
+// the only cost is a thread-local check.
+
+namespace {
+thread_local bool        counting = false;
+thread_local std::size_t allocations = 0;
+
+/**
+ * Count allocations of the calling thread while alive
+ */
+class allocation_scope {
+public:
+  allocation_scope() {
+    allocations = 0;
+    counting = true;
+  }
+
+  ~allocation_scope() { counting = false; }
+
+  /**
+   * Get number of allocations
+   *
+   * @return allocations since construction
+   */
+  std::size_t count() const { return allocations; }
+};
+
+/**
+ * Get allocations of one handled request in steady state
+ *
+ * @param request request
+ *
+ * @return allocations
+ */
+template <typename request_t>
+std::size_t handle_allocations(request_t&& request) {
+  auto data_table = modbus::table::create();
+  request.initialize({0x0001, 0x01});
+  auto packet = request.encode();
+
+  // first call registers per-thread stats and logger state
+  modbus::request_handler::handle(data_table.get(), packet);
+
+  allocation_scope scope;
+  [[maybe_unused]] auto response
+      = modbus::request_handler::handle(data_table.get(), packet);
+  return scope.count();
+}
+}  // namespace
+
+void* operator new(std::size_t size) {
+  if (counting) {
+    ++allocations;
+  }
+
+  if (void* ptr = std::malloc(size == 0 ? 1 : size)) {
+    return ptr;
+  }
+
+  throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+  std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+  std::free(ptr);
+}
+
+TEST_CASE("modbuscpp request handler allocation budget") {
+  using modbus::address_t;
+
+  // budgets are the current cost, lower them when a change saves
+  // allocations so regressions fail here
+  SUBCASE("read coils") {
+    CHECK(handle_allocations(modbus::request::read_coils(
+              address_t{0x00}, modbus::read_num_bits_t{1}))
+          <= 0);
+    CHECK(handle_allocations(modbus::request::read_coils(
+              address_t{0x00}, modbus::read_num_bits_t{0x7D0}))
+          <= 0);
+  }
+
+  SUBCASE("read discrete inputs") {
+    CHECK(handle_allocations(modbus::request::read_discrete_inputs(
+              address_t{0x00}, modbus::read_num_bits_t{16}))
+          <= 0);
+  }
+
+  SUBCASE("read holding registers") {
+    CHECK(handle_allocations(modbus::request::read_holding_registers(
+              address_t{0x00}, modbus::read_num_regs_t{1}))
+          <= 0);
+    CHECK(handle_allocations(modbus::request::read_holding_registers(
+              address_t{0x00}, modbus::read_num_regs_t{0x7D}))
+          <= 0);
+  }
+
+  SUBCASE("read input registers") {
+    CHECK(handle_allocations(modbus::request::read_input_registers(
+              address_t{0x00}, modbus::read_num_regs_t{10}))
+          <= 0);
+  }
+
+  SUBCASE("write single coil") {
+    CHECK(handle_allocations(modbus::request::write_single_coil(
+              address_t{0x00}, modbus::value::bits::on))
+          <= 0);
+  }
+
+  SUBCASE("write single register") {
+    CHECK(handle_allocations(modbus::request::write_single_register(
+              address_t{0x00}, modbus::reg_value_t{0x1234}))
+          <= 0);
+  }
+
+  SUBCASE("write multiple coils") {
+    CHECK(handle_allocations(modbus::request::write_multiple_coils(
+              address_t{0x00}, modbus::write_num_bits_t{0x7B0},
+              modbus::block::bits::container_type(0x7B0, true)))
+          <= 0);
+  }
+
+  SUBCASE("write multiple registers") {
+    CHECK(handle_allocations(modbus::request::write_multiple_registers(
+              address_t{0x00}, modbus::write_num_regs_t{0x7B},
+              modbus::block::registers::container_type(0x7B, 0x1234)))
+          <= 0);
+  }
+
+  SUBCASE("mask write register") {
+    CHECK(handle_allocations(modbus::request::mask_write_register(
+              address_t{0x00}, modbus::mask_t{0xF2}, modbus::mask_t{0x25}))
+          <= 0);
+  }
+
+  SUBCASE("read write multiple registers") {
+    CHECK(handle_allocations(modbus::request::read_write_multiple_registers(
+              address_t{0x00}, modbus::read_num_regs_t{10}, address_t{0x00},
+              modbus::write_num_regs_t{4}, {1, 2, 3, 4}))
+          <= 0);
+  }
+
+  // logger formats the exception message
+  SUBCASE("exception response") {
+    CHECK(handle_allocations(modbus::request::read_holding_registers(
+              address_t{0xFFF0}, modbus::read_num_regs_t{0x7D}))
+          <= 1);
+  }
+}
@@ -0,0 +1,184 @@
+#include <doctest/doctest.h>
+
+#include <chrono>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <modbuscpp/modbus.hpp>
+
+namespace {
+class capture_logger : public modbus::async_logger {
+public:
+  explicit capture_logger(const initializer_t& initializer)
+      : modbus::async_logger(initializer) {}
+
+  virtual ~capture_logger() override { stop(); }
+
+  std::vector<std::string> lines() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return lines_;
+  }
+
+protected:
+  virtual void write(level, const std::string& message) const
+      noexcept override {
+    std::lock_guard<std::mutex> lock(mutex_);
+    lines_.push_back(message);
+  }
+
+private:
+  mutable std::mutex               mutex_;
+  mutable std::vector<std::string> lines_;
+};
+}  // namespace
+
+TEST_CASE("modbuscpp async logger") {
+  using namespace std::chrono_literals;
+
+  auto* previous = modbus::logger::get();
+
+  modbus::async_logger::initializer_t initializer;
+  initializer.interval = 1h;
+  initializer.max_rate = 0;
+
+  SUBCASE("messages are formatted on the background thread") {
+    capture_logger logger(initializer);
+    modbus::logger::set(&logger);
+
+    std::string name = "read holding registers";
+    modbus::logger::info(FMT_STRING("Get {} request {:#06x} {}"), name, 0x1234,
+                         "ok");
+    modbus::logger::error(std::string("plain message"));
+    modbus::logger::debug("not logged {}", 1);
+
+    logger.flush();
+    modbus::logger::set(previous);
+
+    auto lines = logger.lines();
+    REQUIRE(lines.size() == 2);
+    CHECK(lines[0] == "Get read holding registers request 0x1234 ok");
+    CHECK(lines[1] == "plain message");
+    CHECK(logger.dropped() == 0);
+    CHECK(logger.written() == 2);
+  }
+
+  SUBCASE("runtime format is formatted on the calling thread") {
+    capture_logger logger(initializer);
+    modbus::logger::set(&logger);
+
+    char format[] = "runtime {}";
+    modbus::logger::info(format, 1);
+    std::strcpy(format, "changed");
+
+    logger.flush();
+    modbus::logger::set(previous);
+
+    auto lines = logger.lines();
+    REQUIRE(lines.size() == 1);
+    CHECK(lines[0] == "runtime 1");
+  }
+
+  SUBCASE("long strings are kept whole or marked as cut") {
+    capture_logger logger(initializer);
+    modbus::logger::set(&logger);
+
+    std::string fits(150, 'a');
+    std::string too_long(400, 'b');
+    modbus::logger::info(FMT_STRING("{}|{}"), fits, 1);
+    modbus::logger::info(FMT_STRING("{}|{}"), too_long, 2);
+
+    logger.flush();
+    modbus::logger::set(previous);
+
+    constexpr auto cut = modbus::internal::log_record::cut_marker;
+
+    auto lines = logger.lines();
+    REQUIRE(lines.size() == 2);
+    CHECK(lines[0] == fits + "|1");
+    REQUIRE(lines[1].size() > cut.size());
+    CHECK(lines[1].size() < too_long.size());
+    CHECK(lines[1].compare(0, lines[1].size() - cut.size(), too_long, 0,
+                           lines[1].size() - cut.size())
+          == 0);
+    CHECK(std::string_view(lines[1]).substr(lines[1].size() - cut.size())
+          == cut);
+  }
+
+  SUBCASE("full ring drops messages") {
+    initializer.ring_size = 4;
+    capture_logger logger(initializer);
+    modbus::logger::set(&logger);
+
+    for (int i = 0; i < 10; ++i) {
+      modbus::logger::info("message {}", i);
+    }
+
+    logger.flush();
+    modbus::logger::set(previous);
+
+    CHECK(logger.written() == 4);
+    CHECK(logger.dropped() == 6);
+    CHECK(logger.lines().back() == "6 log messages dropped (total 6)");
+  }
+
+  SUBCASE("thread keeps one ring per logger") {
+    initializer.ring_size = 4;
+    capture_logger first(initializer);
+    capture_logger second(initializer);
+
+    for (int i = 0; i < 8; ++i) {
+      modbus::logger::set(&first);
+      modbus::logger::info(FMT_STRING("first {}"), i);
+      modbus::logger::set(&second);
+      modbus::logger::info(FMT_STRING("second {}"), i);
+    }
+
+    first.flush();
+    second.flush();
+    modbus::logger::set(previous);
+
+    CHECK(first.written() == 4);
+    CHECK(first.dropped() == 4);
+    CHECK(second.written() == 4);
+    CHECK(second.dropped() == 4);
+  }
+
+  SUBCASE("records of exited threads are written") {
+    capture_logger logger(initializer);
+    modbus::logger::set(&logger);
+
+    for (int i = 0; i < 4; ++i) {
+      std::thread([i] {
+        modbus::logger::info(FMT_STRING("thread {}"), i);
+      }).join();
+    }
+
+    logger.flush();
+    logger.flush();
+    modbus::logger::set(previous);
+
+    CHECK(logger.written() == 4);
+    CHECK(logger.dropped() == 0);
+  }
+
+  SUBCASE("rate limit drops messages") {
+    initializer.max_rate = 1;
+    initializer.burst = 3;
+    capture_logger logger(initializer);
+    modbus::logger::set(&logger);
+
+    for (int i = 0; i < 10; ++i) {
+      modbus::logger::info("message {}", i);
+    }
+
+    logger.flush();
+    modbus::logger::set(previous);
+
+    CHECK(logger.written() == 3);
+    CHECK(logger.dropped() == 7);
+  }
+}
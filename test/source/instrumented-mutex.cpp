@@ -0,0 +1,68 @@
+#include <doctest/doctest.h>
+
+#include <chrono>
+#include <thread>
+
+#include <modbuscpp/modbus.hpp>
+
+TEST_CASE("modbuscpp instrumented mutex") {
+  SUBCASE("disabled by default") {
+    auto data_table = modbus::table::create();
+    data_table->holding_registers().set(modbus::address_t{0x00}, 1);
+    data_table->holding_registers().get(modbus::address_t{0x00});
+
+    auto stats = data_table->lock_stats();
+    CHECK(stats.holding_registers.read.acquisitions == 0);
+    CHECK(stats.holding_registers.write.acquisitions == 0);
+  }
+
+  SUBCASE("count readers and writers per block") {
+    auto data_table = modbus::table::create();
+    data_table->instrument_locks(true);
+
+    data_table->holding_registers().set(modbus::address_t{0x00}, 1);
+    data_table->holding_registers().get(modbus::address_t{0x00});
+    data_table->holding_registers().get(modbus::address_t{0x00},
+                                        modbus::read_num_regs_t{2});
+    data_table->coils().set(modbus::address_t{0x00}, true);
+
+    auto stats = data_table->lock_stats();
+    CHECK(stats.holding_registers.read.acquisitions == 2);
+    CHECK(stats.holding_registers.write.acquisitions == 1);
+    CHECK(stats.coils.write.acquisitions == 1);
+    CHECK(stats.coils.read.acquisitions == 0);
+    CHECK(stats.input_registers.write.acquisitions == 0);
+
+    data_table->reset_lock_stats();
+    CHECK(data_table->lock_stats().holding_registers.read.acquisitions == 0);
+  }
+
+  SUBCASE("record contended wait and hold time") {
+    using namespace std::chrono_literals;
+
+    modbus::instrumented_mutex mutex;
+    mutex.instrument(true);
+
+    std::thread holder;
+
+    {
+      modbus::instrumented_lock<modbus::access::write> lock(mutex);
+      holder = std::thread([&mutex]() {
+        modbus::instrumented_lock<modbus::access::read> lock(mutex);
+      });
+      std::this_thread::sleep_for(20ms);
+    }
+
+    holder.join();
+
+    auto stats = mutex.stats();
+    CHECK(stats.write.acquisitions == 1);
+    CHECK(stats.write.contended == 0);
+    CHECK(stats.write.hold_time >= 20'000'000);
+    CHECK(stats.write.max_hold_time == stats.write.hold_time);
+    CHECK(stats.read.acquisitions == 1);
+    CHECK(stats.read.contended == 1);
+    CHECK(stats.read.wait_time > 0);
+    CHECK(stats.read.max_wait_time == stats.read.wait_time);
+  }
+}
@@ -0,0 +1,75 @@
+#include <doctest/doctest.h>
+
+#include <thread>
+
+#include <modbuscpp/modbus.hpp>
+
+TEST_CASE("modbuscpp memory pool") {
+  using modbus::memory_pool;
+
+  auto pool = memory_pool::get();
+  memory_pool::release();
+
+  SUBCASE("recycles blocks per size class") {
+    void* first = pool->allocate(40);
+    pool->deallocate(first, 40);
+    CHECK(memory_pool::cached() == 1);
+
+    // 33..64 bytes share a size class
+    void* second = pool->allocate(64);
+    CHECK(second == first);
+    CHECK(memory_pool::cached() == 0);
+
+    void* other = pool->allocate(16);
+    CHECK(other != first);
+
+    pool->deallocate(second, 64);
+    pool->deallocate(other, 16);
+    CHECK(memory_pool::cached() == 2);
+
+    memory_pool::release();
+    CHECK(memory_pool::cached() == 0);
+  }
+
+  SUBCASE("large blocks bypass the free lists") {
+    void* block = pool->allocate(memory_pool::max_block_size + 1);
+    pool->deallocate(block, memory_pool::max_block_size + 1);
+    CHECK(memory_pool::cached() == 0);
+  }
+
+  SUBCASE("caps cached blocks") {
+    void* blocks[memory_pool::max_cached + 1];
+
+    for (auto& block : blocks) {
+      block = pool->allocate(128);
+    }
+
+    for (auto& block : blocks) {
+      pool->deallocate(block, 128);
+    }
+
+    CHECK(memory_pool::cached() == memory_pool::max_cached);
+    memory_pool::release();
+  }
+
+  SUBCASE("blocks freed on another thread") {
+    modbus::block::registers::buffer_type buffer(0x7D, 0x1234, pool);
+
+    std::thread([&] {
+      auto moved = std::move(buffer);
+      CHECK(moved.size() == 0x7D);
+      CHECK(moved.get_allocator().resource() == pool);
+      CHECK(memory_pool::cached() == 0);
+      moved = modbus::block::registers::buffer_type(pool);
+      CHECK(memory_pool::cached() == 1);
+    }).join();
+
+    CHECK(memory_pool::cached() == 0);
+  }
+
+  SUBCASE("request buffers") {
+    modbus::request::write_multiple_registers request(
+        modbus::address_t{0x00}, modbus::write_num_regs_t{2}, {1, 2});
+    CHECK(request.values().get_allocator().resource() == pool);
+  }
+}
@@ -0,0 +1,74 @@
+#include <doctest/doctest.h>
+
+#include <string>
+
+#include <modbuscpp/modbus.hpp>
+
+TEST_CASE("modbuscpp metrics server") {
+  auto modbus_server = modbus::server::create(modbus::table::create());
+  modbus::metrics_server metrics(*modbus_server);
+
+  SUBCASE("render counters and histograms") {
+    modbus::stats::recorder recorder;
+    recorder.request(0x03, 1'500);
+    recorder.request(0x03, 40'000);
+    recorder.request(0x63, 500);
+    recorder.exception(modbus::constants::exception_code::illegal_data_address);
+    recorder.bytes_in(24);
+    recorder.bytes_out(48);
+
+    modbus::stats::snapshot_t snapshot;
+    recorder.snapshot(snapshot);
+
+    modbus::table::lock_stats_t locks;
+    locks.holding_registers.write.acquisitions = 5;
+    locks.holding_registers.write.wait_time = 2'500'000;
+
+    auto text = modbus::metrics_server::render(snapshot, 2, locks);
+
+    CHECK(text.find("# TYPE modbus_requests_total counter\n")
+          != std::string::npos);
+    CHECK(text.find(
+              "modbus_requests_total{function=\"read_holding_registers\"} 2\n")
+          != std::string::npos);
+    CHECK(text.find("modbus_requests_total{function=\"0x63\"} 1\n")
+          != std::string::npos);
+    CHECK(text.find("modbus_request_duration_seconds_bucket{function=\"read_"
+                    "holding_registers\",le=\"1e-06\"} 0\n")
+          != std::string::npos);
+    CHECK(text.find("modbus_request_duration_seconds_bucket{function=\"read_"
+                    "holding_registers\",le=\"2.5e-06\"} 1\n")
+          != std::string::npos);
+    CHECK(text.find("modbus_request_duration_seconds_bucket{function=\"read_"
+                    "holding_registers\",le=\"+Inf\"} 2\n")
+          != std::string::npos);
+    CHECK(text.find("modbus_request_duration_seconds_count{function=\"read_"
+                    "holding_registers\"} 2\n")
+          != std::string::npos);
+    CHECK(text.find("modbus_exceptions_total{code=\"illegal_data_address\"} 1\n")
+          != std::string::npos);
+    CHECK(text.find("modbus_active_sessions 2\n") != std::string::npos);
+    CHECK(text.find("modbus_received_bytes_total 24\n") != std::string::npos);
+    CHECK(text.find("modbus_sent_bytes_total 48\n") != std::string::npos);
+    CHECK(text.find("modbus_table_lock_acquisitions_total{block=\"holding_"
+                    "registers\",access=\"write\"} 5\n")
+          != std::string::npos);
+    CHECK(text.find("modbus_table_lock_wait_seconds_total{block=\"holding_"
+                    "registers\",access=\"write\"} 0.0025\n")
+          != std::string::npos);
+  }
+
+  SUBCASE("respond to http requests") {
+    auto ok = metrics.respond("GET /metrics HTTP/1.1\r\nHost: x\r\n\r\n");
+    CHECK(ok.rfind("HTTP/1.1 200 OK\r\n", 0) == 0);
+    CHECK(ok.find("modbus_active_sessions 0\n") != std::string::npos);
+
+    CHECK(metrics.respond("GET /other HTTP/1.1\r\n\r\n")
+              .rfind("HTTP/1.1 404 Not Found\r\n", 0)
+          == 0);
+    CHECK(metrics.respond("POST /metrics HTTP/1.1\r\n\r\n")
+              .rfind("HTTP/1.1 405 Method Not Allowed\r\n", 0)
+          == 0);
+    CHECK(metrics.respond("GET /metr").empty());
+  }
+}
@@ -0,0 +1,72 @@
+#include <doctest/doctest.h>
+
+#include <cstdint>
+#include <random>
+
+#include <modbuscpp/modbus.hpp>
+
+TEST_CASE("modbuscpp bit packing matches scalar reference") {
+  using modbus::packet_t;
+  using bits_t = modbus::block::bits::buffer_type;
+
+  std::mt19937 random(0x5eed);
+
+  SUBCASE("pack") {
+    bits_t random_bits(512);
+
+    for (std::size_t idx = 0; idx < random_bits.size(); ++idx) {
+      random_bits[idx] = random() & 1;
+    }
+
+    // all ones catches bits past the end leaking into the last byte
+    for (const auto& source : {random_bits, bits_t(512, true)}) {
+      for (std::size_t offset = 0; offset < 130; ++offset) {
+        for (std::size_t count = 0; count <= 300; ++count) {
+          auto begin = source.begin() + offset;
+          auto end = begin + count;
+
+          packet_t expected{0x01, 0x02};
+          modbus::op::scalar::pack_bits(expected, begin, end);
+          packet_t packet{0x01, 0x02};
+          modbus::op::pack_bits(packet, begin, end);
+          REQUIRE(packet == expected);
+        }
+      }
+    }
+  }
+
+  SUBCASE("unpack") {
+    packet_t source(modbus::constants::max_adu_length);
+
+    for (auto& byte : source) {
+      byte = static_cast<char>(random());
+    }
+
+    for (std::size_t offset = 0; offset < 9; ++offset) {
+      for (std::size_t bytes = 0; offset + bytes <= source.size(); ++bytes) {
+        auto begin = source.begin() + offset;
+        REQUIRE(modbus::op::unpack_bits(begin, begin + bytes)
+                == modbus::op::scalar::unpack_bits(begin, begin + bytes));
+      }
+    }
+  }
+
+  SUBCASE("round trip at max quantities") {
+    for (std::uint16_t count : {modbus::constants::max_num_bits_read,
+                                modbus::constants::max_num_bits_write}) {
+      bits_t bits(count);
+
+      for (std::size_t idx = 0; idx < bits.size(); ++idx) {
+        bits[idx] = random() & 1;
+      }
+
+      auto packet = modbus::op::pack_bits(bits.begin(), bits.end());
+      CHECK(packet.size() == (count + 7u) / 8);
+
+      auto unpacked = modbus::op::unpack_bits(packet.begin(), packet.end());
+      CHECK(unpacked.size() == packet.size() * 8);
+      unpacked.resize(count);
+      CHECK(unpacked == bits);
+    }
+  }
+}
@@ -0,0 +1,83 @@
+#include <doctest/doctest.h>
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+
+#include <modbuscpp/modbus.hpp>
+
+TEST_CASE("modbuscpp prepared request") {
+  auto data_table = modbus::table::create();
+
+  SUBCASE("read holding registers") {
+    data_table->holding_registers().set(modbus::address_t{0x20},
+                                        {0x1111, 0x2222});
+
+    modbus::request::read_holding_registers req(modbus::address_t{0x20},
+                                                modbus::read_num_regs_t{2});
+    req.initialize({0x0000, 0x01});
+    modbus::prepared_request prepared(req);
+
+    for (std::uint16_t transaction : {0x0001, 0xBEEF}) {
+      auto sent = prepared.stamp(transaction);
+
+      // same bytes as a freshly encoded request
+      req.transaction(transaction);
+      auto encoded = req.encode();
+      CHECK(sent == std::string_view(encoded.data(), encoded.size()));
+
+      auto packet = req.execute(data_table.get())->encode();
+      std::array<std::uint16_t, 2> registers{};
+      CHECK(prepared.decode_into({packet.data(), packet.size()}, transaction,
+                                 registers.data(), registers.size())
+            == 2);
+      CHECK(registers[0] == 0x1111);
+      CHECK(registers[1] == 0x2222);
+
+      CHECK_THROWS_AS(prepared.check({packet.data(), packet.size()},
+                                     transaction + 1),
+                      modbus::ex::bad_data);
+    }
+  }
+
+  SUBCASE("write single register echo") {
+    modbus::request::write_single_register req(modbus::address_t{0x05},
+                                               modbus::reg_value_t{0x0A0B});
+    req.initialize({0x0010, 0x02});
+    modbus::prepared_request prepared(req);
+
+    auto packet = req.execute(data_table.get())->encode();
+    CHECK(prepared.check({packet.data(), packet.size()}, 0x0010).empty());
+
+    packet.back() = 0x00;
+    CHECK_THROWS_AS(prepared.check({packet.data(), packet.size()}, 0x0010),
+                    modbus::ex::bad_data);
+  }
+
+  SUBCASE("exception response") {
+    modbus::request::read_holding_registers req(modbus::address_t{0x00},
+                                                modbus::read_num_regs_t{1});
+    req.initialize({0x0000, 0x01});
+    modbus::prepared_request prepared(req);
+
+    const char packet[] = {0x00, 0x07, 0x00, 0x00, 0x00, 0x03,
+                           0x01, char(0x83), 0x02};
+    CHECK_THROWS_AS(prepared.check({packet, sizeof(packet)}, 0x0007),
+                    modbus::ex::illegal_data_address);
+  }
+
+  SUBCASE("decode into rejects non register functions") {
+    modbus::request::read_coils req(modbus::address_t{0x00},
+                                    modbus::read_num_bits_t{16});
+    req.initialize({0x0003, 0x01});
+    modbus::prepared_request prepared(req);
+
+    // two bytes of coils would otherwise pass for one register
+    auto packet = req.execute(data_table.get())->encode();
+    std::array<std::uint16_t, 1> registers{};
+    CHECK_THROWS_AS(prepared.decode_into({packet.data(), packet.size()},
+                                         0x0003, registers.data(),
+                                         registers.size()),
+                    modbus::ex::bad_data);
+  }
+}
@@ -0,0 +1,113 @@
+#include <doctest/doctest.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <modbuscpp/modbus.hpp>
+
+TEST_CASE("modbuscpp read cache") {
+  using namespace std::chrono_literals;
+  using key_t = modbus::register_cache::key_t;
+
+  modbus::register_cache cache{50ms};
+  key_t key{0x01, modbus::constants::function_code::read_holding_registers, 10,
+            2};
+  std::atomic<int> fetches{0};
+
+  auto fetch = [&fetches]() {
+    fetches++;
+    return modbus::block::registers::container_type{0x1234, 0x5678};
+  };
+
+  SUBCASE("fresh value is served from cache") {
+    auto first = cache.get(key, fetch);
+    auto second = cache.get(key, fetch);
+
+    CHECK(fetches == 1);
+    CHECK(first == second);
+    CHECK((*second)[1] == 0x5678);
+    CHECK(cache.stats().hits == 1);
+    CHECK(cache.stats().misses == 1);
+  }
+
+  SUBCASE("stale value is fetched again") {
+    cache.get(key, fetch);
+    cache.get(key, fetch, 0ms);
+    CHECK(fetches == 2);
+
+    cache.invalidate(key);
+    cache.get(key, fetch);
+    CHECK(fetches == 3);
+
+    key_t other = key;
+    other.count = 3;
+    cache.get(other, fetch);
+    CHECK(fetches == 4);
+  }
+
+  SUBCASE("concurrent reads share one fetch") {
+    std::atomic<bool> release{false};
+    auto              slow_fetch = [&]() {
+      fetches++;
+      while (!release) {
+        std::this_thread::yield();
+      }
+      return modbus::block::registers::container_type{0x0001};
+    };
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 8; ++i) {
+      threads.emplace_back([&]() { cache.get(key, slow_fetch); });
+    }
+
+    while (cache.stats().misses + cache.stats().coalesced < 8) {
+      std::this_thread::yield();
+    }
+    release = true;
+
+    for (auto& thread : threads) {
+      thread.join();
+    }
+
+    CHECK(fetches == 1);
+    CHECK(cache.stats().coalesced == 7);
+  }
+
+  SUBCASE("failed fetch is not cached") {
+    CHECK_THROWS_AS(cache.get(key,
+                              []() -> modbus::block::registers::container_type {
+                                throw std::runtime_error("timeout");
+                              }),
+                    std::runtime_error);
+    CHECK(cache.size() == 0);
+    cache.get(key, fetch);
+    CHECK(fetches == 1);
+  }
+
+  SUBCASE("entries are bounded") {
+    modbus::register_cache small{50ms, 2};
+
+    for (std::uint16_t address = 0; address < 16; ++address) {
+      key_t other = key;
+      other.address = address;
+      small.get(other, fetch);
+      CHECK(small.size() <= 2);
+    }
+
+    // least recently fetched keys went first
+    key_t last = key;
+    last.address = 15;
+    small.get(last, fetch);
+    CHECK(fetches == 16);
+    CHECK(small.stats().hits == 1);
+
+    key_t first = key;
+    first.address = 0;
+    small.get(first, fetch);
+    CHECK(fetches == 17);
+  }
+}
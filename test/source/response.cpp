@@ -0,0 +1,57 @@
+#include <doctest/doctest.h>
+
+#include <array>
+#include <cstdint>
+
+#include <modbuscpp/modbus.hpp>
+
+TEST_CASE("modbuscpp response decode into caller buffer") {
+  auto data_table = modbus::table::create();
+
+  SUBCASE("read holding registers") {
+    data_table->holding_registers().set(modbus::address_t{0x10},
+                                        {0x0102, 0xA0B0, 0xFFFF});
+
+    modbus::request::read_holding_registers req(modbus::address_t{0x10},
+                                                modbus::read_num_regs_t{3});
+    req.initialize({0x1234, 0x01});
+    auto packet = req.execute(data_table.get())->encode();
+
+    modbus::response::read_holding_registers response(&req);
+    std::array<std::uint16_t, 3> registers{};
+    CHECK(response.decode_into(packet, registers.data(), registers.size())
+          == 3);
+    CHECK(registers[0] == 0x0102);
+    CHECK(registers[1] == 0xA0B0);
+    CHECK(registers[2] == 0xFFFF);
+
+    CHECK_THROWS_AS(response.decode_into(packet, registers.data(), 2),
+                    modbus::ex::bad_data_size);
+
+    packet[0] = 0x00;
+    CHECK_THROWS_AS(
+        response.decode_into(packet, registers.data(), registers.size()),
+        modbus::ex::bad_data);
+  }
+
+  SUBCASE("read coils") {
+    data_table->coils().set(modbus::address_t{0x00},
+                            {true, false, true, true, false, false, false,
+                             false, true, true});
+
+    modbus::request::read_coils req(modbus::address_t{0x00},
+                                    modbus::read_num_bits_t{10});
+    req.initialize({0x0001, 0x01});
+    auto packet = req.execute(data_table.get())->encode();
+
+    modbus::response::read_coils response(&req);
+    std::array<std::uint8_t, 2> bits{};
+    CHECK(response.decode_into(packet, bits.data(), bits.size()) == 2);
+    CHECK(bits[0] == 0x0D);
+    CHECK(bits[1] == 0x03);
+
+    response.decode(packet);
+    CHECK(response.bits().size() == 10);
+    CHECK(response.bits()[8]);
+  }
+}
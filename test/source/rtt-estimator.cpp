@@ -0,0 +1,62 @@
+#include <doctest/doctest.h>
+
+#include <chrono>
+
+#include <modbuscpp/modbus.hpp>
+
+TEST_CASE("modbuscpp rtt estimator") {
+  using namespace std::chrono_literals;
+  using duration = modbus::rtt_estimator::duration;
+
+  modbus::rtt_estimator estimator;
+
+  SUBCASE("initial timeout") {
+    CHECK_FALSE(estimator.has_sample());
+    CHECK(estimator.timeout() == duration{1s});
+  }
+
+  SUBCASE("first and next samples") {
+    estimator.sample(100ms);
+    CHECK(estimator.srtt() == duration{100ms});
+    CHECK(estimator.rttvar() == duration{50ms});
+    CHECK(estimator.timeout() == duration{300ms});
+
+    estimator.sample(20ms);
+    CHECK(estimator.srtt() == duration{90ms});
+    CHECK(estimator.rttvar() == duration{57500us});
+    CHECK(estimator.timeout() == duration{320ms});
+  }
+
+  SUBCASE("backoff and clamping") {
+    estimator.sample(2ms);
+    CHECK(estimator.timeout() == duration{20ms});
+
+    estimator.expired();
+    estimator.expired();
+    CHECK(estimator.backoff() == 2);
+    CHECK(estimator.timeout() == duration{80ms});
+
+    for (int i = 0; i < 32; ++i) {
+      estimator.expired();
+    }
+    CHECK(estimator.timeout() == duration{10s});
+
+    estimator.sample(2ms);
+    CHECK(estimator.backoff() == 0);
+  }
+
+  SUBCASE("retry spacing") {
+    estimator.sample(100ms);
+    CHECK(estimator.retry_delay(1) == duration{100ms});
+    CHECK(estimator.retry_delay(3) == duration{400ms});
+  }
+
+  SUBCASE("per endpoint") {
+    modbus::rtt_table table;
+    table.sample("10.0.0.1:502", 0x01, duration{2s});
+    table.sample("10.0.0.1:502", 0x02, duration{20ms});
+    CHECK(table.timeout("10.0.0.1:502", 0x01) > duration{2s});
+    CHECK(table.timeout("10.0.0.1:502", 0x02) < duration{100ms});
+    CHECK(table.timeout("10.0.0.2:502", 0x01) == duration{1s});
+  }
+}
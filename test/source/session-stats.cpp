@@ -0,0 +1,53 @@
+#include <doctest/doctest.h>
+
+#include <modbuscpp/modbus.hpp>
+
+TEST_CASE("modbuscpp session stats") {
+  modbus::stats::session_registry registry;
+
+  SUBCASE("counters and service time") {
+    auto session = registry.add(0x1000, "10.0.0.1", 40000);
+    REQUIRE(session);
+    CHECK(registry.find(0x1000) == session);
+
+    session->request(12);
+    session->queued(false);
+    session->request(12);
+    session->queued(true);
+
+    auto snapshot = registry.snapshot(0x1000);
+    REQUIRE(snapshot.has_value());
+    CHECK(snapshot->remote_address == "10.0.0.1");
+    CHECK(snapshot->remote_port == 40000);
+    CHECK(snapshot->requests == 2);
+    CHECK(snapshot->bytes_in == 24);
+    CHECK(snapshot->exceptions == 1);
+    CHECK(snapshot->send_queue == 2);
+    CHECK(snapshot->max_send_queue == 2);
+    CHECK(snapshot->mean_service_time() == 0.0);
+
+    session->sent(20, 1'000);
+    session->sent(9, 3'000);
+
+    snapshot = registry.snapshot(0x1000);
+    CHECK(snapshot->bytes_out == 29);
+    CHECK(snapshot->send_queue == 0);
+    CHECK(snapshot->max_send_queue == 2);
+    CHECK(snapshot->served == 2);
+    CHECK(snapshot->mean_service_time() == 2'000.0);
+    CHECK(snapshot->max_service_time == 3'000);
+  }
+
+  SUBCASE("enumerate and remove") {
+    for (std::size_t key = 1; key <= 40; ++key) {
+      registry.add(key << 4, "10.0.0.1", static_cast<std::uint16_t>(key));
+    }
+
+    CHECK(registry.snapshot().size() == 40);
+
+    registry.remove(5 << 4);
+    CHECK(registry.snapshot().size() == 39);
+    CHECK(registry.find(5 << 4) == nullptr);
+    CHECK_FALSE(registry.snapshot(5 << 4).has_value());
+  }
+}
@@ -0,0 +1,142 @@
+#include <doctest/doctest.h>
+
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+
+#include <modbuscpp/modbus.hpp>
+
+TEST_CASE("modbuscpp simulator") {
+  using modbus::simulator;
+
+  SUBCASE("parse") {
+    auto generator = simulator::parse("sine:ir:0x10:64:100:200:500:10000");
+    CHECK(generator.kind == simulator::waveform::sine);
+    CHECK(generator.block == simulator::target::input_registers);
+    CHECK(generator.address == modbus::address_t{0x10});
+    CHECK(generator.count == 64);
+    CHECK(generator.min == 100);
+    CHECK(generator.max == 200);
+    CHECK(generator.period == 500);
+    CHECK(generator.rate == 10000);
+
+    generator = simulator::parse("counter:di:0:32");
+    CHECK(generator.kind == simulator::waveform::counter);
+    CHECK(generator.block == simulator::target::discrete_inputs);
+    CHECK(generator.min == 0);
+    CHECK(generator.max == 0xFFFF);
+
+    CHECK_THROWS_AS(simulator::parse("sine:ir:0"), std::invalid_argument);
+    CHECK_THROWS_AS(simulator::parse("square:ir:0:1"), std::invalid_argument);
+    CHECK_THROWS_AS(simulator::parse("sine:hr:0:1"), std::invalid_argument);
+    CHECK_THROWS_AS(simulator::parse("sine:ir:0:0"), std::invalid_argument);
+    CHECK_THROWS_AS(simulator::parse("sine:ir:0:1:5"), std::invalid_argument);
+    CHECK_THROWS_AS(simulator::parse("sine:ir:0:1:5:4"),
+                    std::invalid_argument);
+    CHECK_THROWS_AS(simulator::parse("sine:ir:0x10000:1"),
+                    std::invalid_argument);
+  }
+
+  SUBCASE("waveforms") {
+    simulator::generator_t generator;
+    generator.min = 10;
+    generator.max = 13;
+    generator.period = 4;
+
+    generator.kind = simulator::waveform::ramp;
+    CHECK(simulator::value(generator, 0, 0) == 10);
+    CHECK(simulator::value(generator, 3, 0) == 13);
+    CHECK(simulator::value(generator, 4, 0) == 10);
+    CHECK(simulator::value(generator, 1, 1) == 12);
+
+    generator.kind = simulator::waveform::step;
+    CHECK(simulator::value(generator, 3, 0) == 10);
+    CHECK(simulator::value(generator, 4, 0) == 13);
+    CHECK(simulator::value(generator, 8, 0) == 10);
+    CHECK_FALSE(simulator::bit(generator, 3, 0));
+    CHECK(simulator::bit(generator, 4, 0));
+
+    generator.kind = simulator::waveform::sine;
+    generator.min = 0;
+    generator.max = 1000;
+    CHECK(simulator::value(generator, 0, 0) == 500);
+    CHECK(simulator::value(generator, 1, 0) == 1000);
+    CHECK(simulator::value(generator, 3, 0) == 0);
+
+    generator.kind = simulator::waveform::noise;
+
+    for (std::uint64_t tick = 0; tick < 1000; ++tick) {
+      CHECK(simulator::value(generator, tick, 0) <= 1000);
+    }
+
+    // deterministic per tick and index
+    CHECK(simulator::value(generator, 7, 3)
+          == simulator::value(generator, 7, 3));
+
+    generator.kind = simulator::waveform::counter;
+    CHECK(simulator::value(generator, 0x12345678, 0) == 0x1234);
+    CHECK(simulator::value(generator, 0x12345678, 1) == 0x5678);
+    CHECK(simulator::value(generator, 0x12345678, 3) == 0x5679);
+    CHECK(simulator::bit(generator, 0b101, 0));
+    CHECK_FALSE(simulator::bit(generator, 0b101, 1));
+    CHECK(simulator::bit(generator, 0b101, 2));
+  }
+
+  SUBCASE("updates table") {
+    auto data_table = modbus::table::create();
+    auto ramp = simulator::parse("ramp:ir:0:16:0:0xFFFF:1000:0");
+    auto step = simulator::parse("step:di:0:16:0:1:1:0");
+    auto sim = simulator::create(*data_table,
+                                 std::vector<simulator::generator_t>{ramp,
+                                                                     step},
+                                 2);
+    sim->run();
+
+    while (sim->updates() < 100000) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    // concurrent reader against the writers
+    auto slice = data_table->input_registers().get(modbus::address_t{0x00},
+                                                   modbus::read_num_regs_t{16});
+    CHECK(slice.second - slice.first == 16);
+
+    sim->stop();
+
+    // ramp writes consecutive values in one set()
+    auto first = data_table->input_registers().get(modbus::address_t{0x00});
+
+    for (std::uint16_t idx = 1; idx < 16; ++idx) {
+      CHECK(data_table->input_registers().get(modbus::address_t{idx})
+            == static_cast<std::uint16_t>(first + idx));
+    }
+
+    auto updates = sim->updates();
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    CHECK(sim->updates() == updates);
+  }
+
+  SUBCASE("rate") {
+    auto data_table = modbus::table::create();
+    auto sim = simulator::create(
+        *data_table,
+        std::vector<simulator::generator_t>{
+            simulator::parse("counter:ir:0:2:0:0xFFFF:1:1000")});
+    sim->run();
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    sim->stop();
+
+    // 100 ticks of 2 registers, loose bounds for loaded machines
+    CHECK(sim->updates() >= 2 * 20);
+    CHECK(sim->updates() <= 2 * 200);
+  }
+
+  SUBCASE("invalid range") {
+    auto data_table = modbus::table::create();
+    CHECK_THROWS_AS(
+        simulator::create(*data_table,
+                          std::vector<simulator::generator_t>{
+                              simulator::parse("ramp:ir:0xFFF0:32")}),
+        modbus::ex::out_of_range);
+  }
+}
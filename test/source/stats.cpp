@@ -0,0 +1,78 @@
+#include <doctest/doctest.h>
+
+#include <thread>
+
+#include <modbuscpp/modbus.hpp>
+
+TEST_CASE("modbuscpp stats histogram") {
+  using modbus::stats::histogram;
+
+  SUBCASE("buckets cover values with bounded error") {
+    for (std::uint64_t value : {0ULL, 1ULL, 15ULL, 16ULL, 17ULL, 1000ULL,
+                                123456789ULL, (1ULL << 35) + 12345}) {
+      auto index = histogram::bucket(value);
+      CHECK(histogram::lower_bound(index) <= value);
+      CHECK(value <= histogram::upper_bound(index));
+      CHECK(histogram::upper_bound(index) - histogram::lower_bound(index)
+            <= value / histogram::sub_buckets);
+    }
+
+    CHECK(histogram::bucket(~0ULL) == histogram::bucket_count - 1);
+  }
+
+  SUBCASE("quantiles") {
+    histogram                  values;
+    modbus::stats::histogram_t snapshot;
+
+    for (std::uint64_t value = 1; value <= 1000; ++value) {
+      values.record(value * 1000);
+    }
+
+    values.snapshot(snapshot);
+    CHECK(snapshot.count == 1000);
+    CHECK(snapshot.max == 1000000);
+    CHECK(snapshot.sum == 500500000);
+    CHECK(snapshot.value_at(0.5) >= 500000);
+    CHECK(snapshot.value_at(0.5) <= 500000 * 1.07);
+    CHECK(snapshot.value_at(1.0) == 1000000);
+  }
+}
+
+TEST_CASE("modbuscpp stats of request handler") {
+  auto                     data_table = modbus::table::create();
+  modbus::stats::collector collector;
+
+  modbus::request::read_holding_registers req(modbus::address_t{0x00},
+                                              modbus::read_num_regs_t{4});
+  req.initialize({0x0001, 0x01});
+  auto packet = req.encode();
+
+  modbus::request::read_holding_registers bad(modbus::address_t{0xFFFE},
+                                              modbus::read_num_regs_t{4});
+  bad.initialize({0x0002, 0x01});
+  auto bad_packet = bad.encode();
+
+  std::thread other([&]() {
+    modbus::request_handler::handle(data_table.get(), packet,
+                                    collector.local());
+  });
+  other.join();
+
+  modbus::request_handler::handle(data_table.get(), packet, collector.local());
+  modbus::request_handler::handle(data_table.get(), bad_packet,
+                                  collector.local());
+
+  auto snapshot = collector.snapshot();
+  auto function = modbus::utilities::to_underlying(
+      modbus::constants::function_code::read_holding_registers);
+
+  CHECK(snapshot.requests == 3);
+  REQUIRE(snapshot.functions.count(function) == 1);
+  CHECK(snapshot.functions[function].requests == 3);
+  CHECK(snapshot.functions[function].latency.count == 3);
+  CHECK(snapshot.exceptions[modbus::constants::exception_code::
+                                illegal_data_address]
+        == 1);
+  CHECK(snapshot.stages[0].count == 3);
+  CHECK(snapshot.stages[2].count == 2);
+}
@@ -0,0 +1,91 @@
+#include <doctest/doctest.h>
+
+#include <set>
+#include <sstream>
+#include <string>
+
+#include <modbuscpp/modbus.hpp>
+
+TEST_CASE("modbuscpp trace") {
+  auto data_table = modbus::table::create();
+
+  SUBCASE("request stages share the request id") {
+    modbus::trace::ring_tracer tracer;
+    modbus::trace::tracer::set(&tracer);
+
+    modbus::request::read_holding_registers req(modbus::address_t{0x00},
+                                                modbus::read_num_regs_t{4});
+    req.initialize({0x0001, 0x01});
+
+    std::uint64_t id = 0;
+
+    {
+      modbus::trace::request_scope request;
+      id = request.id();
+      modbus::request_handler::handle(data_table.get(), req.encode());
+    }
+
+    modbus::trace::tracer::set(nullptr);
+
+    auto spans = tracer.spans();
+    REQUIRE(id != 0);
+
+    std::set<modbus::trace::event> events;
+
+    for (const auto& span : spans) {
+      CHECK(span.request == id);
+      CHECK(span.begin <= span.end);
+      events.insert(span.what);
+    }
+
+    CHECK(events.count(modbus::trace::event::decode) == 1);
+    CHECK(events.count(modbus::trace::event::execute) == 1);
+    CHECK(events.count(modbus::trace::event::lock_wait) == 1);
+    CHECK(events.count(modbus::trace::event::lock_hold) == 1);
+    CHECK(events.count(modbus::trace::event::encode) == 1);
+
+    std::ostringstream os;
+    tracer.dump(os);
+    CHECK(os.str().rfind("{\"traceEvents\":[", 0) == 0);
+    CHECK(os.str().find("\"name\":\"lock wait\"") != std::string::npos);
+  }
+
+  SUBCASE("disabled tracer records nothing") {
+    modbus::trace::ring_tracer tracer;
+
+    {
+      modbus::trace::request_scope request;
+      CHECK(request.id() == 0);
+      modbus::trace::span span(modbus::trace::event::receive);
+    }
+
+    CHECK(tracer.spans().empty());
+  }
+
+  SUBCASE("ring keeps latest spans") {
+    modbus::trace::ring_tracer tracer(4);
+
+    for (std::uint64_t idx = 1; idx <= 10; ++idx) {
+      tracer.record({idx, idx * 10, idx * 10 + 1, 1,
+                     modbus::trace::event::receive});
+    }
+
+    auto spans = tracer.spans();
+    REQUIRE(spans.size() == 4);
+    CHECK(spans.front().request == 7);
+    CHECK(spans.back().request == 10);
+  }
+
+  SUBCASE("filter slow requests") {
+    modbus::trace::ring_tracer tracer;
+    tracer.record({1, 100, 150, 1, modbus::trace::event::receive});
+    tracer.record({1, 150, 160, 1, modbus::trace::event::send});
+    tracer.record({2, 200, 5'000, 1, modbus::trace::event::receive});
+    tracer.record({2, 210, 4'000, 1, modbus::trace::event::lock_wait});
+
+    auto slow = tracer.spans(1'000);
+    REQUIRE(slow.size() == 2);
+    CHECK(slow[0].request == 2);
+    CHECK(slow[1].request == 2);
+  }
+}
@@ -0,0 +1,75 @@
+#include <doctest/doctest.h>
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+
+#include <modbuscpp/modbus.hpp>
+
+TEST_CASE("modbuscpp traffic capture") {
+  auto path = (std::filesystem::temp_directory_path() / "modbuscpp-test.cap")
+                  .string();
+
+  SUBCASE("round trip") {
+    modbus::packet_t request{0x00, 0x01, 0x00, 0x00, 0x00, 0x06,
+                             0x01, 0x03, 0x00, 0x00, 0x00, 0x01};
+    modbus::packet_t response{0x00, 0x01, 0x00, 0x00, 0x00, 0x05,
+                              0x01, 0x03, 0x02, 0x00, 0x2A};
+
+    {
+      modbus::traffic_capture::initializer_t initializer;
+      initializer.path = path;
+      initializer.size = 1024 * 1024;
+      modbus::traffic_capture capture(initializer);
+      capture.write(modbus::traffic_capture::direction::request, 7, request);
+      capture.write(modbus::traffic_capture::direction::response, 7, response);
+      CHECK(capture.written() == 2);
+    }
+
+    auto records = modbus::traffic_capture::read(path);
+    REQUIRE(records.size() == 2);
+    CHECK(records[0].dir == modbus::traffic_capture::direction::request);
+    CHECK(records[0].session == 7);
+    CHECK(records[0].adu == request);
+    CHECK(records[1].dir == modbus::traffic_capture::direction::response);
+    CHECK(records[1].adu == response);
+    CHECK(records[0].timestamp <= records[1].timestamp);
+  }
+
+  SUBCASE("wraparound keeps newest chunks") {
+    modbus::packet_t adu(12, 0x01);
+
+    {
+      modbus::traffic_capture::initializer_t initializer;
+      initializer.path = path;
+      initializer.size = 0;
+      initializer.chunk_size = 0;
+      modbus::traffic_capture capture(initializer);
+
+      for (std::uint64_t idx = 0; idx < 100; ++idx) {
+        capture.write(modbus::traffic_capture::direction::request, idx, adu);
+      }
+    }
+
+    auto records = modbus::traffic_capture::read(path);
+    REQUIRE(!records.empty());
+    CHECK(records.size() < 100);
+    CHECK(records.back().session == 99);
+
+    for (std::size_t idx = 1; idx < records.size(); ++idx) {
+      CHECK(records[idx].session == records[idx - 1].session + 1);
+    }
+  }
+
+  SUBCASE("bad file") {
+    {
+      std::ofstream file(path, std::ios::binary);
+      file << "not a capture file";
+    }
+
+    CHECK_THROWS_AS(modbus::traffic_capture::read(path),
+                    modbus::ex::bad_data);
+  }
+
+  std::remove(path.c_str());
+}
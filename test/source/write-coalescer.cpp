@@ -0,0 +1,91 @@
+#include <doctest/doctest.h>
+
+#include <chrono>
+
+#include <modbuscpp/modbus.hpp>
+
+TEST_CASE("modbuscpp write coalescer") {
+  using namespace std::chrono_literals;
+  using clock = modbus::write_coalescer::clock;
+
+  modbus::write_coalescer coalescer;
+  auto                    now = clock::now();
+
+  SUBCASE("adjacent registers are merged") {
+    for (std::uint16_t i = 0; i < 4; ++i) {
+      coalescer.write_register(0x01, modbus::address_t{std::uint16_t(10 + i)},
+                               modbus::reg_value_t{i}, now);
+    }
+    coalescer.write_register(0x01, modbus::address_t{9},
+                             modbus::reg_value_t{0xFF}, now);
+
+    CHECK(coalescer.poll(now + 1ms).empty());
+
+    auto batches = coalescer.poll(now + 5ms);
+    REQUIRE(batches.size() == 1);
+    CHECK(batches[0].writes == 5);
+    CHECK(batches[0].request->unit() == 0x01);
+
+    auto* request = dynamic_cast<modbus::request::write_multiple_registers*>(
+        batches[0].request.get());
+    REQUIRE(request != nullptr);
+    CHECK(request->address()() == 9);
+    CHECK(request->count()() == 5);
+    CHECK(request->values().front() == 0xFF);
+    CHECK(request->values().back() == 3);
+  }
+
+  SUBCASE("rewrite of pending address keeps order") {
+    coalescer.write_register(0x01, modbus::address_t{1},
+                             modbus::reg_value_t{1}, now);
+    coalescer.write_register(0x01, modbus::address_t{1},
+                             modbus::reg_value_t{2}, now);
+
+    auto batches = coalescer.flush();
+    REQUIRE(batches.size() == 2);
+    auto* first = dynamic_cast<modbus::request::write_single_register*>(
+        batches[0].request.get());
+    auto* second = dynamic_cast<modbus::request::write_single_register*>(
+        batches[1].request.get());
+    REQUIRE(first != nullptr);
+    REQUIRE(second != nullptr);
+    CHECK(first->value()() == 1);
+    CHECK(second->value()() == 2);
+  }
+
+  SUBCASE("coils split at max quantity") {
+    for (std::uint16_t i = 0; i < modbus::constants::max_num_bits_write + 1;
+         ++i) {
+      coalescer.write_coil(0x02, modbus::address_t{i}, i % 2 == 0, now);
+    }
+
+    auto batches = coalescer.poll(now);
+    REQUIRE(batches.size() == 1);
+    auto* request = dynamic_cast<modbus::request::write_multiple_coils*>(
+        batches[0].request.get());
+    REQUIRE(request != nullptr);
+    CHECK(request->count()() == modbus::constants::max_num_bits_write);
+    CHECK(coalescer.pending() == 1);
+
+    // byte count of a batch this large does not fit a byte before dividing
+    auto packet = request->encode();
+    CHECK(static_cast<std::uint8_t>(
+              packet[modbus::internal::adu::header_length + 5])
+          == (modbus::constants::max_num_bits_write + 7) / 8);
+
+    modbus::request::write_multiple_coils decoded;
+    decoded.decode(packet);
+    CHECK(decoded.address()() == 0);
+    CHECK(decoded.count()() == modbus::constants::max_num_bits_write);
+    CHECK(decoded.values() == request->values());
+  }
+
+  SUBCASE("different kinds are not merged") {
+    coalescer.write_register(0x01, modbus::address_t{1},
+                             modbus::reg_value_t{1}, now);
+    coalescer.write_coil(0x01, modbus::address_t{2}, true, now);
+    coalescer.write_register(0x01, modbus::address_t{2},
+                             modbus::reg_value_t{2}, now);
+    CHECK(coalescer.pending() == 3);
+  }
+}